@@ -85,6 +85,9 @@
 
 // Files in the directory returned by GetUserPath(D_LOGS_IDX)
 #define MAIN_LOG "dolphin.log"
+#define PERF_METRICS_CSV "perf_metrics.csv"
+#define PERF_METRICS_JSON "perf_metrics.json"
+#define PERF_METRICS_SOCKET "perf_metrics.sock"
 
 // Files in the directory returned by GetUserPath(D_WIISYSCONF_IDX)
 #define WII_SYSCONF "SYSCONF"
@@ -47,15 +47,24 @@ void Init(const std::string& perf_dir)
 #endif
 
   if (!perf_dir.empty() || getenv("PERF_BUILDID_DIR"))
-  {
-    std::string dir = perf_dir.empty() ? "/tmp" : perf_dir;
-    std::string filename = StringFromFormat("%s/perf-%d.map", dir.data(), getpid());
-    s_perf_map_file.Open(filename, "w");
-    // Disable buffering in order to avoid missing some mappings
-    // if the event of a crash:
-    std::setvbuf(s_perf_map_file.GetHandle(), nullptr, _IONBF, 0);
-    s_is_enabled = true;
-  }
+    OpenPerfMap(perf_dir);
+}
+
+bool OpenPerfMap(const std::string& perf_dir)
+{
+  if (s_perf_map_file.IsOpen())
+    return false;
+
+  std::string dir = perf_dir.empty() ? "/tmp" : perf_dir;
+  std::string filename = StringFromFormat("%s/perf-%d.map", dir.data(), getpid());
+  if (!s_perf_map_file.Open(filename, "w"))
+    return false;
+
+  // Disable buffering in order to avoid missing some mappings
+  // if the event of a crash:
+  std::setvbuf(s_perf_map_file.GetHandle(), nullptr, _IONBF, 0);
+  s_is_enabled = true;
+  return true;
 }
 
 void Shutdown()
@@ -11,6 +11,9 @@ namespace JitRegister
 {
 void Init(const std::string& perf_dir);
 void Shutdown();
+// Opens the perf map of the current process, which perf reads when reporting on JIT code.
+// Returns false if it was already open or couldn't be opened.
+bool OpenPerfMap(const std::string& perf_dir);
 void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args);
 bool IsEnabled();
 
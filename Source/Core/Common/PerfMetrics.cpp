@@ -0,0 +1,355 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/PerfMetrics.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "Common/File.h"
+#include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
+#include "Common/StringUtil.h"
+
+namespace PerfMetrics
+{
+namespace
+{
+struct CounterColumn
+{
+  // Null once the counter was destroyed, the column is kept so that the CSV stays consistent.
+  const Counter* counter;
+  std::string name;
+  u64 last_value;
+};
+
+struct HistogramColumn
+{
+  const Histogram* histogram;
+  std::string name;
+  Histogram::Snapshot last_snapshot;
+};
+
+struct Exporter
+{
+  ExportFormat format;
+  File::IOFile file;
+#ifndef _WIN32
+  int socket_fd = -1;
+  sockaddr_un socket_addr;
+#endif
+
+  std::vector<CounterColumn> counters;
+  std::vector<HistogramColumn> histograms;
+
+  u64 frame = 0;
+  std::chrono::steady_clock::time_point start_time;
+  std::chrono::steady_clock::time_point last_frame_time;
+
+  ~Exporter()
+  {
+#ifndef _WIN32
+    if (socket_fd >= 0)
+      close(socket_fd);
+#endif
+  }
+};
+
+struct Registry
+{
+  // Protects the lists of metrics and the exporter, which reads the metrics.
+  std::mutex mutex;
+  std::vector<Counter*> counters;
+  std::vector<Histogram*> histograms;
+  std::unique_ptr<Exporter> exporter;
+};
+}  // Anonymous namespace
+
+// Function local, so that it is constructed before the first static metric, and destroyed after
+// the last one.
+static Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+static std::atomic<bool> s_exporting{false};
+static std::atomic<u32> s_frame_events{0};
+
+u32 TakeFrameEvents()
+{
+  return s_frame_events.exchange(0, std::memory_order_relaxed);
+}
+
+Counter::Counter(std::string name) : m_name(std::move(name))
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  registry.counters.push_back(this);
+}
+
+Counter::~Counter()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  auto& counters = registry.counters;
+  counters.erase(std::remove(counters.begin(), counters.end(), this), counters.end());
+  if (registry.exporter)
+  {
+    for (CounterColumn& column : registry.exporter->counters)
+    {
+      if (column.counter == this)
+        column.counter = nullptr;
+    }
+  }
+}
+
+Histogram::Histogram(std::string name, u32 frame_events)
+    : m_name(std::move(name)), m_frame_events(frame_events)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  registry.histograms.push_back(this);
+}
+
+Histogram::~Histogram()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  auto& histograms = registry.histograms;
+  histograms.erase(std::remove(histograms.begin(), histograms.end(), this), histograms.end());
+  if (registry.exporter)
+  {
+    for (HistogramColumn& column : registry.exporter->histograms)
+    {
+      if (column.histogram == this)
+        column.histogram = nullptr;
+    }
+  }
+}
+
+size_t Histogram::GetBucket(u64 value)
+{
+  if (value == 0)
+    return 0;
+  return std::min<size_t>(IntLog2(value) + 1, NUM_BUCKETS - 1);
+}
+
+void Histogram::Record(u64 value)
+{
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_total.fetch_add(value, std::memory_order_relaxed);
+  m_buckets[GetBucket(value)].fetch_add(1, std::memory_order_relaxed);
+  if (m_frame_events)
+    s_frame_events.fetch_or(m_frame_events, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::GetSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.count = m_count.load(std::memory_order_relaxed);
+  snapshot.total = m_total.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < NUM_BUCKETS; ++i)
+    snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+u64 Histogram::Snapshot::GetMaxBound() const
+{
+  for (size_t i = NUM_BUCKETS; i > 0; --i)
+  {
+    if (buckets[i - 1] != 0)
+      return u64{1} << (i - 1);
+  }
+  return 0;
+}
+
+static Histogram::Snapshot Subtract(const Histogram::Snapshot& a, const Histogram::Snapshot& b)
+{
+  Histogram::Snapshot result;
+  result.count = a.count - b.count;
+  result.total = a.total - b.total;
+  for (size_t i = 0; i < Histogram::NUM_BUCKETS; ++i)
+    result.buckets[i] = a.buckets[i] - b.buckets[i];
+  return result;
+}
+
+static bool OpenOutput(Exporter* exporter, const std::string& path)
+{
+  if (exporter->format != ExportFormat::Socket)
+    return exporter->file.Open(path, "w");
+
+#ifndef _WIN32
+  std::memset(&exporter->socket_addr, 0, sizeof(exporter->socket_addr));
+  exporter->socket_addr.sun_family = AF_UNIX;
+  std::strncpy(exporter->socket_addr.sun_path, path.c_str(),
+               sizeof(exporter->socket_addr.sun_path) - 1);
+  exporter->socket_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  return exporter->socket_fd >= 0;
+#else
+  return false;
+#endif
+}
+
+static void WriteLine(Exporter* exporter, const std::string& line)
+{
+  if (exporter->format != ExportFormat::Socket)
+  {
+    exporter->file.WriteBytes(line.data(), line.size());
+    return;
+  }
+
+#ifndef _WIN32
+  // Fails while nothing is bound to the socket, the frame is simply lost then.
+  sendto(exporter->socket_fd, line.data(), line.size(), MSG_DONTWAIT,
+         reinterpret_cast<const sockaddr*>(&exporter->socket_addr),
+         sizeof(exporter->socket_addr));
+#endif
+}
+
+static std::string FormatCSVHeader(const Exporter& exporter)
+{
+  std::string line = "frame,time_us,frame_time_us";
+  for (const CounterColumn& column : exporter.counters)
+    line += "," + column.name;
+  for (const HistogramColumn& column : exporter.histograms)
+  {
+    line += StringFromFormat(",%s.count,%s.total_us,%s.max_us", column.name.c_str(),
+                             column.name.c_str(), column.name.c_str());
+  }
+  return line + "\n";
+}
+
+bool StartExport(ExportFormat format, const std::string& path)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+
+  auto exporter = std::make_unique<Exporter>();
+  exporter->format = format;
+  if (!OpenOutput(exporter.get(), path))
+  {
+    ERROR_LOG(COMMON, "Failed to open %s for exporting performance metrics", path.c_str());
+    return false;
+  }
+
+  for (const Counter* counter : registry.counters)
+    exporter->counters.push_back({counter, counter->GetName(), counter->Get()});
+  for (const Histogram* histogram : registry.histograms)
+    exporter->histograms.push_back({histogram, histogram->GetName(), histogram->GetSnapshot()});
+
+  // Keep the columns in the same order across runs.
+  std::sort(exporter->counters.begin(), exporter->counters.end(),
+            [](const CounterColumn& a, const CounterColumn& b) { return a.name < b.name; });
+  std::sort(exporter->histograms.begin(), exporter->histograms.end(),
+            [](const HistogramColumn& a, const HistogramColumn& b) { return a.name < b.name; });
+
+  if (format == ExportFormat::CSV)
+    WriteLine(exporter.get(), FormatCSVHeader(*exporter));
+
+  exporter->start_time = std::chrono::steady_clock::now();
+  exporter->last_frame_time = exporter->start_time;
+
+  registry.exporter = std::move(exporter);
+  s_exporting.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+void StopExport()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  s_exporting.store(false, std::memory_order_relaxed);
+  registry.exporter.reset();
+}
+
+bool IsExporting()
+{
+  return s_exporting.load(std::memory_order_relaxed);
+}
+
+void SampleFrame()
+{
+  if (!s_exporting.load(std::memory_order_relaxed))
+    return;
+
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lk(registry.mutex);
+  if (!registry.exporter)
+    return;
+
+  Exporter& exporter = *registry.exporter;
+  const auto now = std::chrono::steady_clock::now();
+  const auto ToMicroseconds = [](std::chrono::steady_clock::duration duration) {
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  };
+  const u64 time = ToMicroseconds(now - exporter.start_time);
+  const u64 frame_time = ToMicroseconds(now - exporter.last_frame_time);
+  exporter.last_frame_time = now;
+  ++exporter.frame;
+
+  const bool csv = exporter.format == ExportFormat::CSV;
+  std::string line =
+      csv ? StringFromFormat("%" PRIu64 ",%" PRIu64 ",%" PRIu64, exporter.frame, time,
+                             frame_time) :
+            StringFromFormat("{\"frame\":%" PRIu64 ",\"time_us\":%" PRIu64
+                             ",\"frame_time_us\":%" PRIu64 ",\"counters\":{",
+                             exporter.frame, time, frame_time);
+
+  bool first = true;
+  for (CounterColumn& column : exporter.counters)
+  {
+    const u64 value = column.counter ? column.counter->Get() : column.last_value;
+    const u64 delta = value - column.last_value;
+    column.last_value = value;
+
+    if (csv)
+      line += StringFromFormat(",%" PRIu64, delta);
+    else
+      line += StringFromFormat("%s\"%s\":%" PRIu64, first ? "" : ",", column.name.c_str(), delta);
+    first = false;
+  }
+
+  if (!csv)
+    line += "},\"histograms\":{";
+
+  first = true;
+  for (HistogramColumn& column : exporter.histograms)
+  {
+    const Histogram::Snapshot snapshot =
+        column.histogram ? column.histogram->GetSnapshot() : column.last_snapshot;
+    const Histogram::Snapshot delta = Subtract(snapshot, column.last_snapshot);
+    column.last_snapshot = snapshot;
+
+    if (csv)
+    {
+      line += StringFromFormat(",%" PRIu64 ",%" PRIu64 ",%" PRIu64, delta.count, delta.total,
+                               delta.GetMaxBound());
+    }
+    else
+    {
+      line += StringFromFormat("%s\"%s\":{\"count\":%" PRIu64 ",\"total_us\":%" PRIu64
+                               ",\"max_us\":%" PRIu64 "}",
+                               first ? "" : ",", column.name.c_str(), delta.count, delta.total,
+                               delta.GetMaxBound());
+    }
+    first = false;
+  }
+
+  line += csv ? "\n" : "}}\n";
+  WriteLine(&exporter, line);
+}
+
+}  // namespace PerfMetrics
@@ -0,0 +1,138 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Performance metrics
+//
+// Subsystems define counters and histograms as static objects, which register themselves by
+// name. Updating them only takes relaxed atomic operations, so they can be updated from any
+// thread and are cheap enough to stay enabled all the time.
+//
+// Once per frame, SampleFrame takes the change of every metric since the previous frame, and
+// writes it to the export started with StartExport. Nothing is sampled without an export.
+namespace PerfMetrics
+{
+// A count that only goes up, like the number of compiled blocks.
+class Counter
+{
+public:
+  explicit Counter(std::string name);
+  ~Counter();
+
+  Counter(const Counter&) = delete;
+  Counter& operator=(const Counter&) = delete;
+
+  void Add(u64 amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+  u64 Get() const { return m_value.load(std::memory_order_relaxed); }
+  const std::string& GetName() const { return m_name; }
+
+private:
+  std::string m_name;
+  std::atomic<u64> m_value{0};
+};
+
+// Things that commonly make a frame take longer. The histograms that time them mark the frame
+// they happen in, so that slow frames can be attributed to them.
+enum FrameEvent : u32
+{
+  FRAME_EVENT_SHADER_COMPILE = 1 << 0,
+  FRAME_EVENT_TEXTURE_LOAD = 1 << 1,
+  FRAME_EVENT_JIT_COMPILE = 1 << 2,
+  FRAME_EVENT_DVD_READ = 1 << 3,
+};
+
+// Returns the FrameEvent flags that were marked since the last call, and clears them.
+u32 TakeFrameEvents();
+
+// A distribution of durations in microseconds, kept in power of two buckets. Bucket i holds the
+// values below 2^i, that didn't fit in the previous bucket. The last bucket holds everything that
+// is larger.
+class Histogram
+{
+public:
+  static constexpr size_t NUM_BUCKETS = 24;
+
+  struct Snapshot
+  {
+    u64 count = 0;
+    u64 total = 0;
+    std::array<u64, NUM_BUCKETS> buckets{};
+
+    // The upper bound of the largest non-empty bucket, or 0 if there are no values.
+    u64 GetMaxBound() const;
+  };
+
+  // Every recorded value marks the given FrameEvent flags.
+  explicit Histogram(std::string name, u32 frame_events = 0);
+  ~Histogram();
+
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void Record(u64 value);
+  Snapshot GetSnapshot() const;
+  u64 GetTotal() const { return m_total.load(std::memory_order_relaxed); }
+  const std::string& GetName() const { return m_name; }
+
+  static size_t GetBucket(u64 value);
+
+private:
+  std::string m_name;
+  u32 m_frame_events;
+  std::atomic<u64> m_count{0};
+  std::atomic<u64> m_total{0};
+  std::array<std::atomic<u64>, NUM_BUCKETS> m_buckets{};
+};
+
+// Records the time until the end of the scope in a histogram.
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(Histogram& histogram)
+      : m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+  {
+  }
+  ~ScopedTimer()
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_histogram.Record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Histogram& m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+enum class ExportFormat
+{
+  // A header line with the column names, then one line per frame.
+  CSV,
+  // One JSON object per frame and line.
+  JSON,
+  // The JSON lines sent as datagrams to a local UNIX socket. Frames are dropped while nothing
+  // is listening.
+  Socket,
+};
+
+// Starts writing the per-frame samples to the file or socket at path. The metrics that exist at
+// this point are exported, ones that are registered later are left out until the next export.
+bool StartExport(ExportFormat format, const std::string& path);
+void StopExport();
+bool IsExporting();
+
+// Called once per frame by the renderer.
+void SampleFrame();
+
+}  // namespace PerfMetrics
@@ -50,6 +50,7 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/SignatureDB/SignatureDB.h"
 
 #include "DiscIO/Enums.h"
 #include "DiscIO/Volume.h"
@@ -196,6 +197,24 @@ bool CBoot::LoadMapFromFilename()
   return false;
 }
 
+bool CBoot::IdentifySDKFunctions()
+{
+  if (!HLE::IsEnabled(HLE::HookFlag::Optimization))
+    return false;
+
+  SignatureDB db(SignatureDB::HandlerType::DSY);
+  if (!db.Load(File::GetSysDirectory() + TOTALDB))
+  {
+    WARN_LOG(BOOT, "Could not load %s, SDK functions will not be replaced", TOTALDB);
+    return false;
+  }
+
+  PPCAnalyst::FindFunctions(0x80000000, 0x80000000 + Memory::REALRAM_SIZE, &g_symbolDB);
+  db.Apply(&g_symbolDB);
+  UpdateDebugger_MapLoaded();
+  return true;
+}
+
 // If ipl.bin is not found, this function does *some* of what BS1 does:
 // loading IPL(BS2) and jumping to it.
 // It does not initialize the hardware or anything else like BS1 does.
@@ -336,7 +355,7 @@ bool CBoot::BootUp(std::unique_ptr<BootParameters> boot)
 
       // Try to load the symbol map if there is one, and then scan it for
       // and eventually replace code
-      if (LoadMapFromFilename())
+      if (LoadMapFromFilename() || IdentifySDKFunctions())
         HLE::PatchFunctions();
 
       return true;
@@ -382,7 +401,7 @@ bool CBoot::BootUp(std::unique_ptr<BootParameters> boot)
 
       PC = executable.reader->GetEntryPoint();
 
-      if (executable.reader->LoadSymbols() || LoadMapFromFilename())
+      if (executable.reader->LoadSymbols() || LoadMapFromFilename() || IdentifySDKFunctions())
       {
         UpdateDebugger_MapLoaded();
         HLE::PatchFunctions();
@@ -97,6 +97,9 @@ public:
   // Returns true if a map file exists, false if none could be found.
   static bool FindMapFile(std::string* existing_map_file, std::string* writable_map_file);
   static bool LoadMapFromFilename();
+  // Identifies well known SDK functions using the bundled signature database, so that they
+  // can be replaced by native implementations. Only used if there is no map file.
+  static bool IdentifySDKFunctions();
 
 private:
   static bool DVDRead(const DiscIO::Volume& volume, u64 dvd_offset, u32 output_address, u32 length,
@@ -20,7 +20,16 @@ const ConfigInfo<bool> MAIN_LOAD_IPL_DUMP{{System::Main, "Core", "LoadIPLDump"},
 const ConfigInfo<PowerPC::CPUCore> MAIN_CPU_CORE{{System::Main, "Core", "CPUCore"},
                                                  PowerPC::DefaultCPUCore()};
 const ConfigInfo<bool> MAIN_JIT_FOLLOW_BRANCH{{System::Main, "Core", "JITFollowBranch"}, true};
+const ConfigInfo<bool> MAIN_JIT_TIERED_COMPILATION{
+    {System::Main, "Core", "JITTieredCompilation"}, false};
 const ConfigInfo<bool> MAIN_FASTMEM{{System::Main, "Core", "Fastmem"}, true};
+const ConfigInfo<bool> MAIN_FASTMEM_PAGE_TABLES{{System::Main, "Core", "FastmemPageTables"},
+                                                true};
+const ConfigInfo<bool> MAIN_SAMPLING_PROFILER{{System::Main, "Core", "SamplingProfiler"}, false};
+const ConfigInfo<std::string> MAIN_PERF_METRICS_EXPORT{{System::Main, "Core", "PerfMetricsExport"},
+                                                       ""};
+const ConfigInfo<bool> MAIN_REPLACE_SDK_FUNCTIONS{{System::Main, "Core", "ReplaceSDKFunctions"},
+                                                  false};
 const ConfigInfo<bool> MAIN_DSP_HLE{{System::Main, "Core", "DSPHLE"}, true};
 const ConfigInfo<int> MAIN_TIMING_VARIANCE{{System::Main, "Core", "TimingVariance"}, 40};
 const ConfigInfo<bool> MAIN_CPU_THREAD{{System::Main, "Core", "CPUThread"}, true};
@@ -21,7 +21,13 @@ extern const ConfigInfo<bool> MAIN_SKIP_IPL;
 extern const ConfigInfo<bool> MAIN_LOAD_IPL_DUMP;
 extern const ConfigInfo<PowerPC::CPUCore> MAIN_CPU_CORE;
 extern const ConfigInfo<bool> MAIN_JIT_FOLLOW_BRANCH;
+extern const ConfigInfo<bool> MAIN_JIT_TIERED_COMPILATION;
 extern const ConfigInfo<bool> MAIN_FASTMEM;
+extern const ConfigInfo<bool> MAIN_FASTMEM_PAGE_TABLES;
+extern const ConfigInfo<bool> MAIN_SAMPLING_PROFILER;
+// "csv", "json" or "socket" to export the performance metrics, see Common/PerfMetrics.h.
+extern const ConfigInfo<std::string> MAIN_PERF_METRICS_EXPORT;
+extern const ConfigInfo<bool> MAIN_REPLACE_SDK_FUNCTIONS;
 // Should really be in the DSP section, but we're kind of stuck with bad decisions made in the past.
 extern const ConfigInfo<bool> MAIN_DSP_HLE;
 extern const ConfigInfo<int> MAIN_TIMING_VARIANCE;
@@ -31,6 +31,10 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::MAIN_DEFAULT_ISO.location,
       Config::MAIN_MEMCARD_A_PATH.location,
       Config::MAIN_MEMCARD_B_PATH.location,
+      Config::MAIN_SAMPLING_PROFILER.location,
+      Config::MAIN_PERF_METRICS_EXPORT.location,
+      Config::MAIN_JIT_TIERED_COMPILATION.location,
+      Config::MAIN_REPLACE_SDK_FUNCTIONS.location,
 
       // Graphics.Hardware
 
@@ -112,6 +116,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       // Graphics.Hacks
 
       Config::GFX_HACK_EFB_ACCESS_ENABLE.location,
+      Config::GFX_HACK_EFB_PEEK_PREFETCH.location,
       Config::GFX_HACK_BBOX_ENABLE.location,
       Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION.location,
       Config::GFX_HACK_FORCE_PROGRESSIVE.location,
@@ -26,6 +26,7 @@
 #include "Common/Logging/LogManager.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
@@ -33,6 +34,7 @@
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -60,6 +62,7 @@
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/State.h"
 #include "Core/WiiRoot.h"
 
@@ -293,6 +296,23 @@ static void CPUSetInitialExecutionState()
   });
 }
 
+static void StartPerfMetricsExport()
+{
+  const std::string mode = Config::Get(Config::MAIN_PERF_METRICS_EXPORT);
+  if (mode.empty())
+    return;
+
+  const std::string logs_dir = File::GetUserPath(D_LOGS_IDX);
+  if (mode == "csv")
+    PerfMetrics::StartExport(PerfMetrics::ExportFormat::CSV, logs_dir + PERF_METRICS_CSV);
+  else if (mode == "json")
+    PerfMetrics::StartExport(PerfMetrics::ExportFormat::JSON, logs_dir + PERF_METRICS_JSON);
+  else if (mode == "socket")
+    PerfMetrics::StartExport(PerfMetrics::ExportFormat::Socket, logs_dir + PERF_METRICS_SOCKET);
+  else
+    WARN_LOG(CORE, "Unknown performance metrics export mode \"%s\"", mode.c_str());
+}
+
 // Create the CPU thread, which is a CPU + Video thread in Single Core mode.
 static void CpuThread(const std::optional<std::string>& savestate_path, bool delete_savestate)
 {
@@ -432,6 +452,12 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
     HLE::Clear();
   }};
 
+  StartPerfMetricsExport();
+  Common::ScopeGuard perf_metrics_guard{PerfMetrics::StopExport};
+
+  Profiler::Init();
+  Common::ScopeGuard profiler_guard{Profiler::Shutdown};
+
   // Backend info has to be initialized before we can initialize the backend.
   // This is because when we load the config, we validate it against the current backend info.
   // We also should have the correct adapter selected for creating the device in Initialize().
@@ -14,6 +14,7 @@
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
+#include "Common/PerfMetrics.h"
 #include "Common/SPSCQueue.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
@@ -55,6 +56,8 @@ static bool operator<(const Event& left, const Event& right)
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
 
+static PerfMetrics::Counter s_events_executed("coretiming.events");
+
 // STATE_TO_SAVE
 // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
 // We don't use std::priority_queue because we need to be able to serialize, unserialize and
@@ -332,6 +335,7 @@ void Advance()
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
+    s_events_executed.Add();
   }
 
   s_is_global_timer_sane = false;
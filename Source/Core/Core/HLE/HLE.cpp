@@ -9,10 +9,13 @@
 
 #include "Common/CommonTypes.h"
 
+#include "Common/Config/Config.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/GeckoCode.h"
 #include "Core/HLE/HLE_Misc.h"
 #include "Core/HLE/HLE_OS.h"
+#include "Core/HLE/HLE_SDK.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IOS/ES/ES.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -69,6 +72,23 @@ static const SPatch OSPatches[] = {
     {"___blank",                     HLE_OS::HLE_GeneralDebugPrint,         HookType::Start,   HookFlag::Debug}, // used for early init things (normally)
     {"__write_console",              HLE_OS::HLE_write_console,             HookType::Start,   HookFlag::Debug}, // used by sysmenu (+more?)
 
+    // SDK functions which are usually identified using the signature database
+    {"memcpy",                       HLE_SDK::Memcpy,                       HookType::Replace, HookFlag::Optimization},
+    {"memmove",                      HLE_SDK::Memcpy,                       HookType::Replace, HookFlag::Optimization},
+    {"memset",                       HLE_SDK::Memset,                       HookType::Replace, HookFlag::Optimization},
+    {"__fill_mem",                   HLE_SDK::Memset,                       HookType::Replace, HookFlag::Optimization},
+    {"DCFlushRange",                 HLE_SDK::DCFlushRange,                 HookType::Replace, HookFlag::Optimization},
+    {"DCFlushRangeNoSync",           HLE_SDK::DCFlushRange,                 HookType::Replace, HookFlag::Optimization},
+    {"DCStoreRange",                 HLE_SDK::DCFlushRange,                 HookType::Replace, HookFlag::Optimization},
+    {"DCStoreRangeNoSync",           HLE_SDK::DCFlushRange,                 HookType::Replace, HookFlag::Optimization},
+    {"DCInvalidateRange",            HLE_SDK::DCFlushRange,                 HookType::Replace, HookFlag::Optimization},
+    {"PSMTXIdentity",                HLE_SDK::PSMTXIdentity,                HookType::Replace, HookFlag::Optimization},
+    {"PSMTXCopy",                    HLE_SDK::PSMTXCopy,                    HookType::Replace, HookFlag::Optimization},
+    {"PSMTXTrans",                   HLE_SDK::PSMTXTrans,                   HookType::Replace, HookFlag::Optimization},
+    {"PSMTXScale",                   HLE_SDK::PSMTXScale,                   HookType::Replace, HookFlag::Optimization},
+    {"PSMTX44Identity",              HLE_SDK::PSMTX44Identity,              HookType::Replace, HookFlag::Optimization},
+    {"PSMTX44Copy",                  HLE_SDK::PSMTX44Copy,                  HookType::Replace, HookFlag::Optimization},
+
     {"GeckoCodehandler",             HLE_Misc::GeckoCodeHandlerICacheFlush, HookType::Start,   HookFlag::Fixed},
     {"GeckoHandlerReturnTrampoline", HLE_Misc::GeckoReturnTrampoline,       HookType::Replace, HookFlag::Fixed},
     {"AppLoaderReport",              HLE_OS::HLE_GeneralDebugPrint,         HookType::Replace, HookFlag::Fixed} // apploader needs OSReport-like function
@@ -175,6 +195,10 @@ void Execute(u32 _CurrentPC, u32 _Instruction)
   unsigned int FunctionIndex = _Instruction & 0xFFFFF;
   if (FunctionIndex > 0 && FunctionIndex < ArraySize(OSPatches))
   {
+    // Optimizations that can't handle a call leave NPC untouched, which tells the caller to
+    // execute the original function instead.
+    if (OSPatches[FunctionIndex].flags == HookFlag::Optimization)
+      NPC = _CurrentPC;
     OSPatches[FunctionIndex].PatchFunction();
   }
   else
@@ -198,6 +222,17 @@ u32 GetFirstFunctionIndex(u32 address)
   return first == std::end(s_original_instructions) ? index : 0;
 }
 
+u32 GetInlinableFunctionIndex(u32 address)
+{
+  const u32 index = GetFirstFunctionIndex(address);
+  if (index == 0 || OSPatches[index].type != HookType::Replace)
+    return 0;
+
+  // Other hooks may have side effects that require leaving the block (e.g. HBReload).
+  const HookFlag flags = OSPatches[index].flags;
+  return flags == HookFlag::Optimization && IsEnabled(flags) ? index : 0;
+}
+
 HookType GetFunctionTypeByIndex(u32 index)
 {
   return OSPatches[index].type;
@@ -210,6 +245,9 @@ HookFlag GetFunctionFlagsByIndex(u32 index)
 
 bool IsEnabled(HookFlag flag)
 {
+  if (flag == HLE::HookFlag::Optimization)
+    return Config::Get(Config::MAIN_REPLACE_SDK_FUNCTIONS);
+
   return flag != HLE::HookFlag::Debug || SConfig::GetInstance().bEnableDebugging ||
          PowerPC::GetMode() == PowerPC::CoreMode::Interpreter;
 }
@@ -19,9 +19,10 @@ enum class HookType
 
 enum class HookFlag
 {
-  Generic,  // Miscellaneous function
-  Debug,    // Debug output function
-  Fixed,    // An arbitrary hook mapped to a fixed address instead of a symbol
+  Generic,       // Miscellaneous function
+  Debug,         // Debug output function
+  Fixed,         // An arbitrary hook mapped to a fixed address instead of a symbol
+  Optimization,  // Native replacement of an SDK function, only used for speed
 };
 
 void PatchFixedFunctions();
@@ -38,6 +39,9 @@ void Execute(u32 _CurrentPC, u32 _Instruction);
 u32 GetFunctionIndex(u32 address);
 // Returns the HLE function index if the address matches the function start
 u32 GetFirstFunctionIndex(u32 address);
+// Returns the HLE function index if calls to the address may be compiled as direct calls to the
+// HLE function, which then returns to the instruction after the call
+u32 GetInlinableFunctionIndex(u32 address);
 HookType GetFunctionTypeByIndex(u32 index);
 HookFlag GetFunctionFlagsByIndex(u32 index);
 
@@ -0,0 +1,195 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HLE/HLE_SDK.h"
+
+#include <array>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace HLE_SDK
+{
+namespace
+{
+constexpr u32 FLOAT_ZERO = 0x00000000;
+constexpr u32 FLOAT_ONE = 0x3f800000;
+
+// Stores a sequence of words in ascending address order.
+bool WriteWords(u32 address, const u32* words, u32 count)
+{
+  u8* ptr = PowerPC::GetRAMPointerForRange(address, count * sizeof(u32));
+  if (!ptr)
+    return false;
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 value = Common::swap32(words[i]);
+    std::memcpy(ptr + i * sizeof(u32), &value, sizeof(u32));
+  }
+  return true;
+}
+
+// Copies a matrix the way the paired single loads and stores in the SDK do, i.e. in ascending
+// 8 byte chunks. That is only a bit for bit copy with GQR0 set up for unscaled floats (which
+// OSInit does), so the original code is run if a game changed it.
+bool CopyMatrix(u32 src, u32 dest, u32 size)
+{
+  if (GQR(0) != 0)
+    return false;
+
+  const u8* src_ptr = PowerPC::GetRAMPointerForRange(src, size);
+  u8* dest_ptr = PowerPC::GetRAMPointerForRange(dest, size);
+  if (!src_ptr || !dest_ptr)
+    return false;
+
+  for (u32 offset = 0; offset < size; offset += sizeof(u64))
+  {
+    u64 value;
+    std::memcpy(&value, src_ptr + offset, sizeof(u64));
+    std::memcpy(dest_ptr + offset, &value, sizeof(u64));
+  }
+  return true;
+}
+
+// Matrices are stored as rows of four floats.
+template <size_t rows>
+std::array<u32, rows * 4> MakeDiagonalMatrix(u32 x, u32 y, u32 z, u32 w = FLOAT_ONE)
+{
+  std::array<u32, rows * 4> matrix;
+  matrix.fill(FLOAT_ZERO);
+  const u32 diagonal[] = {x, y, z, w};
+  for (size_t row = 0; row < rows; ++row)
+    matrix[row * 4 + row] = diagonal[row];
+  return matrix;
+}
+
+template <size_t size>
+void ReturnIfWritten(u32 address, const std::array<u32, size>& words)
+{
+  if (WriteWords(address, words.data(), static_cast<u32>(size)))
+    NPC = LR;
+}
+}  // Anonymous namespace
+
+// Used for memcpy and memmove, which both copy backwards if the source is located below the
+// destination, so that overlapping ranges work as expected.
+void Memcpy()
+{
+  const u32 dest = GPR(3);
+  const u32 src = GPR(4);
+  const u32 size = GPR(5);
+
+  if (size == 0)
+  {
+    NPC = LR;
+    return;
+  }
+
+  u8* dest_ptr = PowerPC::GetRAMPointerForRange(dest, size);
+  const u8* src_ptr = PowerPC::GetRAMPointerForRange(src, size);
+  if (!dest_ptr || !src_ptr)
+    return;
+
+  // If the ranges are in different mirrors of the same memory, the direction of the copy
+  // depends on the effective addresses rather than on the host pointers.
+  const bool backwards = src < dest;
+  if (backwards == (src_ptr < dest_ptr))
+  {
+    std::memmove(dest_ptr, src_ptr, size);
+  }
+  else if (backwards)
+  {
+    for (u32 i = size; i != 0; --i)
+      dest_ptr[i - 1] = src_ptr[i - 1];
+  }
+  else
+  {
+    for (u32 i = 0; i < size; ++i)
+      dest_ptr[i] = src_ptr[i];
+  }
+
+  // The destination is returned in r3, which is left untouched.
+  NPC = LR;
+}
+
+// Used for memset and __fill_mem.
+void Memset()
+{
+  const u32 dest = GPR(3);
+  const u32 size = GPR(5);
+
+  if (size != 0)
+  {
+    u8* dest_ptr = PowerPC::GetRAMPointerForRange(dest, size);
+    if (!dest_ptr)
+      return;
+    std::memset(dest_ptr, static_cast<u8>(GPR(4)), size);
+  }
+
+  NPC = LR;
+}
+
+// Used for all of the DC*Range functions that operate on whole cache blocks. As the data cache
+// isn't emulated, the only effect of the dcbf/dcbst/dcbi loops in them is that the JIT cache
+// gets invalidated for the affected blocks.
+void DCFlushRange()
+{
+  const u32 address = GPR(3);
+  const u32 size = GPR(4);
+
+  if (size != 0)
+  {
+    const u32 start = address & ~0x1f;
+    const u64 end = (static_cast<u64>(address) + size + 0x1f) & ~u64{0x1f};
+    JitInterface::InvalidateICache(start, static_cast<u32>(end - start), false);
+  }
+
+  NPC = LR;
+}
+
+void PSMTXIdentity()
+{
+  ReturnIfWritten(GPR(3), MakeDiagonalMatrix<3>(FLOAT_ONE, FLOAT_ONE, FLOAT_ONE));
+}
+
+void PSMTXCopy()
+{
+  if (CopyMatrix(GPR(3), GPR(4), 3 * 4 * sizeof(u32)))
+    NPC = LR;
+}
+
+// The translation and scale factors are passed in f1-f3 and stored with stfs.
+void PSMTXTrans()
+{
+  auto matrix = MakeDiagonalMatrix<3>(FLOAT_ONE, FLOAT_ONE, FLOAT_ONE);
+  matrix[3] = ConvertToSingle(riPS0(1));
+  matrix[7] = ConvertToSingle(riPS0(2));
+  matrix[11] = ConvertToSingle(riPS0(3));
+  ReturnIfWritten(GPR(3), matrix);
+}
+
+void PSMTXScale()
+{
+  ReturnIfWritten(GPR(3), MakeDiagonalMatrix<3>(ConvertToSingle(riPS0(1)),
+                                                ConvertToSingle(riPS0(2)),
+                                                ConvertToSingle(riPS0(3))));
+}
+
+void PSMTX44Identity()
+{
+  ReturnIfWritten(GPR(3), MakeDiagonalMatrix<4>(FLOAT_ONE, FLOAT_ONE, FLOAT_ONE));
+}
+
+void PSMTX44Copy()
+{
+  if (CopyMatrix(GPR(3), GPR(4), 4 * 4 * sizeof(u32)))
+    NPC = LR;
+}
+}  // namespace HLE_SDK
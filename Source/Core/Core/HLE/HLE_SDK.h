@@ -0,0 +1,29 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Native replacements for hot functions of the GameCube/Wii SDK and its C runtime.
+//
+// These must have exactly the same effect on guest memory as the functions they replace,
+// so that it doesn't matter whether a call ends up being interpreted or replaced.
+// Functions whose results depend on paired single rounding (e.g. PSMTXConcat) are not
+// replaced for that reason.
+//
+// A replacement only handles a call if all of the memory it accesses is RAM that can be
+// accessed directly. Otherwise, it leaves NPC unchanged, and the original function is executed
+// instead, so that MMIO, memchecks and DSI exceptions keep working.
+namespace HLE_SDK
+{
+void Memcpy();
+void Memset();
+void DCFlushRange();
+
+void PSMTXIdentity();
+void PSMTXCopy();
+void PSMTXTrans();
+void PSMTXScale();
+void PSMTX44Identity();
+void PSMTX44Copy();
+}  // namespace HLE_SDK
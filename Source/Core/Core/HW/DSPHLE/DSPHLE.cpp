@@ -7,6 +7,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 #include "Core/Core.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 #include "Core/HW/SystemTimers.h"
@@ -15,6 +16,9 @@ namespace DSP
 {
 namespace HLE
 {
+static PerfMetrics::Histogram s_update_time("dsphle.update_us");
+static PerfMetrics::Histogram s_mail_time("dsphle.mail_us");
+
 DSPHLE::DSPHLE() = default;
 
 DSPHLE::~DSPHLE() = default;
@@ -48,7 +52,10 @@ void DSPHLE::Shutdown()
 void DSPHLE::DSP_Update(int cycles)
 {
   if (m_ucode != nullptr)
+  {
+    PerfMetrics::ScopedTimer timer(s_update_time);
     m_ucode->Update();
+  }
 }
 
 u32 DSPHLE::DSP_UpdateRate()
@@ -177,7 +184,11 @@ void DSPHLE::DSP_WriteMailBoxLow(bool cpu_mailbox, u16 value)
   if (cpu_mailbox)
   {
     m_dsp_state.cpu_mailbox = (m_dsp_state.cpu_mailbox & 0xFFFF0000) | value;
-    SendMailToDSP(m_dsp_state.cpu_mailbox);
+    {
+      // The uCodes handle most commands right when the mail arrives.
+      PerfMetrics::ScopedTimer timer(s_mail_time);
+      SendMailToDSP(m_dsp_state.cpu_mailbox);
+    }
     // Mail sent so clear MSB to show that it is progressed
     m_dsp_state.cpu_mailbox &= 0x7FFFFFFF;
   }
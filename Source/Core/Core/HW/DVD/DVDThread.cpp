@@ -19,6 +19,7 @@
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 #include "Common/SPSCQueue.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
@@ -66,6 +67,9 @@ using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 static void StartDVDThread();
 static void StopDVDThread();
 
+static PerfMetrics::Counter s_bytes_read("dvd.bytes_read");
+static PerfMetrics::Histogram s_read_time("dvd.read_us", PerfMetrics::FRAME_EVENT_DVD_READ);
+
 static void DVDThread();
 static void WaitUntilIdle();
 
@@ -365,8 +369,12 @@ static void DVDThread()
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      {
+        PerfMetrics::ScopedTimer timer(s_read_time);
+        if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
+      s_bytes_read.Add(buffer.size());
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
@@ -292,7 +292,12 @@ public:
   std::vector<GCMBlock> m_save_data;
   std::vector<u16> m_used_blocks;
   int UsesBlock(u16 blocknum);
+  void MarkBlockDirty(u16 block_index);
   bool m_dirty;
+  // Indices into m_save_data of blocks that were modified since the last flush.
+  std::vector<bool> m_dirty_blocks;
+  // Set when the whole file has to be rewritten instead of only the header and dirty blocks.
+  bool m_needs_full_write = false;
   std::string m_filename;
 };
 
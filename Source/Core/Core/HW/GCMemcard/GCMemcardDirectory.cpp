@@ -376,6 +376,8 @@ s32 GCMemcardDirectory::Write(u32 dest_address, s32 length, const u8* src_addres
   }
 
   memcpy(m_last_block_address + offset, src_address, length);
+  if (block >= MC_FST_BLOCKS)
+    m_saves[m_last_save_index].MarkBlockDirty(m_last_save_block);
 
   l.unlock();
   if (extra)
@@ -454,6 +456,12 @@ inline void GCMemcardDirectory::SyncSaves()
         u32 new_gamecode = BE32(current->Dir[i].Gamecode);
         u32 old_start = BE16(m_saves[i].m_gci_header.FirstBlock);
         u32 new_start = BE16(current->Dir[i].FirstBlock);
+        // A new or resized save can't be updated in place.
+        if (added || gamecode != new_gamecode ||
+            BE16(m_saves[i].m_gci_header.BlockCount) != BE16(current->Dir[i].BlockCount))
+        {
+          m_saves[i].m_needs_full_write = true;
+        }
 
         if ((gamecode != 0xFFFFFFFF) && (gamecode != new_gamecode))
         {
@@ -466,6 +474,8 @@ inline void GCMemcardDirectory::SyncSaves()
           INFO_LOG(EXPANSIONINTERFACE, "Save moved from 0x%x to 0x%x", old_start, new_start);
           m_saves[i].m_used_blocks.clear();
           m_saves[i].m_save_data.clear();
+          m_saves[i].m_dirty_blocks.clear();
+          m_saves[i].m_needs_full_write = true;
         }
         if (m_saves[i].m_used_blocks.size() == 0)
         {
@@ -480,6 +490,7 @@ inline void GCMemcardDirectory::SyncSaves()
       *(u32*)&(m_saves[i].m_gci_header.Gamecode) = 0xFFFFFFFF;
       m_saves[i].m_save_data.clear();
       m_saves[i].m_used_blocks.clear();
+      m_saves[i].m_dirty_blocks.clear();
       m_saves[i].m_dirty = true;
     }
   }
@@ -506,13 +517,16 @@ inline s32 GCMemcardDirectory::SaveAreaRW(u32 block, bool writing)
             m_saves[i].m_save_data.emplace_back();
             num_blocks--;
           }
+          m_saves[i].m_needs_full_write = true;
         }
 
         if (writing)
         {
-          m_saves[i].m_dirty = true;
+          m_saves[i].MarkBlockDirty(idx);
         }
 
+        m_last_save_index = i;
+        m_last_save_block = idx;
         m_last_block = block;
         m_last_block_address = m_saves[i].m_save_data[idx].block;
         return m_last_block;
@@ -578,9 +592,19 @@ bool GCMemcardDirectory::SetUsedBlocks(int save_index)
 
 void GCMemcardDirectory::FlushToFile()
 {
+  struct PendingWrite
+  {
+    u16 save_index;
+    std::string filename;
+    DEntry header;
+    bool full_write;
+    // Block indices and contents. For full writes, this contains every block in order.
+    std::vector<std::pair<u16, GCMBlock>> blocks;
+  };
+
+  std::lock_guard<std::mutex> flush_lock(m_flush_mutex);
   std::unique_lock<std::mutex> l(m_write_mutex);
-  int errors = 0;
-  DEntry invalid;
+  std::vector<PendingWrite> writes;
   for (u16 i = 0; i < m_saves.size(); ++i)
   {
     if (m_saves[i].m_dirty)
@@ -612,32 +636,27 @@ void GCMemcardDirectory::FlushToFile()
             PanicAlertT("Failed to find new filename.\n%s\n will be overwritten",
                         default_save_name.c_str());
           m_saves[i].m_filename = default_save_name;
+          m_saves[i].m_needs_full_write = true;
         }
-        File::IOFile gci(m_saves[i].m_filename, "wb");
-        if (gci)
-        {
-          gci.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-          gci.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
 
-          if (gci.IsGood())
-          {
-            Core::DisplayMessage(
-                StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-          }
-          else
-          {
-            ++errors;
-            Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s",
-                                                  m_saves[i].m_filename.c_str()),
-                                 4000);
-            ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s",
-                      m_saves[i].m_filename.c_str());
-          }
+        // Only copy what has to be written, the host I/O happens after releasing the lock.
+        PendingWrite write{i, m_saves[i].m_filename, m_saves[i].m_gci_header,
+                           m_saves[i].m_needs_full_write, {}};
+        const std::vector<bool>& dirty_blocks = m_saves[i].m_dirty_blocks;
+        for (u16 block = 0; block < m_saves[i].m_save_data.size(); ++block)
+        {
+          if (write.full_write || (block < dirty_blocks.size() && dirty_blocks[block]))
+            write.blocks.emplace_back(block, m_saves[i].m_save_data[block]);
         }
+        m_saves[i].m_dirty_blocks.clear();
+        m_saves[i].m_needs_full_write = false;
+        writes.push_back(std::move(write));
       }
       else if (m_saves[i].m_filename.length() != 0)
       {
         m_saves[i].m_dirty = false;
+        // The rename is done right away rather than with the writes below, so that checking
+        // for free filenames never sees the old name.
         std::string& old_name = m_saves[i].m_filename;
         std::string deleted_name = old_name + ".deleted";
         if (File::Exists(deleted_name))
@@ -646,22 +665,83 @@ void GCMemcardDirectory::FlushToFile()
         m_saves[i].m_filename.clear();
         m_saves[i].m_save_data.clear();
         m_saves[i].m_used_blocks.clear();
+        m_saves[i].m_dirty_blocks.clear();
       }
     }
+  }
+  l.unlock();
+
+  std::vector<u16> failed_writes;
+  for (const PendingWrite& write : writes)
+  {
+    // Unless the file is new or has changed size, only the header and dirty blocks are updated.
+    File::IOFile gci(write.filename, write.full_write ? "wb" : "r+b");
+    if (!gci)
+    {
+      ERROR_LOG(EXPANSIONINTERFACE, "Failed to open %s for writing", write.filename.c_str());
+      failed_writes.push_back(write.save_index);
+      continue;
+    }
 
-    // Unload the save data for any game that is not running
-    // we could use !m_dirty, but some games have multiple gci files and may not write to them
-    // simultaneously
-    // this ensures that the save data for all of the current games gci files are stored in the
-    // savestate
+    gci.WriteBytes(&write.header, DENTRY_SIZE);
+    for (const auto& [index, block] : write.blocks)
+    {
+      if (!write.full_write)
+        gci.Seek(DENTRY_SIZE + index * BLOCK_SIZE, SEEK_SET);
+      gci.WriteBytes(&block, BLOCK_SIZE);
+    }
+
+    if (gci.IsGood())
+    {
+      Core::DisplayMessage(StringFromFormat("Wrote save contents to %s", write.filename.c_str()),
+                           4000);
+    }
+    else
+    {
+      Core::DisplayMessage(
+          StringFromFormat("Failed to write save contents to %s", write.filename.c_str()), 4000);
+      ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", write.filename.c_str());
+      failed_writes.push_back(write.save_index);
+    }
+  }
+
+  l.lock();
+  if (!failed_writes.empty())
+  {
+    // The dirty blocks of the saves have already been forgotten, and the file may be incomplete,
+    // so write it out entirely next time.
+    for (u16 index : failed_writes)
+    {
+      m_saves[index].m_dirty = true;
+      m_saves[index].m_needs_full_write = true;
+    }
+    m_flush_trigger.Set();
+  }
+
+  // Unload the save data for any game that is not running
+  // we could use !m_dirty, but some games have multiple gci files and may not write to them
+  // simultaneously
+  // this ensures that the save data for all of the current games gci files are stored in the
+  // savestate
+  // This is only done once the writes above have finished, as the data will be read back from
+  // the file. Saves that were changed again in the meantime stay loaded until the next flush.
+  for (u16 i = 0; i < m_saves.size(); ++i)
+  {
     u32 gamecode = BE32(m_saves[i].m_gci_header.Gamecode);
-    if (gamecode != m_game_id && gamecode != 0xFFFFFFFF && m_saves[i].m_save_data.size())
+    if (gamecode != m_game_id && gamecode != 0xFFFFFFFF && m_saves[i].m_save_data.size() &&
+        !m_saves[i].m_dirty)
     {
       INFO_LOG(EXPANSIONINTERFACE, "Flushing savedata to disk for %s",
                m_saves[i].m_filename.c_str());
       m_saves[i].m_save_data.clear();
+      if (m_last_block >= MC_FST_BLOCKS && m_last_save_index == i)
+      {
+        m_last_block = -1;
+        m_last_block_address = nullptr;
+      }
     }
   }
+  l.unlock();
 #if _WRITE_MC_HEADER
   u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
   Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -715,6 +795,14 @@ bool GCIFile::LoadSaveBlocks()
   return true;
 }
 
+void GCIFile::MarkBlockDirty(u16 block_index)
+{
+  if (m_dirty_blocks.size() <= block_index)
+    m_dirty_blocks.resize(block_index + 1);
+  m_dirty_blocks[block_index] = true;
+  m_dirty = true;
+}
+
 int GCIFile::UsesBlock(u16 block_num)
 {
   for (u16 i = 0; i < m_used_blocks.size(); ++i)
@@ -738,6 +826,13 @@ void GCIFile::DoState(PointerWrap& p)
     p.DoPOD<GCMBlock>(*itr);
   }
   p.Do(m_used_blocks);
+
+  // Block level dirty state isn't savestated, so rewrite any save that was dirty entirely.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_dirty_blocks.clear();
+    m_needs_full_write = m_dirty;
+  }
 }
 
 void MigrateFromMemcardFile(const std::string& directory_name, int card_index)
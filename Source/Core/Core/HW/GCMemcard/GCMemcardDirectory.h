@@ -49,6 +49,9 @@ private:
   u32 m_game_id;
   s32 m_last_block;
   u8* m_last_block_address;
+  // Location of m_last_block within m_saves when it is a save block, for dirty tracking.
+  u16 m_last_save_index = 0;
+  u16 m_last_save_block = 0;
 
   Header m_hdr;
   Directory m_dir1, m_dir2;
@@ -58,6 +61,9 @@ private:
   std::vector<std::string> m_loaded_saves;
   std::string m_save_directory;
   Common::Event m_flush_trigger;
+  // Serialises FlushToFile so that the host files are written in order.
+  // Must be acquired before m_write_mutex.
+  std::mutex m_flush_mutex;
   std::mutex m_write_mutex;
   Common::Flag m_exiting;
   std::thread m_flush_thread;
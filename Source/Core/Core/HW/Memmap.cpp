@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <map>
 #include <memory>
 
 #include "Common/ChunkFile.h"
@@ -18,6 +19,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
@@ -164,6 +166,12 @@ static PhysicalMemoryRegion physical_regions[] = {
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Page table translations mirrored into the logical address space, keyed by logical page address.
+// These never overlap BAT mappings, since BATs take precedence over the page table.
+static bool s_page_table_mapping_enabled = false;
+static std::map<u32, void*> s_page_table_mapped_entries;
+constexpr u32 PAGE_TABLE_MAPPING_SIZE = 0x1000;
+
 void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -209,6 +217,8 @@ void Init()
 
 #ifndef _ARCH_32
   logical_base = physical_base + 0x200000000;
+  s_page_table_mapping_enabled =
+      bMMU && SConfig::GetInstance().bFastmem && Config::Get(Config::MAIN_FASTMEM_PAGE_TABLES);
 #endif
 
   if (wii)
@@ -224,6 +234,9 @@ void Init()
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
+  // New BAT mappings take precedence over and may overlap with page table mappings.
+  RemovePageTableMappings(0, 0);
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -263,6 +276,59 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   }
 }
 
+bool IsPageTableMappingEnabled()
+{
+  return s_page_table_mapping_enabled;
+}
+
+bool AddPageTableMapping(u32 logical_address, u32 translated_address)
+{
+  if (!s_page_table_mapping_enabled)
+    return false;
+
+  for (const auto& physical_region : physical_regions)
+  {
+    if (!*physical_region.out_pointer)
+      continue;
+
+    const u32 mapping_address = physical_region.physical_address;
+    if (translated_address < mapping_address ||
+        translated_address - mapping_address >= physical_region.size)
+    {
+      continue;
+    }
+
+    const u32 position = physical_region.shm_position + translated_address - mapping_address;
+    u8* base = logical_base + logical_address;
+    void* mapped_pointer = g_arena.CreateView(position, PAGE_TABLE_MAPPING_SIZE, base);
+    if (!mapped_pointer)
+    {
+      // This happens on hosts which can't map views with a 4KB granularity. Stop trying.
+      WARN_LOG(MEMMAP, "Failed to map logical page %08x, disabling page table mappings",
+               logical_address);
+      s_page_table_mapping_enabled = false;
+      return false;
+    }
+    s_page_table_mapped_entries[logical_address] = mapped_pointer;
+    return true;
+  }
+  return false;
+}
+
+void RemovePageTableMappings(u32 mask, u32 value)
+{
+  for (auto it = s_page_table_mapped_entries.begin(); it != s_page_table_mapped_entries.end();)
+  {
+    if ((it->first & mask) != value)
+    {
+      ++it;
+      continue;
+    }
+    g_arena.ReleaseView(it->second, PAGE_TABLE_MAPPING_SIZE);
+    it = s_page_table_mapped_entries.erase(it);
+  }
+}
+
 void DoState(PointerWrap& p)
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -297,6 +363,8 @@ void Shutdown()
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  RemovePageTableMappings(0, 0);
+  s_page_table_mapping_enabled = false;
   g_arena.ReleaseSHMSegment();
   physical_base = nullptr;
   logical_base = nullptr;
@@ -66,6 +66,15 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Page table translations can be mirrored into the logical address space as well, so that
+// fastmem accesses on games which use the MMU don't have to go through the slow path.
+bool IsPageTableMappingEnabled();
+// Maps the 4KB page at logical_address to translated_address. Returns false if the translated
+// address isn't backed by host memory or if the view couldn't be created.
+bool AddPageTableMapping(u32 logical_address, u32 translated_address);
+// Removes the mappings of all logical pages for which (logical_address & mask) == value.
+void RemovePageTableMappings(u32 mask, u32 value);
+
 void Clear();
 
 // Routines to access physically addressed memory, designed for use by
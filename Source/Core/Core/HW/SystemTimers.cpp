@@ -45,6 +45,7 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 
 #include "Core/HW/SystemTimers.h"
 
+#include <atomic>
 #include <cfloat>
 #include <cmath>
 #include <cstdlib>
@@ -102,7 +103,8 @@ std::mutex s_emu_to_real_time_mutex;
 
 // How much time was spent sleeping since the emulator started. Note: this does not need to be reset
 // at initialization (or ever), since only the "derivative" of that value really matters.
-u64 s_time_spent_sleeping;
+// Atomic because the frame time analysis reads it from the GPU thread.
+std::atomic<u64> s_time_spent_sleeping;
 
 // DSP/CPU timeslicing.
 void DSPCallback(u64 userdata, s64 cyclesLate)
@@ -180,7 +182,8 @@ void ThrottleCallback(u64 last_time, s64 cyclesLate)
 
   {
     std::lock_guard<std::mutex> lk(s_emu_to_real_time_mutex);
-    s_emu_to_real_time_ring_buffer[s_emu_to_real_time_index] = time - s_time_spent_sleeping;
+    s_emu_to_real_time_ring_buffer[s_emu_to_real_time_index] =
+        time - s_time_spent_sleeping.load(std::memory_order_relaxed);
     s_emu_to_real_time_index =
         (s_emu_to_real_time_index + 1) % s_emu_to_real_time_ring_buffer.size();
   }
@@ -199,7 +202,8 @@ void ThrottleCallback(u64 last_time, s64 cyclesLate)
     else if (diff > 1000)
     {
       Common::SleepCurrentThread(diff / 1000);
-      s_time_spent_sleeping += Common::Timer::GetTimeUs() - time;
+      s_time_spent_sleeping.fetch_add(Common::Timer::GetTimeUs() - time,
+                                      std::memory_order_relaxed);
     }
   }
   CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, last_time + 1000);
@@ -248,6 +252,11 @@ s64 GetLocalTimeRTCOffset()
   return s_localtime_rtc_offset;
 }
 
+u64 GetTimeSpentSleeping()
+{
+  return s_time_spent_sleeping.load(std::memory_order_relaxed);
+}
+
 double GetEstimatedEmulationPerformance()
 {
   u64 ts_now, ts_before;  // In microseconds
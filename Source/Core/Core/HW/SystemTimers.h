@@ -62,4 +62,8 @@ s64 GetLocalTimeRTCOffset();
 // - 2.0: the emulator is running at 200% speed (or 100% speed but sleeping half of the time).
 double GetEstimatedEmulationPerformance();
 
+// Returns how many microseconds the CPU thread spent sleeping to limit the emulation speed, since
+// the emulator started.
+u64 GetTimeSpentSleeping();
+
 }  // namespace SystemTimers
@@ -0,0 +1,254 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/IOS/FS/HostBackend/CachedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Common/Logging/Log.h"
+
+namespace IOS::HLE::FS
+{
+CachedHostFile::CachedHostFile(const std::string& host_path)
+    : m_host_path{host_path}, m_file{host_path, "r+b"}
+{
+  if (m_file.IsOpen())
+    m_size = static_cast<u32>(m_file.GetSize());
+}
+
+CachedHostFile::~CachedHostFile()
+{
+  Flush();
+}
+
+u32 CachedHostFile::GetSize() const
+{
+  std::lock_guard<std::mutex> lk(m_cache_mutex);
+  return m_size;
+}
+
+size_t CachedHostFile::GetDirtyPageCount() const
+{
+  std::lock_guard<std::mutex> lk(m_cache_mutex);
+  return m_dirty_pages;
+}
+
+size_t CachedHostFile::GetCachedPageCount() const
+{
+  std::lock_guard<std::mutex> lk(m_cache_mutex);
+  return m_pages.size();
+}
+
+bool CachedHostFile::NeedsHostRead(u32 offset, u32 count, bool writing) const
+{
+  const u32 end = offset + count;
+  for (u32 index = offset / PAGE_SIZE; index * PAGE_SIZE < end; ++index)
+  {
+    if (m_pages.find(index) != m_pages.end())
+      continue;
+
+    const u32 page_start = index * PAGE_SIZE;
+    if (!writing)
+      return true;
+    // Pages that are entirely overwritten or that lie past the end of the file
+    // do not need to be read from the host file first.
+    const bool overwrites_page = offset <= page_start && page_start + PAGE_SIZE <= end;
+    if (!overwrites_page && page_start < m_size)
+      return true;
+  }
+  return false;
+}
+
+CachedHostFile::Page* CachedHostFile::LoadPage(u32 index, bool read_from_file)
+{
+  // Files that are only read are never flushed, so their clean pages must be dropped here.
+  DropCleanPages(MAX_CLEAN_PAGES - 1);
+
+  // Value-initialisation zero fills the page.
+  Page& page = m_pages[index];
+  if (!read_from_file)
+    return &page;
+
+  std::FILE* handle = m_file.GetHandle();
+  m_file.Seek(static_cast<s64>(index) * PAGE_SIZE, SEEK_SET);
+  std::fread(page.data.data(), 1, PAGE_SIZE, handle);
+  if (std::ferror(handle))
+  {
+    ERROR_LOG(IOS_FS, "Failed to read %s", m_host_path.c_str());
+    m_file.Clear();
+    m_pages.erase(index);
+    return nullptr;
+  }
+  return &page;
+}
+
+void CachedHostFile::DropCleanPages(size_t max_clean_pages)
+{
+  size_t clean_pages = m_pages.size() - m_dirty_pages;
+  for (auto it = m_pages.begin(); it != m_pages.end() && clean_pages > max_clean_pages;)
+  {
+    if (it->second.dirty)
+    {
+      ++it;
+      continue;
+    }
+    it = m_pages.erase(it);
+    --clean_pages;
+  }
+}
+
+bool CachedHostFile::Read(u32 offset, u8* ptr, u32 count)
+{
+  std::unique_lock<std::mutex> io_lock(m_io_mutex, std::defer_lock);
+  std::unique_lock<std::mutex> cache_lock(m_cache_mutex);
+  if (NeedsHostRead(offset, count, false))
+  {
+    cache_lock.unlock();
+    io_lock.lock();
+    cache_lock.lock();
+  }
+
+  while (count != 0)
+  {
+    const u32 index = offset / PAGE_SIZE;
+    const u32 page_offset = offset % PAGE_SIZE;
+    const u32 chunk = std::min(count, PAGE_SIZE - page_offset);
+
+    const auto it = m_pages.find(index);
+    const Page* page = it != m_pages.end() ? &it->second : LoadPage(index, true);
+    if (!page)
+      return false;
+
+    std::memcpy(ptr, page->data.data() + page_offset, chunk);
+    ptr += chunk;
+    offset += chunk;
+    count -= chunk;
+  }
+  return true;
+}
+
+bool CachedHostFile::Write(u32 offset, const u8* ptr, u32 count)
+{
+  std::unique_lock<std::mutex> io_lock(m_io_mutex, std::defer_lock);
+  std::unique_lock<std::mutex> cache_lock(m_cache_mutex);
+  if (NeedsHostRead(offset, count, true))
+  {
+    cache_lock.unlock();
+    io_lock.lock();
+    cache_lock.lock();
+  }
+
+  while (count != 0)
+  {
+    const u32 index = offset / PAGE_SIZE;
+    const u32 page_offset = offset % PAGE_SIZE;
+    const u32 chunk = std::min(count, PAGE_SIZE - page_offset);
+
+    Page* page;
+    const auto it = m_pages.find(index);
+    if (it != m_pages.end())
+    {
+      page = &it->second;
+    }
+    else
+    {
+      const bool overwrites_page = chunk == PAGE_SIZE;
+      page = LoadPage(index, !overwrites_page && index * PAGE_SIZE < m_size);
+      if (!page)
+        return false;
+    }
+
+    std::memcpy(page->data.data() + page_offset, ptr, chunk);
+    if (!page->dirty)
+    {
+      page->dirty = true;
+      ++m_dirty_pages;
+    }
+
+    ptr += chunk;
+    offset += chunk;
+    count -= chunk;
+    m_size = std::max(m_size, offset);
+  }
+  return true;
+}
+
+bool CachedHostFile::Flush()
+{
+  std::lock_guard<std::mutex> io_lock(m_io_mutex);
+  return FlushLocked();
+}
+
+void CachedHostFile::Close()
+{
+  std::lock_guard<std::mutex> io_lock(m_io_mutex);
+  FlushLocked();
+  m_file.Close();
+}
+
+bool CachedHostFile::FlushLocked()
+{
+  if (!m_file.IsOpen())
+    return false;
+
+  // Copy the dirty pages so that the CPU thread can keep using the cache during host I/O.
+  std::vector<std::pair<u32, std::vector<u8>>> pages;
+  {
+    std::lock_guard<std::mutex> cache_lock(m_cache_mutex);
+    if (m_dirty_pages == 0)
+      return true;
+
+    pages.reserve(m_dirty_pages);
+    for (auto& [index, page] : m_pages)
+    {
+      if (!page.dirty)
+        continue;
+      const u32 length = std::min(PAGE_SIZE, m_size - index * PAGE_SIZE);
+      pages.emplace_back(index, std::vector<u8>(page.data.begin(), page.data.begin() + length));
+      page.dirty = false;
+    }
+    m_dirty_pages = 0;
+  }
+
+  bool success = true;
+  for (const auto& [index, data] : pages)
+  {
+    if (!m_file.Seek(static_cast<s64>(index) * PAGE_SIZE, SEEK_SET) ||
+        !m_file.WriteBytes(data.data(), data.size()))
+    {
+      success = false;
+      break;
+    }
+  }
+  success = success && m_file.Flush();
+
+  std::lock_guard<std::mutex> cache_lock(m_cache_mutex);
+  if (!success)
+  {
+    ERROR_LOG(IOS_FS, "Failed to write back cached data to %s", m_host_path.c_str());
+    m_file.Clear();
+    // Mark the pages as dirty again so that the next flush retries. Pages that are clean were
+    // not written to since the copy was made, but may have been dropped in the meantime.
+    for (const auto& [index, data] : pages)
+    {
+      Page& page = m_pages[index];
+      if (!page.dirty)
+      {
+        std::copy(data.begin(), data.end(), page.data.begin());
+        page.dirty = true;
+        ++m_dirty_pages;
+      }
+    }
+    return false;
+  }
+
+  DropCleanPages(MAX_CLEAN_PAGES);
+  return true;
+}
+
+}  // namespace IOS::HLE::FS
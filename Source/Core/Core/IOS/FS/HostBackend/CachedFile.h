@@ -0,0 +1,82 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+
+namespace IOS::HLE::FS
+{
+/// A host file with a write-back page cache in front of it.
+///
+/// Reads are served from memory whenever possible and writes only touch the cache. Dirty pages
+/// are written back to the host file by Flush(), which is either called by the FS flush thread
+/// or synchronously when the file is closed, the FS is savestated or the path is accessed
+/// through a path-based FS call.
+///
+/// Read(), Write() and GetSize() are called from the CPU thread while Flush() may be called
+/// from any thread.
+class CachedHostFile final
+{
+public:
+  // Matches the NAND cluster size.
+  static constexpr u32 PAGE_SIZE = 0x4000;
+  // Clean pages beyond this amount are dropped when another page is loaded or after a flush.
+  static constexpr size_t MAX_CLEAN_PAGES = 64;
+
+  explicit CachedHostFile(const std::string& host_path);
+  ~CachedHostFile();
+
+  CachedHostFile(const CachedHostFile&) = delete;
+  CachedHostFile& operator=(const CachedHostFile&) = delete;
+
+  bool IsOpen() const { return m_file.IsOpen(); }
+  u32 GetSize() const;
+  size_t GetDirtyPageCount() const;
+  size_t GetCachedPageCount() const;
+
+  // The range must be within the current file size.
+  bool Read(u32 offset, u8* ptr, u32 count);
+  bool Write(u32 offset, const u8* ptr, u32 count);
+
+  /// Writes all dirty pages back to the host file.
+  bool Flush();
+  /// Writes all dirty pages back and closes the host file. Used when no handle refers to the
+  /// file anymore, as the flush thread may still hold a reference to it.
+  void Close();
+
+private:
+  struct Page
+  {
+    std::array<u8, PAGE_SIZE> data;
+    bool dirty = false;
+  };
+
+  // Whether accessing the range requires reading pages from the host file.
+  bool NeedsHostRead(u32 offset, u32 count, bool writing) const;
+  // Must be called with both m_io_mutex and m_cache_mutex held.
+  Page* LoadPage(u32 index, bool read_from_file);
+  // Must be called with m_cache_mutex held.
+  void DropCleanPages(size_t max_clean_pages);
+  // Must be called with m_io_mutex held.
+  bool FlushLocked();
+
+  // Lock order: m_io_mutex, then m_cache_mutex.
+  std::mutex m_io_mutex;
+  mutable std::mutex m_cache_mutex;
+
+  std::string m_host_path;
+  File::IOFile m_file;
+  std::map<u32, Page> m_pages;
+  size_t m_dirty_pages = 0;
+  u32 m_size = 0;
+};
+
+}  // namespace IOS::HLE::FS
@@ -47,9 +47,19 @@ static u64 ComputeTotalFileSize(const File::FSTEntry& parent_entry)
 HostFileSystem::HostFileSystem(const std::string& root_path) : m_root_path{root_path}
 {
   Init();
+  m_flush_thread = std::thread(&HostFileSystem::FlushThread, this);
 }
 
-HostFileSystem::~HostFileSystem() = default;
+HostFileSystem::~HostFileSystem()
+{
+  m_exiting.Set();
+  m_flush_event.Set();
+  m_flush_thread.join();
+
+  for (Handle& handle : m_handles)
+    handle.host_file.reset();
+  FlushFiles(BuildFilename("/"));
+}
 
 void HostFileSystem::DoState(PointerWrap& p)
 {
@@ -58,6 +68,7 @@ void HostFileSystem::DoState(PointerWrap& p)
   // Temporarily close the file, to prevent any issues with the savestating of /tmp
   for (Handle& handle : m_handles)
     handle.host_file.reset();
+  FlushFiles(BuildFilename("/"));
 
   // handle /tmp
   std::string Path = BuildFilename("/tmp");
@@ -162,6 +173,7 @@ void HostFileSystem::DoState(PointerWrap& p)
 ResultCode HostFileSystem::Format(Uid uid)
 {
   const std::string root = BuildFilename("/");
+  FlushFiles(root);
   if (!File::DeleteDirRecursively(root) || !File::CreateDir(root))
     return ResultCode::UnknownError;
   return ResultCode::Success;
@@ -205,6 +217,7 @@ ResultCode HostFileSystem::Delete(Uid, Gid, const std::string& path)
     return ResultCode::Invalid;
 
   const std::string file_name = BuildFilename(path);
+  FlushFiles(file_name);
   if (File::Delete(file_name))
     INFO_LOG(IOS_FS, "DeleteFile %s", file_name.c_str());
   else if (File::DeleteDirRecursively(file_name))
@@ -226,6 +239,9 @@ ResultCode HostFileSystem::Rename(Uid, Gid, const std::string& old_path,
     return ResultCode::Invalid;
   const std::string new_name = BuildFilename(new_path);
 
+  FlushFiles(old_name);
+  FlushFiles(new_name);
+
   // try to make the basis directory
   File::CreateFullPath(new_name);
 
@@ -321,6 +337,7 @@ Result<Metadata> HostFileSystem::GetMetadata(Uid, Gid, const std::string& path)
       metadata.gid = tmd.GetGroupId();
   }
 
+  FlushFiles(file_name);
   const File::FileInfo info{file_name};
   metadata.is_file = info.IsFile();
   metadata.size = info.GetSize();
@@ -363,6 +380,7 @@ Result<DirectoryStats> HostFileSystem::GetDirectoryStats(const std::string& wii_
   std::string path(BuildFilename(wii_path));
   if (File::IsDirectory(path))
   {
+    FlushFiles(path);
     File::FSTEntry parent_dir = File::ScanDirectoryTree(path, true);
     // add one for the folder itself
     stats.used_inodes = 1 + (u32)parent_dir.size;
@@ -7,12 +7,16 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Common/CommonTypes.h"
-#include "Common/File.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Core/IOS/FS/FileSystem.h"
+#include "Core/IOS/FS/HostBackend/CachedFile.h"
 
 namespace IOS::HLE::FS
 {
@@ -20,6 +24,9 @@ namespace IOS::HLE::FS
 ///
 /// Ignores metadata like permissions, attributes and various checks and also
 /// sometimes returns wrong information because metadata is not available.
+///
+/// File contents are accessed through a write-back cache (see CachedHostFile) which is flushed
+/// by a background thread, when a file is closed and before any path-based operation.
 class HostFileSystem final : public FileSystem
 {
 public:
@@ -63,7 +70,7 @@ private:
     bool opened = false;
     Mode mode = Mode::None;
     std::string wii_path;
-    std::shared_ptr<File::IOFile> host_file;
+    std::shared_ptr<CachedHostFile> host_file;
     u32 file_offset = 0;
   };
   Handle* AssignFreeHandle();
@@ -71,11 +78,23 @@ private:
   Fd ConvertHandleToFd(const Handle* handle) const;
 
   std::string BuildFilename(const std::string& wii_path) const;
-  std::shared_ptr<File::IOFile> OpenHostFile(const std::string& host_path);
+  std::shared_ptr<CachedHostFile> OpenHostFile(const std::string& host_path);
+  void CloseHostFile(const std::string& host_path);
+
+  // Writes back cached data for the given host path (and any path under it if it is a
+  // directory) and closes matching host files that no handle refers to anymore.
+  void FlushFiles(const std::string& host_path);
+  void FlushThread();
 
   std::string m_root_path;
-  std::map<std::string, std::weak_ptr<File::IOFile>> m_open_files;
+  // Guards m_open_files. Handles themselves are only accessed from the CPU thread.
+  std::mutex m_open_files_mutex;
+  std::map<std::string, std::shared_ptr<CachedHostFile>> m_open_files;
   std::array<Handle, 16> m_handles{};
+
+  std::thread m_flush_thread;
+  Common::Event m_flush_event;
+  Common::Flag m_exiting;
 };
 
 }  // namespace IOS::HLE::FS
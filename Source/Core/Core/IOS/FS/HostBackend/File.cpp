@@ -3,17 +3,29 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <vector>
 
-#include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
+#include "Common/Thread.h"
 #include "Core/IOS/FS/HostBackend/FS.h"
 
 namespace IOS::HLE::FS
 {
-// This isn't theadsafe, but it's only called from the CPU thread.
-std::shared_ptr<File::IOFile> HostFileSystem::OpenHostFile(const std::string& host_path)
+constexpr auto FLUSH_INTERVAL = std::chrono::seconds(1);
+// Wake up the flush thread early when a file accumulates this many dirty pages.
+constexpr size_t FLUSH_THRESHOLD_PAGES = 16;
+
+static bool IsSameOrChildPath(const std::string& path, const std::string& parent)
+{
+  if (path.compare(0, parent.size(), parent) != 0)
+    return false;
+  return path.size() == parent.size() || parent.back() == '/' || path[parent.size()] == '/';
+}
+
+std::shared_ptr<CachedHostFile> HostFileSystem::OpenHostFile(const std::string& host_path)
 {
   // On the wii, all file operations are strongly ordered.
   // If a game opens the same file twice (or 8 times, looking at you PokePark Wii)
@@ -31,30 +43,92 @@ std::shared_ptr<File::IOFile> HostFileSystem::OpenHostFile(const std::string& ho
   //    - Wii System Menu (Can't access the system settings, gets stuck on blank screen)
   //    - The Beatles: Rock Band (saving doesn't work)
 
-  // Check if the file has already been opened.
-  std::shared_ptr<File::IOFile> file;
-  auto search = m_open_files.find(host_path);
-  if (search != m_open_files.end())
+  std::lock_guard<std::mutex> lk(m_open_files_mutex);
+  std::shared_ptr<CachedHostFile>& file = m_open_files[host_path];
+  // All files are opened read/write. Actual access rights will be controlled per handle by the
+  // read/write functions below
+  if (!file)
+    file = std::make_shared<CachedHostFile>(host_path);
+  return file;
+}
+
+void HostFileSystem::CloseHostFile(const std::string& host_path)
+{
+  std::lock_guard<std::mutex> lk(m_open_files_mutex);
+  // Close the file (which flushes it) if no handle refers to it anymore. If the flush thread
+  // is currently holding a reference, it will close the file itself when it is done.
+  const auto it = m_open_files.find(host_path);
+  if (it != m_open_files.end() && it->second.use_count() == 1)
+    m_open_files.erase(it);
+}
+
+void HostFileSystem::FlushFiles(const std::string& host_path)
+{
+  std::lock_guard<std::mutex> lk(m_open_files_mutex);
+  for (auto it = m_open_files.begin(); it != m_open_files.end();)
   {
-    file = search->second.lock();  // Lock a shared pointer to use.
+    if (!IsSameOrChildPath(it->first, host_path))
+    {
+      ++it;
+      continue;
+    }
+
+    // This only waits for the flush thread if it is writing back this very file.
+    CachedHostFile* file = it->second.get();
+    const bool used = std::any_of(m_handles.begin(), m_handles.end(), [file](const Handle& h) {
+      return h.host_file.get() == file;
+    });
+    if (used)
+    {
+      file->Flush();
+      ++it;
+      continue;
+    }
+
+    // Also close files that are no longer used, as the path may be about to change. The flush
+    // thread may still hold a reference, so the host file is closed explicitly.
+    it->second->Close();
+    it = m_open_files.erase(it);
   }
-  else
+}
+
+void HostFileSystem::FlushThread()
+{
+  Common::SetCurrentThreadName("IOS FS flush thread");
+
+  while (true)
   {
-    // This code will be called when all references to the shared pointer below have been removed.
-    auto deleter = [this, host_path](File::IOFile* ptr) {
-      delete ptr;                     // IOFile's deconstructor closes the file.
-      m_open_files.erase(host_path);  // erase the weak pointer from the list of open files.
-    };
-
-    // All files are opened read/write. Actual access rights will be controlled per handle by the
-    // read/write functions below
-    file = std::shared_ptr<File::IOFile>(new File::IOFile(host_path, "r+b"),
-                                         deleter);  // Use the custom deleter from above.
-
-    // Store a weak pointer to our newly opened file in the cache.
-    m_open_files[host_path] = std::weak_ptr<File::IOFile>(file);
+    m_flush_event.WaitFor(FLUSH_INTERVAL);
+    if (m_exiting.IsSet())
+      return;
+
+    std::vector<std::shared_ptr<CachedHostFile>> dirty_files;
+    {
+      std::lock_guard<std::mutex> lk(m_open_files_mutex);
+      for (const auto& entry : m_open_files)
+      {
+        if (entry.second->GetDirtyPageCount() != 0)
+          dirty_files.push_back(entry.second);
+      }
+    }
+
+    // The host I/O is done without holding m_open_files_mutex so that the CPU thread
+    // can keep opening and closing files. Each file only holds its own lock while its dirty
+    // pages are written, which the CPU thread only waits for if it needs the same file.
+    for (const auto& file : dirty_files)
+      file->Flush();
+    dirty_files.clear();
+
+    // Close files that were closed by the emulated software while we were flushing them.
+    std::lock_guard<std::mutex> lk(m_open_files_mutex);
+    for (auto it = m_open_files.begin(); it != m_open_files.end();)
+    {
+      if (it->second.use_count() == 1)
+        it = m_open_files.erase(it);
+      else
+        ++it;
+    }
   }
-  return file;
 }
 
 Result<FileHandle> HostFileSystem::OpenFile(Uid, Gid, const std::string& path, Mode mode)
@@ -85,7 +159,9 @@ ResultCode HostFileSystem::Close(Fd fd)
 
   // Let go of our pointer to the file, it will automatically close if we are the last handle
   // accessing it.
+  const std::string host_path = BuildFilename(handle->wii_path);
   *handle = Handle{};
+  CloseHostFile(host_path);
   return ResultCode::Success;
 }
 
@@ -98,22 +174,18 @@ Result<u32> HostFileSystem::ReadBytesFromFile(Fd fd, u8* ptr, u32 count)
   if ((u8(handle->mode) & u8(Mode::Read)) == 0)
     return ResultCode::AccessDenied;
 
-  const u32 file_size = static_cast<u32>(handle->host_file->GetSize());
+  const u32 file_size = handle->host_file->GetSize();
   // IOS has this check in the read request handler.
   if (count + handle->file_offset > file_size)
     count = file_size - handle->file_offset;
 
-  // File might be opened twice, need to seek before we read
-  handle->host_file->Seek(handle->file_offset, SEEK_SET);
-  const u32 actually_read = static_cast<u32>(fread(ptr, 1, count, handle->host_file->GetHandle()));
-
-  if (actually_read != count && ferror(handle->host_file->GetHandle()))
+  if (!handle->host_file->Read(handle->file_offset, ptr, count))
     return ResultCode::AccessDenied;
 
   // IOS returns the number of bytes read and adds that value to the seek position,
   // instead of adding the *requested* read length.
-  handle->file_offset += actually_read;
-  return actually_read;
+  handle->file_offset += count;
+  return count;
 }
 
 Result<u32> HostFileSystem::WriteBytesToFile(Fd fd, const u8* ptr, u32 count)
@@ -125,11 +197,12 @@ Result<u32> HostFileSystem::WriteBytesToFile(Fd fd, const u8* ptr, u32 count)
   if ((u8(handle->mode) & u8(Mode::Write)) == 0)
     return ResultCode::AccessDenied;
 
-  // File might be opened twice, need to seek before we read
-  handle->host_file->Seek(handle->file_offset, SEEK_SET);
-  if (!handle->host_file->WriteBytes(ptr, count))
+  if (!handle->host_file->Write(handle->file_offset, ptr, count))
     return ResultCode::AccessDenied;
 
+  if (handle->host_file->GetDirtyPageCount() >= FLUSH_THRESHOLD_PAGES)
+    m_flush_event.Set();
+
   handle->file_offset += count;
   return count;
 }
@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 
+#include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
@@ -12,9 +13,66 @@
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/Jit64Common/Jit64Base.h"
+#include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 
+namespace
+{
+// Operands of the most common instructions, decoded when a block is compiled rather than every
+// time the instruction is executed.
+struct ImmediateOperands
+{
+  u32* d;  // the source register for stores
+  const u32* a;
+  u32 imm;
+};
+
+struct RotateOperands
+{
+  u32* a;
+  const u32* s;
+  u32 shift;
+  u32 mask;
+};
+
+struct CompareOperands
+{
+  const u32* a;
+  const u32* b;  // unused when comparing with an immediate
+  u32 imm;
+  u32 crf;
+};
+
+struct BranchOperands
+{
+  u32 address;
+  u32 target;
+  u32 downcount;
+  u8 bo;
+  u8 bi;
+  bool lk;
+};
+
+struct CompareBranchOperands
+{
+  CompareOperands compare;
+  BranchOperands branch;
+};
+
+union Operands
+{
+  ImmediateOperands immediate;
+  RotateOperands rotate;
+  CompareOperands compare;
+  BranchOperands branch;
+  CompareBranchOperands compare_branch;
+};
+
+// Returns true if the block has ended.
+using PredecodedCallback = bool (*)(const Operands&);
+}  // Anonymous namespace
+
 struct CachedInterpreter::Instruction
 {
   using CommonCallback = void (*)(UGeckoInstruction);
@@ -31,23 +89,36 @@ struct CachedInterpreter::Instruction
   {
   }
 
+  Instruction(const PredecodedCallback c, u32 operands_index)
+      : predecoded_callback(c), data(operands_index), type(Type::Predecoded)
+  {
+  }
+
   enum class Type
   {
     Abort,
     Common,
     Conditional,
+    Predecoded,
   };
 
   union
   {
     const CommonCallback common_callback;
     const ConditionalCallback conditional_callback;
+    const PredecodedCallback predecoded_callback;
   };
 
+  // For predecoded instructions, this is the index of their operands in m_operands.
   u32 data = 0;
   Type type = Type::Abort;
 };
 
+struct CachedInterpreter::PredecodedOperands
+{
+  Operands operands;
+};
+
 CachedInterpreter::CachedInterpreter() = default;
 
 CachedInterpreter::~CachedInterpreter() = default;
@@ -100,6 +171,11 @@ void CachedInterpreter::ExecuteOneBlock()
         return;
       break;
 
+    case Instruction::Type::Predecoded:
+      if (code->predecoded_callback(m_operands[code->data].operands))
+        return;
+      break;
+
     default:
       ERROR_LOG(POWERPC, "Unknown CachedInterpreter Instruction: %d", static_cast<int>(code->type));
       break;
@@ -181,6 +257,132 @@ static bool CheckBreakpoint(u32 data)
   return false;
 }
 
+// Optimizations that can't handle a call leave NPC pointing at the original function, which is
+// then executed as usual.
+static bool EndBlockIfReplaced(u32 data)
+{
+  if (NPC != PC)
+  {
+    PC = NPC;
+    PowerPC::ppcState.downcount -= data;
+    return true;
+  }
+  return false;
+}
+
+static bool LoadImmediate(const Operands& operands)
+{
+  *operands.immediate.d = operands.immediate.imm;
+  return false;
+}
+
+static bool AddImmediate(const Operands& operands)
+{
+  *operands.immediate.d = *operands.immediate.a + operands.immediate.imm;
+  return false;
+}
+
+static bool OrImmediate(const Operands& operands)
+{
+  *operands.immediate.d = *operands.immediate.a | operands.immediate.imm;
+  return false;
+}
+
+static bool LoadWord(const Operands& operands)
+{
+  const u32 value = PowerPC::Read_U32(*operands.immediate.a + operands.immediate.imm);
+  if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
+    *operands.immediate.d = value;
+  return false;
+}
+
+static bool StoreWord(const Operands& operands)
+{
+  PowerPC::Write_U32(*operands.immediate.d, *operands.immediate.a + operands.immediate.imm);
+  return false;
+}
+
+static bool RotateAndMask(const Operands& operands)
+{
+  const RotateOperands& rotate = operands.rotate;
+  *rotate.a = Common::RotateLeft(*rotate.s, rotate.shift) & rotate.mask;
+  return false;
+}
+
+// Returns the new value of the CR field.
+template <bool is_signed, bool immediate>
+static u32 DoCompare(const CompareOperands& compare)
+{
+  const u32 a = *compare.a;
+  const u32 b = immediate ? compare.imm : *compare.b;
+  u32 f;
+  if (is_signed ? static_cast<s32>(a) < static_cast<s32>(b) : a < b)
+    f = 0x8;
+  else if (is_signed ? static_cast<s32>(a) > static_cast<s32>(b) : a > b)
+    f = 0x4;
+  else
+    f = 0x2;
+
+  if (PowerPC::GetXER_SO())
+    f |= 0x1;
+
+  PowerPC::SetCRField(compare.crf, f);
+  return f;
+}
+
+template <bool is_signed, bool immediate>
+static bool Compare(const Operands& operands)
+{
+  DoCompare<is_signed, immediate>(operands.compare);
+  return false;
+}
+
+// Conditional branches always end the block, so this also does the work of EndBlock.
+static void DoBranch(const BranchOperands& branch, bool condition)
+{
+  if ((branch.bo & BO_DONT_DECREMENT_FLAG) == 0)
+    CTR--;
+
+  const bool true_false = (branch.bo >> 3) & 1;
+  const bool only_counter_check = (branch.bo >> 4) & 1;
+  const bool only_condition_check = (branch.bo >> 2) & 1;
+  const u32 ctr_check = ((CTR != 0) ^ (branch.bo >> 1)) & 1;
+  const bool counter = only_condition_check || ctr_check;
+
+  if (counter && (only_counter_check || condition == true_false))
+  {
+    if (branch.lk)
+      LR = branch.address + 4;
+    PC = branch.target;
+  }
+  else
+  {
+    PC = branch.address + 4;
+  }
+
+  NPC = PC;
+  PowerPC::ppcState.downcount -= branch.downcount;
+}
+
+static bool Branch(const Operands& operands)
+{
+  DoBranch(operands.branch, PowerPC::GetCRBit(operands.branch.bi) != 0);
+  return true;
+}
+
+// The branch can use the result of the comparison directly if it tests the same CR field.
+template <bool is_signed, bool immediate>
+static bool CompareAndBranch(const Operands& operands)
+{
+  const CompareBranchOperands& fused = operands.compare_branch;
+  const u32 f = DoCompare<is_signed, immediate>(fused.compare);
+  const u32 bi = fused.branch.bi;
+  const bool condition =
+      (bi >> 2) == fused.compare.crf ? (f >> (3 - (bi & 3))) & 1 : PowerPC::GetCRBit(bi) != 0;
+  DoBranch(fused.branch, condition);
+  return true;
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 function, HLE::HookType type) {
@@ -190,12 +392,165 @@ bool CachedInterpreter::HandleFunctionHooking(u32 address)
     if (type != HLE::HookType::Replace)
       return false;
 
+    if (HLE::GetFunctionFlagsByIndex(function) == HLE::HookFlag::Optimization)
+    {
+      m_code.emplace_back(EndBlockIfReplaced, js.downcountAmount);
+      return false;
+    }
+
     m_code.emplace_back(EndBlock, js.downcountAmount);
     m_code.emplace_back();
     return true;
   });
 }
 
+static ImmediateOperands MakeImmediateOperands(u32 d, u32 a, u32 imm)
+{
+  return {&rGPR[d], &rGPR[a], imm};
+}
+
+static BranchOperands MakeBranchOperands(const PPCAnalyst::CodeOp& op, u32 downcount)
+{
+  const UGeckoInstruction inst = op.inst;
+  const u32 target = SignExt16(inst.BD << 2) + (inst.AA ? 0 : op.address);
+  return {op.address, target, downcount, static_cast<u8>(inst.BO), static_cast<u8>(inst.BI),
+          inst.LK != 0};
+}
+
+// The interpreter detects idle loops at this particular branch.
+static bool IsPredecodableBranch(const PPCAnalyst::CodeOp& op)
+{
+  return op.inst.OPCD == 16 && op.inst.hex != 0x4182fff8;
+}
+
+static PredecodedCallback GetCompareCallback(UGeckoInstruction inst, bool fused)
+{
+  // cmpli, cmpi, cmp and cmpl
+  if (inst.OPCD == 10)
+    return fused ? CompareAndBranch<false, true> : Compare<false, true>;
+  if (inst.OPCD == 11)
+    return fused ? CompareAndBranch<true, true> : Compare<true, true>;
+  if (inst.OPCD == 31 && inst.SUBOP10 == 0)
+    return fused ? CompareAndBranch<true, false> : Compare<true, false>;
+  if (inst.OPCD == 31 && inst.SUBOP10 == 32)
+    return fused ? CompareAndBranch<false, false> : Compare<false, false>;
+  return nullptr;
+}
+
+// Emits a handler with pre-decoded operands for the instruction at the given index, possibly
+// fused with the following instruction. Returns the number of instructions that were handled,
+// or 0 if the instruction has to be executed by the interpreter as usual.
+u32 CachedInterpreter::EmitPredecodedInstruction(u32 index)
+{
+  const PPCAnalyst::CodeOp& op = m_code_buffer[index];
+  const UGeckoInstruction inst = op.inst;
+
+  const PPCAnalyst::CodeOp* next = nullptr;
+  if (index + 1 < code_block.m_num_instructions)
+  {
+    next = &m_code_buffer[index + 1];
+    const bool breakpoint = SConfig::GetInstance().bEnableDebugging &&
+                            PowerPC::breakpoints.IsAddressBreakPoint(next->address);
+    if (next->skip || breakpoint || HLE::GetFirstFunctionIndex(next->address) != 0)
+      next = nullptr;
+  }
+
+  const auto emit = [this](PredecodedCallback callback, const Operands& operands) {
+    m_code.emplace_back(callback, static_cast<u32>(m_operands.size()));
+    m_operands.push_back({operands});
+  };
+
+  Operands operands;
+  switch (inst.OPCD)
+  {
+  case 14:  // addi
+  case 15:  // addis
+  {
+    u32 imm = inst.OPCD == 15 ? static_cast<u32>(inst.SIMM_16) << 16 : inst.SIMM_16;
+    if (inst.RA != 0)
+    {
+      operands.immediate = MakeImmediateOperands(inst.RD, inst.RA, imm);
+      emit(AddImmediate, operands);
+      return 1;
+    }
+
+    // lis followed by addi or ori completing the constant
+    u32 handled = 1;
+    if (inst.OPCD == 15 && next && (next->inst.OPCD == 14 || next->inst.OPCD == 24))
+    {
+      const UGeckoInstruction low = next->inst;
+      const bool is_addi = low.OPCD == 14;
+      const u32 src = is_addi ? low.RA : low.RS;
+      const u32 dest = is_addi ? low.RD : low.RA;
+      if (src == inst.RD && dest == inst.RD)
+      {
+        imm = is_addi ? imm + low.SIMM_16 : imm | low.UIMM;
+        js.downcountAmount += next->opinfo->numCycles;
+        handled = 2;
+      }
+    }
+    operands.immediate = MakeImmediateOperands(inst.RD, 0, imm);
+    emit(LoadImmediate, operands);
+    return handled;
+  }
+
+  case 24:  // ori
+    operands.immediate = MakeImmediateOperands(inst.RA, inst.RS, inst.UIMM);
+    emit(OrImmediate, operands);
+    return 1;
+
+  case 32:  // lwz
+  case 36:  // stw
+  {
+    if (inst.RA == 0)
+      return 0;
+
+    const bool memcheck = jo.memcheck;
+    if (memcheck)
+      m_code.emplace_back(WritePC, op.address);
+    operands.immediate = MakeImmediateOperands(inst.RD, inst.RA, inst.SIMM_16);
+    emit(inst.OPCD == 32 ? LoadWord : StoreWord, operands);
+    if (memcheck)
+      m_code.emplace_back(CheckDSI, js.downcountAmount);
+    return 1;
+  }
+
+  case 21:  // rlwinmx
+    if (inst.Rc)
+      return 0;
+    operands.rotate = {&rGPR[inst.RA], &rGPR[inst.RS], inst.SH, MakeRotationMask(inst.MB, inst.ME)};
+    emit(RotateAndMask, operands);
+    return 1;
+
+  case 16:  // bcx
+    if (!IsPredecodableBranch(op))
+      return 0;
+    operands.branch = MakeBranchOperands(op, js.downcountAmount);
+    emit(Branch, operands);
+    return 1;
+  }
+
+  const bool fused = next && IsPredecodableBranch(*next);
+  const auto compare_callback = GetCompareCallback(inst, fused);
+  if (!compare_callback)
+    return 0;
+
+  const CompareOperands compare = {&rGPR[inst.RA], &rGPR[inst.RB],
+                                   inst.OPCD == 10 ? inst.UIMM : static_cast<u32>(inst.SIMM_16),
+                                   inst.CRFD};
+  if (!fused)
+  {
+    operands.compare = compare;
+    emit(compare_callback, operands);
+    return 1;
+  }
+
+  js.downcountAmount += next->opinfo->numCycles;
+  operands.compare_branch = {compare, MakeBranchOperands(*next, js.downcountAmount)};
+  emit(compare_callback, operands);
+  return 2;
+}
+
 void CachedInterpreter::Jit(u32 address)
 {
   if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 ||
@@ -256,6 +611,13 @@ void CachedInterpreter::Jit(u32 address)
         js.firstFPInstructionFound = true;
       }
 
+      const u32 predecoded = EmitPredecodedInstruction(i);
+      if (predecoded != 0)
+      {
+        i += predecoded - 1;
+        continue;
+      }
+
       if (endblock || memcheck)
         m_code.emplace_back(WritePC, op.address);
       m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
@@ -281,6 +643,7 @@ void CachedInterpreter::Jit(u32 address)
 void CachedInterpreter::ClearCache()
 {
   m_code.clear();
+  m_operands.clear();
   m_block_cache.Clear();
   UpdateMemoryOptions();
 }
@@ -34,12 +34,17 @@ public:
 
 private:
   struct Instruction;
+  struct PredecodedOperands;
 
   u8* GetCodePtr();
   void ExecuteOneBlock();
 
   bool HandleFunctionHooking(u32 address);
+  u32 EmitPredecodedInstruction(u32 index);
 
   BlockCache m_block_cache{*this};
   std::vector<Instruction> m_code;
+  // Only the instructions with pre-decoded operands need them, so they are kept out of line and
+  // referred to by index.
+  std::vector<PredecodedOperands> m_operands;
 };
@@ -102,9 +102,13 @@ static void Trace(UGeckoInstruction& inst)
 
 bool Interpreter::HandleFunctionHooking(u32 address)
 {
-  return HLE::ReplaceFunctionIfPossible(address, [](u32 function, HLE::HookType type) {
+  return HLE::ReplaceFunctionIfPossible(address, [address](u32 function, HLE::HookType type) {
     HLEFunction(function);
-    return type != HLE::HookType::Start;
+    if (type == HLE::HookType::Start)
+      return false;
+
+    // Optimizations that can't handle a call leave NPC pointing at the original function.
+    return HLE::GetFunctionFlagsByIndex(function) != HLE::HookFlag::Optimization || NPC != address;
   });
 }
 
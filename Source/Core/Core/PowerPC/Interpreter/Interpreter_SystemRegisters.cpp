@@ -192,6 +192,7 @@ static void SetSR(u32 index, u32 value)
   DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", PowerPC::ppcState.pc, index,
             value);
   PowerPC::ppcState.sr[index] = value;
+  PowerPC::SRUpdated(index);
 }
 
 void Interpreter::mtsr(UGeckoInstruction inst)
@@ -37,22 +37,7 @@ OpArg FPURegCache::GetDefaultLocation(preg_t preg) const
   return PPCSTATE(ps[preg][0]);
 }
 
-BitSet32 FPURegCache::GetRegUtilization() const
+const PPCAnalyst::BlockRegStats& FPURegCache::GetBlockRegStats() const
 {
-  return m_jit.js.op->gprInReg;
-}
-
-BitSet32 FPURegCache::CountRegsIn(preg_t preg, u32 lookahead) const
-{
-  BitSet32 regs_used;
-
-  for (u32 i = 1; i < lookahead; i++)
-  {
-    BitSet32 regs_in = m_jit.js.op[i].fregsIn;
-    regs_used |= regs_in;
-    if (regs_in[preg])
-      return regs_used;
-  }
-
-  return regs_used;
+  return m_jit.js.fpa;
 }
@@ -18,6 +18,5 @@ protected:
   void StoreRegister(preg_t preg, const Gen::OpArg& newLoc) override;
   void LoadRegister(preg_t preg, Gen::X64Reg newLoc) override;
   const Gen::X64Reg* GetAllocationOrder(size_t* count) const override;
-  BitSet32 GetRegUtilization() const override;
-  BitSet32 CountRegsIn(preg_t preg, u32 lookahead) const override;
+  const PPCAnalyst::BlockRegStats& GetBlockRegStats() const override;
 };
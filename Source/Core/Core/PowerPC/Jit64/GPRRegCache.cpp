@@ -54,22 +54,7 @@ void GPRRegCache::SetImmediate32(preg_t preg, u32 imm_value, bool dirty)
   m_regs[preg].SetToImm32(imm_value, dirty);
 }
 
-BitSet32 GPRRegCache::GetRegUtilization() const
+const PPCAnalyst::BlockRegStats& GPRRegCache::GetBlockRegStats() const
 {
-  return m_jit.js.op->gprInReg;
-}
-
-BitSet32 GPRRegCache::CountRegsIn(preg_t preg, u32 lookahead) const
-{
-  BitSet32 regs_used;
-
-  for (u32 i = 1; i < lookahead; i++)
-  {
-    BitSet32 regs_in = m_jit.js.op[i].regsIn;
-    regs_used |= regs_in;
-    if (regs_in[preg])
-      return regs_used;
-  }
-
-  return regs_used;
+  return m_jit.js.gpa;
 }
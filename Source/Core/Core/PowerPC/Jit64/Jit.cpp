@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <cstring>
 #include <map>
 #include <string>
 
@@ -13,12 +14,15 @@
 #endif
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/File.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/PerformanceCounter.h"
 #include "Common/StringUtil.h"
 #include "Common/x64ABI.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
@@ -146,6 +150,20 @@ enum
   GUARD_OFFSET = STACK_SIZE - SAFE_STACK_SIZE - GUARD_SIZE,
 };
 
+// Number of times a block of the baseline tier is executed before it gets recompiled with all
+// optimizations.
+constexpr u32 HOT_BLOCK_THRESHOLD = 256;
+
+// Instruction addresses are word aligned, so this never matches a branch target. It must not fit
+// in a sign extended imm8 either, as the compare would then be emitted without the 32-bit
+// immediate that UpdateInlineCache patches.
+constexpr u32 EMPTY_INLINE_CACHE = 0x80000001;
+static_assert(static_cast<s32>(EMPTY_INLINE_CACHE) != static_cast<s8>(EMPTY_INLINE_CACHE),
+              "The inline cache compare needs an imm32 encoding");
+// Number of misses after which an inline cache stops being updated, as the branch is likely to
+// have more than one frequent target.
+constexpr u32 INLINE_CACHE_MISS_LIMIT = 16;
+
 Jit64::Jit64() = default;
 
 Jit64::~Jit64() = default;
@@ -243,6 +261,9 @@ void Jit64::Init()
   m_enable_blr_optimization = jo.enableBlocklink && SConfig::GetInstance().bFastmem &&
                               !SConfig::GetInstance().bEnableDebugging;
   m_cleanup_after_stackfault = false;
+  m_enable_tiering = Config::Get(Config::MAIN_JIT_TIERED_COMPILATION) &&
+                     !SConfig::GetInstance().bEnableDebugging;
+  analyzer.SetBranchProfile(&js.branchProfile);
 
   m_stack = nullptr;
   if (m_enable_blr_optimization)
@@ -464,7 +485,15 @@ void Jit64::WriteExitDestInRSCRATCH(bool bl, u32 after)
   if (!m_enable_blr_optimization)
     bl = false;
   MOV(32, PPCSTATE(pc), R(RSCRATCH));
-  Cleanup();
+  const bool disturbed = Cleanup();
+
+  if (jo.enableBlocklink)
+  {
+    if (disturbed)
+      MOV(32, R(RSCRATCH), PPCSTATE(pc));
+    WriteInlineCachedExit(bl, after);
+    return;
+  }
 
   if (bl)
   {
@@ -485,6 +514,108 @@ void Jit64::WriteExitDestInRSCRATCH(bool bl, u32 after)
   }
 }
 
+// Emits an indirect branch that is linked directly to the block of the last target it has seen.
+// On a miss, UpdateInlineCache replaces the target and relinks the exit.
+void Jit64::WriteInlineCachedExit(bool bl, u32 after)
+{
+  JitBlock* b = js.curBlock;
+  JitBlock::InlineCache cache;
+  cache.link_index = b->linkData.size();
+  cache.misses = 0;
+
+  CMP(32, R(RSCRATCH), Imm32(EMPTY_INLINE_CACHE));
+  cache.target_immediate = GetWritableCodePtr() - sizeof(u32);
+  FixupBranch miss = J_CC(CC_NE, true);
+
+  if (jo.profile_blocks)
+  {
+    MOV(64, R(RSCRATCH2), ImmPtr(&b->profile_data.inlineCacheHits));
+    ADD(64, MatR(RSCRATCH2), Imm8(1));
+  }
+  if (bl)
+  {
+    MOV(32, R(RSCRATCH2), Imm32(after));
+    PUSH(RSCRATCH2);
+  }
+  SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+
+  JitBlock::LinkData linkData;
+  linkData.exitAddress = EMPTY_INLINE_CACHE;
+  linkData.linkStatus = false;
+  linkData.exitPtrs = GetWritableCodePtr();
+  if (bl)
+    CALL(asm_routines.dispatcher);
+  else
+    JMP(asm_routines.dispatcher, true);
+  b->linkData.push_back(linkData);
+
+  const u8* continuation = GetCodePtr();
+  if (bl)
+  {
+    POP(RSCRATCH);
+    JustWriteExit(after, false, 0);
+  }
+
+  // Exits of HLE hooks are already emitted in far code, and switching to it doesn't nest, so the
+  // miss handling simply follows the exit there.
+  const bool in_far_code = m_far_code.IsInSpace(GetCodePtr());
+  if (!in_far_code)
+    SwitchToFarCode();
+  SetJumpTarget(miss);
+  if (jo.profile_blocks)
+  {
+    MOV(64, R(RSCRATCH2), ImmPtr(&b->profile_data.inlineCacheMisses));
+    ADD(64, MatR(RSCRATCH2), Imm8(1));
+  }
+  // Replaced by a jump to the dispatch below once the cache has missed too often.
+  cache.update_jump = GetWritableCodePtr();
+  NOP(5);
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  ABI_CallFunctionCCP(UpdateInlineCache, js.blockStart, static_cast<u32>(b->inline_caches.size()),
+                      this);
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  cache.dispatch = GetCodePtr();
+  if (bl)
+  {
+    MOV(32, R(RSCRATCH2), Imm32(after));
+    PUSH(RSCRATCH2);
+  }
+  SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+  if (bl)
+  {
+    CALL(asm_routines.dispatcher);
+    JMP(continuation, true);
+  }
+  else
+  {
+    JMP(asm_routines.dispatcher, true);
+  }
+  if (!in_far_code)
+    SwitchToNearCode();
+
+  b->inline_caches.push_back(cache);
+}
+
+void Jit64::UpdateInlineCache(u32 block_start, u32 cache_index, Jit64* jit)
+{
+  // The block may have been invalidated while it was running, in which case its code must not
+  // be touched anymore.
+  JitBlock* block = jit->blocks.GetBlockFromStartAddress(block_start, MSR.Hex);
+  if (!block || cache_index >= block->inline_caches.size())
+    return;
+
+  JitBlock::InlineCache& cache = block->inline_caches[cache_index];
+  if (++cache.misses > INLINE_CACHE_MISS_LIMIT)
+  {
+    Gen::XEmitter emit(cache.update_jump);
+    emit.JMP(cache.dispatch, true);
+    return;
+  }
+
+  std::memcpy(cache.target_immediate, &PC, sizeof(u32));
+  jit->blocks.RetargetBlockExit(*block, cache.link_index, PC);
+}
+
 void Jit64::WriteBLRExit()
 {
   if (!m_enable_blr_optimization)
@@ -601,6 +732,16 @@ void Jit64::Jit(u32 em_address)
 
   std::size_t block_size = m_code_buffer.size();
 
+  const bool baseline_tier =
+      m_enable_tiering && js.hotBlockAddresses.find(em_address) == js.hotBlockAddresses.end();
+  if (m_enable_tiering)
+  {
+    if (baseline_tier)
+      DisableOptimization();
+    else
+      EnableOptimization();
+  }
+
   if (SConfig::GetInstance().bEnableDebugging)
   {
     // We can link blocks as long as we are not single stepping and there are no breakpoints here
@@ -621,6 +762,7 @@ void Jit64::Jit(u32 em_address)
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+        analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_HLE_CALL_INLINE);
       }
       Trace();
     }
@@ -642,6 +784,7 @@ void Jit64::Jit(u32 em_address)
   }
 
   JitBlock* b = blocks.AllocateBlock(em_address);
+  b->tier_up_countdown = baseline_tier ? HOT_BLOCK_THRESHOLD : 0;
   DoJit(em_address, b, nextPC);
   blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
 }
@@ -692,8 +835,31 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+#else
+  // Linked blocks don't go through the dispatcher, which is what usually updates PC
+  if (Profiler::IsSamplingEnabled())
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
 #endif
 
+  // Blocks of the baseline tier count their executions, and get recompiled with all
+  // optimizations once they are hot.
+  if (b->tier_up_countdown != 0)
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(&b->tier_up_countdown));
+    SUB(32, MatR(RSCRATCH), Imm8(1));
+    FixupBranch hot = J_CC(CC_Z, true);
+
+    SwitchToFarCode();
+    SetJumpTarget(hot);
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionC(JitInterface::CompileExceptionCheck,
+                      static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcher_no_check, true);
+    SwitchToNearCode();
+  }
+
   // Start up the register allocators
   // They use the information in gpa/fpa to preload commonly used registers.
   gpr.Start();
@@ -954,6 +1120,7 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
   b->codeSize = (u32)(GetCodePtr() - start);
   b->originalSize = code_block.m_num_instructions;
+  b->registerSpills = gpr.GetSpillCount() + fpr.GetSpillCount();
 
 #ifdef JIT_LOG_GENERATED_CODE
   LogGeneratedX86(code_block.m_num_instructions, m_code_buffer, start, b);
@@ -994,6 +1161,27 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_HLE_CALL_INLINE);
+  if (m_enable_tiering)
+  {
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_AGGRESSIVE_BRANCH_FOLLOW);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_TRACE_FORMATION);
+  }
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_SKIP_USAGE_ANALYSIS);
+}
+
+// Used for the baseline tier, which is meant to compile as fast as possible.
+void Jit64::DisableOptimization()
+{
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_HLE_CALL_INLINE);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_AGGRESSIVE_BRANCH_FOLLOW);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_TRACE_FORMATION);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_SKIP_USAGE_ANALYSIS);
 }
 
 void Jit64::IntializeSpeculativeConstants()
@@ -1040,6 +1228,23 @@ bool Jit64::HandleFunctionHooking(u32 address)
       return false;
 
     MOV(32, R(RSCRATCH), PPCSTATE(npc));
+
+    // Optimizations that can't handle a call leave NPC pointing at the original function, which
+    // is then compiled as usual.
+    if (HLE::GetFunctionFlagsByIndex(function) == HLE::HookFlag::Optimization)
+    {
+      CMP(32, R(RSCRATCH), Imm32(address));
+      FixupBranch handled = J_CC(CC_NE, true);
+      SwitchToFarCode();
+      SetJumpTarget(handled);
+      const u32 downcount_amount = js.downcountAmount;
+      js.downcountAmount += js.st.numCycles;
+      WriteExitDestInRSCRATCH();
+      js.downcountAmount = downcount_amount;
+      SwitchToNearCode();
+      return false;
+    }
+
     js.downcountAmount += js.st.numCycles;
     WriteExitDestInRSCRATCH();
     return true;
@@ -47,6 +47,7 @@ public:
   bool HandleStackFault() override;
 
   void EnableOptimization();
+  void DisableOptimization();
   void EnableBlockLink();
 
   // Jit!
@@ -76,6 +77,8 @@ public:
   void WriteExit(u32 destination, bool bl = false, u32 after = 0);
   void JustWriteExit(u32 destination, bool bl, u32 after);
   void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
+  void WriteInlineCachedExit(bool bl, u32 after);
+  static void UpdateInlineCache(u32 block_start, u32 cache_index, Jit64* jit);
   void WriteBLRExit();
   void WriteExceptionExit();
   void WriteExternalExceptionExit();
@@ -247,6 +250,9 @@ private:
   Jit64AsmRoutineManager asm_routines{*this};
 
   bool m_enable_blr_optimization;
+  // Compile blocks with minimal analysis first, and only recompile them with all optimizations
+  // once they turn out to be hot.
+  bool m_enable_tiering;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
 };
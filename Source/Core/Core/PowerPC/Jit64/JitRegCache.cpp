@@ -6,8 +6,6 @@
 
 #include <algorithm>
 #include <cinttypes>
-#include <cmath>
-#include <limits>
 
 #include "Common/Assert.h"
 #include "Common/BitSet.h"
@@ -26,6 +24,7 @@ RegCache::RegCache(Jit64& jit) : m_jit{jit}
 
 void RegCache::Start()
 {
+  m_spill_count = 0;
   m_xregs.fill({});
   for (size_t i = 0; i < m_regs.size(); i++)
   {
@@ -239,9 +238,13 @@ X64Reg RegCache::GetFreeXReg()
     }
   }
 
-  // Okay, not found; run the register allocator heuristic and figure out which register we should
-  // clobber.
-  float min_score = std::numeric_limits<float>::max();
+  // Okay, not found; we have to spill a register. As in linear scan allocation, pick the one
+  // whose next use is furthest away, using the live ranges of the whole block. If several
+  // registers are equally good, prefer one that doesn't need to be written back.
+  const PPCAnalyst::BlockRegStats& stats = GetBlockRegStats();
+  const u32 current = static_cast<u32>(m_jit.js.instructionNumber);
+  u32 best_next_read = 0;
+  bool best_dirty = true;
   X64Reg best_xreg = INVALID_REG;
   size_t best_preg = 0;
   for (size_t i = 0; i < aCount; i++)
@@ -250,10 +253,14 @@ X64Reg RegCache::GetFreeXReg()
     preg_t preg = m_xregs[xreg].Contents();
     if (m_xregs[xreg].IsLocked() || m_regs[preg].IsLocked())
       continue;
-    float score = ScoreRegister(xreg);
-    if (score < min_score)
+
+    const u32 next_read = stats.GetNextRead(static_cast<int>(preg), current);
+    const bool dirty = m_xregs[xreg].IsDirty();
+    if (best_xreg == INVALID_REG || next_read > best_next_read ||
+        (next_read == best_next_read && best_dirty && !dirty))
     {
-      min_score = score;
+      best_next_read = next_read;
+      best_dirty = dirty;
       best_xreg = xreg;
       best_preg = preg;
     }
@@ -262,6 +269,7 @@ X64Reg RegCache::GetFreeXReg()
   if (best_xreg != INVALID_REG)
   {
     StoreFromRegister(best_preg);
+    m_spill_count++;
     return best_xreg;
   }
 
@@ -290,35 +298,3 @@ void RegCache::FlushX(X64Reg reg)
     StoreFromRegister(m_xregs[reg].Contents());
   }
 }
-
-// Estimate roughly how bad it would be to de-allocate this register. Higher score
-// means more bad.
-float RegCache::ScoreRegister(X64Reg xreg) const
-{
-  preg_t preg = m_xregs[xreg].Contents();
-  float score = 0;
-
-  // If it's not dirty, we don't need a store to write it back to the register file, so
-  // bias a bit against dirty registers. Testing shows that a bias of 2 seems roughly
-  // right: 3 causes too many extra clobbers, while 1 saves very few clobbers relative
-  // to the number of extra stores it causes.
-  if (m_xregs[xreg].IsDirty())
-    score += 2;
-
-  // If the register isn't actually needed in a physical register for a later instruction,
-  // writing it back to the register file isn't quite as bad.
-  if (GetRegUtilization()[preg])
-  {
-    // Don't look too far ahead; we don't want to have quadratic compilation times for
-    // enormous block sizes!
-    // This actually improves register allocation a tiny bit; I'm not sure why.
-    u32 lookahead = std::min(m_jit.js.instructionsLeft, 64);
-    // Count how many other registers are going to be used before we need this one again.
-    u32 regs_in_count = CountRegsIn(preg, lookahead).Count();
-    // Totally ad-hoc heuristic to bias based on how many other registers we'll need
-    // before this one gets used again.
-    score += 1 + 2 * (5 - log2f(1 + (float)regs_in_count));
-  }
-
-  return score;
-}
@@ -210,21 +210,22 @@ public:
   Gen::X64Reg GetFreeXReg();
   int NumFreeRegisters() const;
 
+  // The number of times a register had to be evicted to make room for another one since Start().
+  u32 GetSpillCount() const { return m_spill_count; }
+
 protected:
   virtual void StoreRegister(preg_t preg, const Gen::OpArg& new_loc) = 0;
   virtual void LoadRegister(preg_t preg, Gen::X64Reg new_loc) = 0;
 
   virtual const Gen::X64Reg* GetAllocationOrder(size_t* count) const = 0;
 
-  virtual BitSet32 GetRegUtilization() const = 0;
-  virtual BitSet32 CountRegsIn(preg_t preg, u32 lookahead) const = 0;
+  virtual const PPCAnalyst::BlockRegStats& GetBlockRegStats() const = 0;
 
   void FlushX(Gen::X64Reg reg);
 
-  float ScoreRegister(Gen::X64Reg xreg) const;
-
   Jit64& m_jit;
   std::array<PPCCachedReg, 32> m_regs;
   std::array<X64CachedReg, NUM_XREGS> m_xregs;
   Gen::XEmitter* m_emitter = nullptr;
+  u32 m_spill_count = 0;
 };
@@ -6,6 +6,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/CoreTiming.h"
+#include "Core/HLE/HLE.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/Jit64/Jit.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
@@ -64,11 +65,37 @@ void Jit64::bx(UGeckoInstruction inst)
   INSTRUCTION_START
   JITDISABLE(bJITBranchOff);
 
+  u32 destination;
+  if (inst.AA)
+    destination = SignExt26(inst.LI << 2);
+  else
+    destination = js.compilerPC + SignExt26(inst.LI << 2);
+
   // We must always process the following sentence
   // even if the blocks are merged by PPCAnalyst::Flatten().
   if (inst.LK)
     MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
+  // The analyzer decided to replace the call by a direct call to the HLE function,
+  // which returns to the next instruction.
+  if (js.op->hleFunction != 0)
+  {
+    gpr.Flush();
+    fpr.Flush();
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionCC(HLE::Execute, destination, js.op->hleFunction);
+    ABI_PopRegistersAndAdjustStack({}, 0);
+
+    // If the HLE function couldn't handle the call, NPC still points at the callee.
+    CMP(32, PPCSTATE(npc), Imm32(destination));
+    FixupBranch declined = J_CC(CC_E, true);
+    SwitchToFarCode();
+    SetJumpTarget(declined);
+    WriteExit(destination, true, js.compilerPC + 4);
+    SwitchToNearCode();
+    return;
+  }
+
   // If this is not the last instruction of a block,
   // we will skip the rest process.
   // Because PPCAnalyst::Flatten() merged the blocks.
@@ -87,11 +114,6 @@ void Jit64::bx(UGeckoInstruction inst)
   gpr.Flush();
   fpr.Flush();
 
-  u32 destination;
-  if (inst.AA)
-    destination = SignExt26(inst.LI << 2);
-  else
-    destination = js.compilerPC + SignExt26(inst.LI << 2);
 #ifdef ACID_TEST
   if (inst.LK)
     AND(32, PPCSTATE(cr), Imm32(~(0xFF000000)));
@@ -138,6 +160,33 @@ void Jit64::bcx(UGeckoInstruction inst)
   if (inst.LK)
     MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
+  // The analyzer continued the block at the branch target, as the branch is usually taken.
+  // So leave the block if it isn't taken instead.
+  if (js.op->branchIsFollowed)
+  {
+    SwitchToFarCode();
+    if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+      SetJumpTarget(pConditionDontBranch);
+    if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+      SetJumpTarget(pCTRDontBranch);
+    gpr.Flush(RegCache::FlushMode::MaintainState);
+    fpr.Flush(RegCache::FlushMode::MaintainState);
+    WriteExit(js.compilerPC + 4);
+    SwitchToNearCode();
+    return;
+  }
+
+  // Blocks of the baseline tier record which way conditional branches go, for trace formation
+  // in the optimizing tier.
+  const bool conditional =
+      (inst.BO & BO_DONT_DECREMENT_FLAG) == 0 || (inst.BO & BO_DONT_CHECK_CONDITION) == 0;
+  PPCAnalyst::BranchProfile::Counters* counters = nullptr;
+  if (conditional && m_enable_tiering &&
+      !analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_TRACE_FORMATION))
+  {
+    counters = &js.branchProfile.GetCounters(js.compilerPC);
+  }
+
   // If this is not the last instruction of a block
   // and an unconditional branch, we will skip the rest process.
   // Because PPCAnalyst::Flatten() merged the blocks.
@@ -162,6 +211,11 @@ void Jit64::bcx(UGeckoInstruction inst)
 
   gpr.Flush(RegCache::FlushMode::MaintainState);
   fpr.Flush(RegCache::FlushMode::MaintainState);
+  if (counters)
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(&counters->taken));
+    ADD(32, MatR(RSCRATCH), Imm8(1));
+  }
   WriteExit(destination, inst.LK, js.compilerPC + 4);
 
   if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
@@ -169,6 +223,12 @@ void Jit64::bcx(UGeckoInstruction inst)
   if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
     SetJumpTarget(pCTRDontBranch);
 
+  if (counters)
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(&counters->not_taken));
+    ADD(32, MatR(RSCRATCH), Imm8(1));
+  }
+
   if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
@@ -628,6 +628,13 @@ void JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     BeginTimeProfile(b);
   }
 
+  // Linked blocks don't go through the dispatcher, which is what usually updates PC
+  if (Profiler::IsSamplingEnabled())
+  {
+    MOVI2R(DISPATCHER_PC, js.blockStart);
+    STR(INDEX_UNSIGNED, DISPATCHER_PC, PPC_REG, PPCSTATE_OFF(pc));
+  }
+
   if (code_block.m_gqr_used.Count() == 1 &&
       js.pairedQuantizeAddresses.find(js.blockStart) == js.pairedQuantizeAddresses.end())
   {
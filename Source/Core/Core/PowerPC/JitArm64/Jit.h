@@ -170,6 +170,7 @@ private:
   {
     u32 length;
     const u8* slowmem_code;
+    bool store;
   };
 
   static void InitializeInstructionTables();
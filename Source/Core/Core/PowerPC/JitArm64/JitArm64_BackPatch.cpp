@@ -156,6 +156,7 @@ void JitArm64::EmitBackpatchRoutine(u32 flags, bool fastmem, bool do_farcode, AR
       handler.flags = flags;
 
       FastmemArea* fastmem_area = &m_fault_to_handler[fastmem_start];
+      fastmem_area->store = (flags & BackPatchInfo::FLAG_STORE) != 0;
       auto handler_loc_iter = m_handler_to_loc.find(handler);
 
       if (handler_loc_iter == m_handler_to_loc.end())
@@ -314,6 +315,15 @@ bool JitArm64::HandleFastmemFault(uintptr_t access_address, SContext* ctx)
   if ((const u8*)ctx->CTX_PC - fault_location > fastmem_area_length)
     return false;
 
+  // If the page could be mapped, just retry the access
+  if (access_address >= (uintptr_t)Memory::logical_base &&
+      PowerPC::HandlePageTableFault(
+          static_cast<u32>(access_address - (uintptr_t)Memory::logical_base),
+          slow_handler_iter->second.store))
+  {
+    return true;
+  }
+
   ARM64XEmitter emitter((u8*)fault_location);
 
   emitter.BL(slow_handler_iter->second.slowmem_code);
@@ -8,6 +8,7 @@
 
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitArm64/Jit.h"
 #include "Core/PowerPC/PPCTables.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -117,6 +118,8 @@ void JitArm64::mtsr(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITSystemRegistersOff);
+  // Page table mappings in the logical fastmem area have to be invalidated.
+  FALLBACK_IF(Memory::IsPageTableMappingEnabled());
 
   gpr.BindToRegister(inst.RS, true);
   STR(INDEX_UNSIGNED, gpr.R(inst.RS), PPC_REG, PPCSTATE_OFF(sr[inst.SR]));
@@ -145,6 +148,8 @@ void JitArm64::mtsrin(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITSystemRegistersOff);
+  // Page table mappings in the logical fastmem area have to be invalidated.
+  FALLBACK_IF(Memory::IsPageTableMappingEnabled());
 
   u32 b = inst.RB, d = inst.RD;
   gpr.BindToRegister(d, d == b);
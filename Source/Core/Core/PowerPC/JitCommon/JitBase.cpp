@@ -5,6 +5,7 @@
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #include "Common/CommonTypes.h"
+#include "Common/PerfMetrics.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/PPCAnalyst.h"
@@ -12,6 +13,10 @@
 
 JitBase* g_jit;
 
+static PerfMetrics::Counter s_blocks_compiled("jit.blocks_compiled");
+static PerfMetrics::Histogram s_compile_time("jit.compile_us",
+                                             PerfMetrics::FRAME_EVENT_JIT_COMPILE);
+
 const u8* JitBase::Dispatch(JitBase& jit)
 {
   return jit.GetBlockCache()->Dispatch();
@@ -19,6 +24,8 @@ const u8* JitBase::Dispatch(JitBase& jit)
 
 void JitTrampoline(JitBase& jit, u32 em_address)
 {
+  PerfMetrics::ScopedTimer timer(s_compile_time);
+  s_blocks_compiled.Add();
   jit.Jit(em_address);
 }
 
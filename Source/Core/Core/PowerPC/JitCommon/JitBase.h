@@ -100,6 +100,11 @@ protected:
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    // Start addresses of blocks that have been executed often enough to be worth recompiling
+    // with all optimizations, if tiered compilation is enabled.
+    std::unordered_set<u32> hotBlockAddresses;
+    // How often conditional branches in blocks of the baseline tier have been taken.
+    PPCAnalyst::BranchProfile branchProfile;
   };
 
   PPCAnalyst::CodeBlock code_block;
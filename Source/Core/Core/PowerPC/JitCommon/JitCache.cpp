@@ -65,6 +65,8 @@ void JitBaseBlockCache::Clear()
 #endif
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
+  m_jit.js.hotBlockAddresses.clear();
+  m_jit.js.branchProfile.Clear();
   for (auto& e : block_map)
   {
     DestroyBlock(e.second);
@@ -103,6 +105,7 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
   b.physicalAddress = physicalAddress;
   b.msrBits = MSR.Hex & JIT_CACHE_MSR_MASK;
   b.linkData.clear();
+  b.inline_caches.clear();
   b.fast_block_map_index = 0;
   return &b;
 }
@@ -133,6 +136,34 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
     LinkBlock(block);
   }
 
+  RegisterBlock(block);
+}
+
+void JitBaseBlockCache::RetargetBlockExit(JitBlock& block, size_t link_index, u32 destination)
+{
+  JitBlock::LinkData& link = block.linkData[link_index];
+
+  auto range = links_to.equal_range(link.exitAddress);
+  const auto it = std::find_if(range.first, range.second,
+                               [&block](const auto& entry) { return entry.second == &block; });
+  if (it != range.second)
+    links_to.erase(it);
+
+  WriteLinkBlock(link, nullptr);
+  link.exitAddress = destination;
+  link.linkStatus = false;
+  links_to.emplace(destination, &block);
+  LinkBlockExits(block);
+}
+
+void JitBaseBlockCache::RegisterBlocks()
+{
+  for (const auto& e : block_map)
+    RegisterBlock(e.second);
+}
+
+void JitBaseBlockCache::RegisterBlock(const JitBlock& block)
+{
   Common::Symbol* symbol = nullptr;
   if (JitRegister::IsEnabled() &&
       (symbol = g_symbolDB.GetSymbolFromAddr(block.effectiveAddress)) != nullptr)
@@ -216,6 +247,8 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
       {
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
+        m_jit.js.hotBlockAddresses.erase(i);
+        m_jit.js.branchProfile.Reset(i);
       }
     }
   }
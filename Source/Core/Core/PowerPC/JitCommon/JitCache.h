@@ -49,6 +49,9 @@ struct JitBlock
   // The number of PPC instructions represented by this block. Mostly
   // useful for logging.
   u32 originalSize;
+  // The number of times the register allocator had to evict a guest register
+  // while compiling this block. Mostly useful for profiling.
+  u32 registerSpills = 0;
 
   // Information about exits to a known address from this block.
   // This is used to implement block linking.
@@ -61,6 +64,19 @@ struct JitBlock
   };
   std::vector<LinkData> linkData;
 
+  // Inline caches for indirect branches. Each one compares the branch target
+  // with the last target seen at that site, and takes linkData[link_index],
+  // which is linked to the block for that target, if they match.
+  struct InlineCache
+  {
+    u8* target_immediate;  // the compared target within the emitted code
+    u8* update_jump;       // jump to the code updating the cache on a miss
+    const u8* dispatch;    // miss handling that doesn't update the cache
+    size_t link_index;
+    u32 misses;
+  };
+  std::vector<InlineCache> inline_caches;
+
   // This set stores all physical addresses of all occupied instructions.
   std::set<u32> physical_addresses;
 
@@ -72,8 +88,14 @@ struct JitBlock
     u64 runCount;
     u64 ticStart;
     u64 ticStop;
+    u64 inlineCacheHits;
+    u64 inlineCacheMisses;
   } profile_data = {};
 
+  // Number of executions left until the block is recompiled with all optimizations. Only used
+  // for blocks compiled by the baseline tier of a JIT with tiered compilation.
+  u32 tier_up_countdown = 0;
+
   // This tracks the position if this block within the fast block cache.
   // We allow each block to have only one map entry.
   size_t fast_block_map_index;
@@ -132,9 +154,14 @@ public:
   // Code Cache
   JitBlock** GetFastBlockMap();
   void RunOnBlocks(std::function<void(const JitBlock&)> f);
+  // Registers all existing blocks with JitRegister, e.g. after the perf map has been opened.
+  void RegisterBlocks();
 
   JitBlock* AllocateBlock(u32 em_address);
   void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses);
+  // Changes the destination of a linked exit, e.g. for inline caches. The caller is responsible
+  // for updating the code that decides whether the exit is taken.
+  void RetargetBlockExit(JitBlock& block, size_t link_index, u32 destination);
 
   // Look for the block in the slow but accurate way.
   // This function shall be used if FastLookupIndexForAddress() failed.
@@ -163,6 +190,7 @@ private:
   void LinkBlock(JitBlock& block);
   void UnlinkBlock(const JitBlock& block);
   void DestroyBlock(JitBlock& block);
+  void RegisterBlock(const JitBlock& block);
 
   JitBlock* MoveBlockIntoFastCache(u32 em_address, u32 msr);
 
@@ -19,8 +19,10 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/JitRegister.h"
 #include "Common/MsgHandler.h"
 
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
@@ -99,16 +101,19 @@ void WriteProfileResults(const std::string& filename)
     return;
   }
   fprintf(f.GetHandle(), "origAddr\tblkName\trunCount\tcost\ttimeCost\tpercent\ttimePercent\tOvAlli"
-                         "nBlkTime(ms)\tblkCodeSize\n");
+                         "nBlkTime(ms)\tblkCodeSize\tblkSpills\ticHits\ticMisses\n");
   for (auto& stat : prof_stats.block_stats)
   {
     std::string name = g_symbolDB.GetDescription(stat.addr);
     double percent = 100.0 * (double)stat.cost / (double)prof_stats.cost_sum;
     double timePercent = 100.0 * (double)stat.tick_counter / (double)prof_stats.timecost_sum;
     fprintf(f.GetHandle(),
-            "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%.2f\t%.2f\t%.2f\t%i\n", stat.addr,
-            name.c_str(), stat.run_count, stat.cost, stat.tick_counter, percent, timePercent,
-            (double)stat.tick_counter * 1000.0 / (double)prof_stats.countsPerSec, stat.block_size);
+            "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%.2f\t%.2f\t%.2f\t%i\t%u\t%" PRIu64
+            "\t%" PRIu64 "\n",
+            stat.addr, name.c_str(), stat.run_count, stat.cost, stat.tick_counter, percent,
+            timePercent, (double)stat.tick_counter * 1000.0 / (double)prof_stats.countsPerSec,
+            stat.block_size, stat.register_spills, stat.inline_cache_hits,
+            stat.inline_cache_misses);
   }
 }
 
@@ -134,7 +139,8 @@ void GetProfileResults(Profiler::ProfileStats* prof_stats)
     // Todo: tweak.
     if (data.runCount >= 1)
       prof_stats->block_stats.emplace_back(block.effectiveAddress, cost, timecost, data.runCount,
-                                           block.codeSize);
+                                           block.codeSize, block.registerSpills,
+                                           data.inlineCacheHits, data.inlineCacheMisses);
     prof_stats->cost_sum += cost;
     prof_stats->timecost_sum += timecost;
   });
@@ -144,6 +150,17 @@ void GetProfileResults(Profiler::ProfileStats* prof_stats)
     Core::SetState(Core::State::Running);
 }
 
+void WritePerfMap()
+{
+  if (!g_jit)
+    return;
+
+  Core::RunAsCPUThread([] {
+    if (JitRegister::OpenPerfMap(SConfig::GetInstance().m_perfDir))
+      g_jit->GetBlockCache()->RegisterBlocks();
+  });
+}
+
 int GetHostCode(u32* address, const u8** code, u32* code_size)
 {
   if (!g_jit)
@@ -239,6 +256,9 @@ void CompileExceptionCheck(ExceptionType type)
   case ExceptionType::SpeculativeConstants:
     exception_addresses = &g_jit->js.noSpeculativeConstantsAddresses;
     break;
+  case ExceptionType::HotBlock:
+    exception_addresses = &g_jit->js.hotBlockAddresses;
+    break;
   }
 
   if (PC != 0 && (exception_addresses->find(PC)) == (exception_addresses->end()))
@@ -253,7 +273,7 @@ void CompileExceptionCheck(ExceptionType type)
     exception_addresses->insert(PC);
 
     // Invalidate the JIT block so that it gets recompiled with the external exception check
-    // included.
+    // included (or with all optimizations, for hot blocks).
     g_jit->GetBlockCache()->InvalidateICache(PC, 4, true);
   }
 }
@@ -28,7 +28,8 @@ enum class ExceptionType
 {
   FIFOWrite,
   PairedQuantize,
-  SpeculativeConstants
+  SpeculativeConstants,
+  HotBlock
 };
 
 void DoState(PointerWrap& p);
@@ -46,6 +47,9 @@ enum class ProfilingState
 void SetProfilingState(ProfilingState state);
 void WriteProfileResults(const std::string& filename);
 void GetProfileResults(Profiler::ProfileStats* prof_stats);
+// Opens the perf map (/tmp/perf-<pid>.map unless a perf directory is configured) if it isn't
+// open yet and writes all existing blocks to it. Blocks compiled later are added as they come.
+void WritePerfMap();
 int GetHostCode(u32* address, const u8** code, u32* code_size);
 
 // Memory Utilities
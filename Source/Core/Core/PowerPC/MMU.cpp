@@ -655,6 +655,44 @@ bool IsOptimizableRAMAddress(const u32 address)
   return (bat_result & BAT_PHYSICAL_BIT) != 0;
 }
 
+u8* GetRAMPointerForRange(const u32 address, const u32 size)
+{
+  if (size == 0 || address + (size - 1) < address)
+    return nullptr;
+
+  if (PowerPC::memchecks.HasAny() || !MSR.DR)
+    return nullptr;
+
+  // BAT mappings are done in 128 KB blocks, so every block the range touches has to map to the
+  // physical block following the previous one.
+  const u32 first_index = address >> BAT_INDEX_SHIFT;
+  const u32 last_index = (address + (size - 1)) >> BAT_INDEX_SHIFT;
+  const u32 first_result = dbat_table[first_index];
+  for (u32 index = first_index; index <= last_index; ++index)
+  {
+    const u32 bat_result = dbat_table[index];
+    if ((bat_result & BAT_PHYSICAL_BIT) == 0)
+      return nullptr;
+    if ((bat_result & BAT_RESULT_MASK) !=
+        (first_result & BAT_RESULT_MASK) + (index - first_index) * BAT_PAGE_SIZE)
+    {
+      return nullptr;
+    }
+  }
+
+  const u32 physical_address =
+      (first_result & BAT_RESULT_MASK) | (address & (BAT_PAGE_SIZE - 1));
+  const u32 offset = physical_address & 0x0FFFFFFF;
+  if (physical_address < Memory::REALRAM_SIZE && size <= Memory::REALRAM_SIZE - physical_address)
+    return Memory::m_pRAM + physical_address;
+  if (Memory::m_pEXRAM && physical_address >> 28 == 0x1 && offset < Memory::EXRAM_SIZE &&
+      size <= Memory::EXRAM_SIZE - offset)
+  {
+    return Memory::m_pEXRAM + offset;
+  }
+  return nullptr;
+}
+
 template <XCheckTLBFlag flag>
 static bool IsRAMAddress(u32 address, bool translate)
 {
@@ -980,6 +1018,13 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+  Memory::RemovePageTableMappings(0, 0);
+}
+
+void SRUpdated(u32 index)
+{
+  Memory::RemovePageTableMappings(0xF0000000, index << 28);
 }
 
 enum class TLBLookupResult
@@ -1066,6 +1111,27 @@ void InvalidateTLBEntry(u32 address)
   TLBEntry& tlbe_i = ppcState.tlb[1][entry_index];
   tlbe_i.tag[0] = TLBEntry::INVALID_TAG;
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
+
+  // tlbie invalidates all entries in the congruence class, regardless of the segment.
+  Memory::RemovePageTableMappings(HW_PAGE_INDEX_MASK << HW_PAGE_INDEX_SHIFT,
+                                  address & (HW_PAGE_INDEX_MASK << HW_PAGE_INDEX_SHIFT));
+}
+
+// Whether the changed bit of the data TLB entry for the given address is set.
+static bool IsDataTLBEntryChanged(u32 address)
+{
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+  for (size_t i = 0; i < TLB_WAYS; ++i)
+  {
+    if (tlbe.tag[i] != tag)
+      continue;
+
+    UPTE2 PTE2;
+    PTE2.Hex = tlbe.pte[i];
+    return PTE2.C != 0;
+  }
+  return false;
 }
 
 // Page Address Translation
@@ -1161,6 +1227,38 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
   return TranslateAddressResult{TranslateAddressResult::PAGE_FAULT, 0};
 }
 
+bool HandlePageTableFault(u32 address, bool write)
+{
+  if (!MSR.DR || !Memory::IsPageTableMappingEnabled())
+    return false;
+
+  // Accesses to pages with memchecks have to go through the slow path.
+  const u32 page_address = address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  if (memchecks.OverlapsMemcheck(page_address, HW_PAGE_SIZE))
+    return false;
+
+  // Addresses covered by a DBAT are mapped by Memory::UpdateLogicalMemory, so a fault there
+  // means the access doesn't target RAM.
+  u32 bat_address = address;
+  if (TranslateBatAddess(dbat_table, &bat_address))
+    return false;
+
+  const TranslateAddressResult translated_address =
+      TranslatePageAddress(address, write ? XCheckTLBFlag::Write : XCheckTLBFlag::Read);
+  if (translated_address.result != TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    return false;
+
+  // Accesses through the host mapping don't update the R and C bits of the page table entry.
+  // R was just set by the translation, but C must already be set before the page can be mapped,
+  // otherwise the first write to the page would go unnoticed.
+  if (!write && !IsDataTLBEntryChanged(address))
+    return false;
+
+  const u32 translated_page_address =
+      translated_address.address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  return Memory::AddPageTableMapping(page_address, translated_page_address);
+}
+
 static void UpdateBATs(BatTable& bat_table, u32 base_spr)
 {
   // TODO: Separate BATs for MSR.PR==0 and MSR.PR==1
@@ -83,6 +83,7 @@ void ClearCacheLine(u32 address);  // Zeroes 32 bytes; address should be 32-byte
 
 // TLB functions
 void SDRUpdated();
+void SRUpdated(u32 index);
 void InvalidateTLBEntry(u32 address);
 void DBATUpdated();
 void IBATUpdated();
@@ -91,9 +92,18 @@ void IBATUpdated();
 // it's safe to optimize a read or write to this address to an unguarded
 // memory access.  Does not consider page tables.
 bool IsOptimizableRAMAddress(u32 address);
+// Returns a host pointer to the given range of effective addresses if the data BATs map all of
+// it to contiguous RAM that can be accessed directly, i.e. without going through MMIO handlers,
+// page tables or memchecks. Returns nullptr otherwise.
+u8* GetRAMPointerForRange(u32 address, u32 size);
 u32 IsOptimizableMMIOAccess(u32 address, u32 access_size);
 bool IsOptimizableGatherPipeWrite(u32 address);
 
+// Called by the JITs when a fastmem access to a logical address faults. If the address is
+// translated through the page table, maps the page into the logical fastmem area and returns
+// true, in which case the faulting access can simply be retried.
+bool HandlePageTableFault(u32 address, bool write);
+
 struct TranslateResult
 {
   bool valid;
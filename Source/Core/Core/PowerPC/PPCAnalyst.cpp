@@ -16,6 +16,7 @@
 #include "Common/StringUtil.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/HLE/HLE.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -39,6 +40,11 @@ namespace PPCAnalyst
 {
 // 0 does not perform block merging
 constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
+constexpr u32 AGGRESSIVE_BRANCH_FOLLOWING_THRESHOLD = 8;
+
+// A conditional branch is followed when it has been taken in at least 15 out of 16 of its
+// executions, and it has been executed often enough for that to be meaningful.
+constexpr u32 TRACE_MIN_BRANCH_EXECUTIONS = 32;
 
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
@@ -642,6 +648,26 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
+bool BranchProfile::IsUsuallyTaken(u32 address) const
+{
+  const auto it = m_counters.find(address);
+  if (it == m_counters.end())
+    return false;
+
+  const u64 taken = it->second.taken;
+  const u64 executions = taken + it->second.not_taken;
+  return executions >= TRACE_MIN_BRANCH_EXECUTIONS && taken * 16 >= executions * 15;
+}
+
+void BranchProfile::Reset(u32 address)
+{
+  // The counters are only zeroed rather than erased, as code of a block that has just been
+  // invalidated may still be running and update them.
+  const auto it = m_counters.find(address);
+  if (it != m_counters.end())
+    it->second = {};
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size)
 {
   // Clear block stats
@@ -673,6 +699,9 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
   u32 num_inst = 0;
 
   const bool enable_follow = SConfig::GetInstance().bJITFollowBranch;
+  const u32 follow_threshold = HasOption(OPTION_AGGRESSIVE_BRANCH_FOLLOW) ?
+                                   AGGRESSIVE_BRANCH_FOLLOWING_THRESHOLD :
+                                   BRANCH_FOLLOWING_THRESHOLD;
 
   for (std::size_t i = 0; i < block_size; ++i)
   {
@@ -705,11 +734,21 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
 
     bool conditional_continue = false;
 
+    if (HasOption(OPTION_HLE_CALL_INLINE) && inst.OPCD == 18 && inst.LK)
+    {
+      code[i].hleFunction =
+          HLE::GetInlinableFunctionIndex(SignExt26(inst.LI << 2) + (inst.AA ? 0 : address));
+      // The HLE function returns to the next instruction, so simply continue there. As the call
+      // overwrites LR, this also stops us from inlining the return of a call followed before.
+      conditional_continue = code[i].hleFunction != 0;
+    }
+
     // TODO: Find the optimal value for BRANCH_FOLLOWING_THRESHOLD.
     //       If it is small, the performance will be down.
     //       If it is big, the size of generated code will be big and
     //       cache clearning will happen many times.
-    if (enable_follow && HasOption(OPTION_BRANCH_FOLLOW) && numFollows < BRANCH_FOLLOWING_THRESHOLD)
+    if (!conditional_continue && enable_follow && HasOption(OPTION_BRANCH_FOLLOW) &&
+        numFollows < follow_threshold)
     {
       if (inst.OPCD == 18 && block_size > 1)
       {
@@ -734,6 +773,16 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
           caller = i;
         }
       }
+      else if (inst.OPCD == 16 && !inst.LK && HasOption(OPTION_TRACE_FORMATION) &&
+               m_branch_profile && m_branch_profile->IsUsuallyTaken(address) && block_size > 1)
+      {
+        // Continue at the target of a conditional branch that is almost always taken, so that
+        // hot paths like loop bodies end up in a single block. The JIT leaves the block at the
+        // branch if it isn't taken.
+        follow = true;
+        destination = SignExt16(inst.BD << 2) + (inst.AA ? 0 : address);
+        code[i].branchIsFollowed = true;
+      }
       else if (inst.OPCD == 19 && inst.SUBOP10 == 16 && !inst.LK && found_call &&
                (inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION))
       {
@@ -827,47 +876,66 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
     block->m_broken = true;
   }
 
-  // Scan for flag dependencies; assume the next block (or any branch that can leave the block)
-  // wants flags, to be safe.
-  bool wantsCR0 = true, wantsCR1 = true, wantsFPRF = true, wantsCA = true;
-  BitSet32 fprInUse, gprInUse, gprInReg, fprInXmm;
-  for (int i = block->m_num_instructions - 1; i >= 0; i--)
+  if (HasOption(OPTION_SKIP_USAGE_ANALYSIS))
   {
-    CodeOp& op = code[i];
-
-    const bool opWantsCR0 = op.wantsCR0;
-    const bool opWantsCR1 = op.wantsCR1;
-    const bool opWantsFPRF = op.wantsFPRF;
-    const bool opWantsCA = op.wantsCA;
-    op.wantsCR0 = wantsCR0 || op.canEndBlock;
-    op.wantsCR1 = wantsCR1 || op.canEndBlock;
-    op.wantsFPRF = wantsFPRF || op.canEndBlock;
-    op.wantsCA = wantsCA || op.canEndBlock;
-    wantsCR0 |= opWantsCR0 || op.canEndBlock;
-    wantsCR1 |= opWantsCR1 || op.canEndBlock;
-    wantsFPRF |= opWantsFPRF || op.canEndBlock;
-    wantsCA |= opWantsCA || op.canEndBlock;
-    wantsCR0 &= !op.outputCR0 || opWantsCR0;
-    wantsCR1 &= !op.outputCR1 || opWantsCR1;
-    wantsFPRF &= !op.outputFPRF || opWantsFPRF;
-    wantsCA &= !op.outputCA || opWantsCA;
-    op.gprInUse = gprInUse;
-    op.fprInUse = fprInUse;
-    op.gprInReg = gprInReg;
-    op.fprInXmm = fprInXmm;
-    // TODO: if there's no possible endblocks or exceptions in between, tell the regcache
-    // we can throw away a register if it's going to be overwritten later.
-    gprInUse |= op.regsIn;
-    gprInReg |= op.regsIn;
-    fprInUse |= op.fregsIn;
-    if (strncmp(op.opinfo->opname, "stfd", 4))
-      fprInXmm |= op.fregsIn;
-    // For now, we need to count output registers as "used" though; otherwise the flush
-    // will result in a redundant store (e.g. store to regcache, then store again to
-    // the same location later).
-    gprInUse |= op.regsOut;
-    if (op.fregOut >= 0)
-      fprInUse[op.fregOut] = true;
+    // No register is preloaded or discarded early, and all flags get computed.
+    for (u32 i = 0; i < block->m_num_instructions; i++)
+    {
+      CodeOp& op = code[i];
+      op.wantsCR0 = true;
+      op.wantsCR1 = true;
+      op.wantsFPRF = true;
+      op.wantsCA = true;
+      op.gprInUse = BitSet32::AllTrue(32);
+      op.fprInUse = BitSet32::AllTrue(32);
+      op.gprInReg = BitSet32();
+      op.fprInXmm = BitSet32();
+    }
+  }
+  else
+  {
+    // Scan for flag dependencies; assume the next block (or any branch that can leave the block)
+    // wants flags, to be safe.
+    bool wantsCR0 = true, wantsCR1 = true, wantsFPRF = true, wantsCA = true;
+    BitSet32 fprInUse, gprInUse, gprInReg, fprInXmm;
+    for (int i = block->m_num_instructions - 1; i >= 0; i--)
+    {
+      CodeOp& op = code[i];
+
+      const bool opWantsCR0 = op.wantsCR0;
+      const bool opWantsCR1 = op.wantsCR1;
+      const bool opWantsFPRF = op.wantsFPRF;
+      const bool opWantsCA = op.wantsCA;
+      op.wantsCR0 = wantsCR0 || op.canEndBlock;
+      op.wantsCR1 = wantsCR1 || op.canEndBlock;
+      op.wantsFPRF = wantsFPRF || op.canEndBlock;
+      op.wantsCA = wantsCA || op.canEndBlock;
+      wantsCR0 |= opWantsCR0 || op.canEndBlock;
+      wantsCR1 |= opWantsCR1 || op.canEndBlock;
+      wantsFPRF |= opWantsFPRF || op.canEndBlock;
+      wantsCA |= opWantsCA || op.canEndBlock;
+      wantsCR0 &= !op.outputCR0 || opWantsCR0;
+      wantsCR1 &= !op.outputCR1 || opWantsCR1;
+      wantsFPRF &= !op.outputFPRF || opWantsFPRF;
+      wantsCA &= !op.outputCA || opWantsCA;
+      op.gprInUse = gprInUse;
+      op.fprInUse = fprInUse;
+      op.gprInReg = gprInReg;
+      op.fprInXmm = fprInXmm;
+      // TODO: if there's no possible endblocks or exceptions in between, tell the regcache
+      // we can throw away a register if it's going to be overwritten later.
+      gprInUse |= op.regsIn;
+      gprInReg |= op.regsIn;
+      fprInUse |= op.fregsIn;
+      if (strncmp(op.opinfo->opname, "stfd", 4))
+        fprInXmm |= op.fregsIn;
+      // For now, we need to count output registers as "used" though; otherwise the flush
+      // will result in a redundant store (e.g. store to regcache, then store again to
+      // the same location later).
+      gprInUse |= op.regsOut;
+      if (op.fregOut >= 0)
+        fprInUse[op.fregOut] = true;
+    }
   }
 
   // Forward scan, for flags that need the other direction for calculation.
@@ -880,6 +948,14 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
     gprBlockInputs |= op.regsIn & ~gprDefined;
     gprDefined |= op.regsOut;
 
+    if (!HasOption(OPTION_SKIP_USAGE_ANALYSIS))
+    {
+      for (int reg : op.regsIn)
+        block->m_gpa->reads[reg].push_back(i);
+      for (int reg : op.fregsIn)
+        block->m_fpa->reads[reg].push_back(i);
+    }
+
     op.fprIsSingle = fprIsSingle;
     op.fprIsDuplicated = fprIsDuplicated;
     op.fprIsStoreSafe = fprIsStoreSafe;
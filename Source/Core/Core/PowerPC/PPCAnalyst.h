@@ -5,8 +5,10 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/BitSet.h"
@@ -46,6 +48,11 @@ struct CodeOp  // 16B
   bool canEndBlock;
   bool skipLRStack;
   bool skip;  // followed BL-s for example
+  // The block continues at the target of this conditional branch rather than at the next
+  // instruction, so the branch has to leave the block if it isn't taken.
+  bool branchIsFollowed;
+  // HLE function that a call is compiled to instead of branching, 0 if none
+  u32 hleFunction;
   // which registers are still needed after this instruction in this block
   BitSet32 fprInUse;
   BitSet32 gprInUse;
@@ -81,6 +88,10 @@ struct BlockRegStats
   short numReads[32];
   short numWrites[32];
 
+  // The indices of the instructions reading each register, in ascending order. Unlike the
+  // values above, these refer to the final order of the instructions in the block.
+  std::array<std::vector<u32>, 32> reads;
+
   bool any;
   bool anyTimer;
 
@@ -91,6 +102,15 @@ struct BlockRegStats
   }
 
   bool IsUsed(int reg) const { return (numReads[reg] + numWrites[reg]) > 0; }
+
+  // Returns the index of the first instruction at or after the given one that reads the
+  // register, or UINT32_MAX if the register isn't read anymore in this block.
+  u32 GetNextRead(int reg, u32 index) const
+  {
+    const auto it = std::lower_bound(reads[reg].begin(), reads[reg].end(), index);
+    return it != reads[reg].end() ? *it : UINT32_MAX;
+  }
+
   void SetInputRegister(int reg, short opindex)
   {
     if (firstRead[reg] == -1)
@@ -115,12 +135,36 @@ struct BlockRegStats
       firstWrite[i] = -1;
       numReads[i] = 0;
       numWrites[i] = 0;
+      reads[i].clear();
     }
   }
 };
 
 using CodeBuffer = std::vector<CodeOp>;
 
+// Counts how often conditional branches have been taken, so that blocks can be continued in the
+// direction a branch usually goes.
+class BranchProfile
+{
+public:
+  struct Counters
+  {
+    u32 taken = 0;
+    u32 not_taken = 0;
+  };
+
+  // The returned reference stays valid until the profile is cleared, so that the counters can
+  // be updated by JIT code directly.
+  Counters& GetCounters(u32 address) { return m_counters[address]; }
+  bool IsUsuallyTaken(u32 address) const;
+  // Forgets what is known about a branch, e.g. because its code has been modified.
+  void Reset(u32 address);
+  void Clear() { m_counters.clear(); }
+
+private:
+  std::unordered_map<u32, Counters> m_counters;
+};
+
 struct CodeBlock
 {
   // Beginning PPC address.
@@ -194,12 +238,32 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Don't end the block on calls to functions that are replaced by a native HLE function
+    // without side effects on the control flow. Instead, the JIT calls the HLE function directly.
+    // Requires JIT support.
+    OPTION_HLE_CALL_INLINE = (1 << 7),
+
+    // Follow more branches than usual, so that small functions are inlined into the caller.
+    // Meant for blocks that are known to be executed often, as it increases the code size.
+    OPTION_AGGRESSIVE_BRANCH_FOLLOW = (1 << 8),
+
+    // Form traces through hot code by following conditional branches that are usually taken
+    // according to the branch profile. Only applies together with OPTION_BRANCH_FOLLOW.
+    // Requires JIT support, as such a branch leaves the block when it isn't taken.
+    OPTION_TRACE_FORMATION = (1 << 9),
+
+    // Skip the register and flag usage analysis, and assume that every instruction needs all
+    // registers and flags. Analysis gets faster at the cost of worse code, which is meant for
+    // blocks that are recompiled later anyway.
+    OPTION_SKIP_USAGE_ANALYSIS = (1 << 10),
   };
 
   // Option setting/getting
   void SetOption(AnalystOption option) { m_options |= option; }
   void ClearOption(AnalystOption option) { m_options &= ~(option); }
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+  void SetBranchProfile(const BranchProfile* profile) { m_branch_profile = profile; }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size);
 
 private:
@@ -216,6 +280,8 @@ private:
 
   // Options
   u32 m_options = 0;
+
+  const BranchProfile* m_branch_profile = nullptr;
 };
 
 void LogFunctionCall(u32 addr);
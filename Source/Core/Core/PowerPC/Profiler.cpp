@@ -0,0 +1,168 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/SymbolDB.h"
+#include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/HW/CPU.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace Profiler
+{
+constexpr std::chrono::milliseconds SAMPLING_INTERVAL{1};
+
+static std::atomic<bool> s_sampling_enabled{false};
+
+// Protects the sampling thread and s_initialized.
+static std::mutex s_thread_mutex;
+static bool s_initialized = false;
+static std::thread s_sampling_thread;
+static Common::Flag s_sampling_thread_exiting;
+static Common::Event s_sampling_thread_wakeup;
+
+static std::mutex s_samples_mutex;
+// Guest address -> number of samples
+static std::map<u32, u64> s_samples;
+static u64 s_sample_count = 0;
+
+static void SamplingThread()
+{
+  Common::SetCurrentThreadName("Sampling profiler");
+
+  while (!s_sampling_thread_exiting.IsSet())
+  {
+    s_sampling_thread_wakeup.WaitFor(SAMPLING_INTERVAL);
+    if (CPU::GetState() != CPU::State::Running)
+      continue;
+
+    // This races with the CPU thread, but PC is always written as a whole, so the worst case is
+    // attributing a sample to the block that was entered right before.
+    const u32 pc = PowerPC::ppcState.pc;
+
+    std::lock_guard<std::mutex> lk(s_samples_mutex);
+    ++s_samples[pc];
+    ++s_sample_count;
+  }
+}
+
+static void StartSamplingThread()
+{
+  s_sampling_thread_exiting.Clear();
+  s_sampling_thread = std::thread(SamplingThread);
+}
+
+static void StopSamplingThread()
+{
+  if (!s_sampling_thread.joinable())
+    return;
+
+  s_sampling_thread_exiting.Set();
+  s_sampling_thread_wakeup.Set();
+  s_sampling_thread.join();
+}
+
+void Init()
+{
+  std::lock_guard<std::mutex> lk(s_thread_mutex);
+  s_initialized = true;
+  s_sampling_enabled = Config::Get(Config::MAIN_SAMPLING_PROFILER);
+  if (s_sampling_enabled)
+    StartSamplingThread();
+}
+
+void Shutdown()
+{
+  std::lock_guard<std::mutex> lk(s_thread_mutex);
+  StopSamplingThread();
+  s_initialized = false;
+}
+
+bool IsSamplingEnabled()
+{
+  return s_sampling_enabled;
+}
+
+void SetSamplingEnabled(bool enabled)
+{
+  Config::SetBaseOrCurrent(Config::MAIN_SAMPLING_PROFILER, enabled);
+
+  {
+    std::lock_guard<std::mutex> lk(s_thread_mutex);
+    if (s_sampling_enabled == enabled)
+      return;
+
+    s_sampling_enabled = enabled;
+    if (!s_initialized)
+      return;
+
+    if (enabled)
+      StartSamplingThread();
+    else
+      StopSamplingThread();
+  }
+
+  // Blocks only keep PC up to date on entry if they were compiled while sampling was enabled.
+  Core::RunAsCPUThread(JitInterface::ClearCache);
+}
+
+void ClearSamples()
+{
+  std::lock_guard<std::mutex> lk(s_samples_mutex);
+  s_samples.clear();
+  s_sample_count = 0;
+}
+
+u64 GetSampleCount()
+{
+  std::lock_guard<std::mutex> lk(s_samples_mutex);
+  return s_sample_count;
+}
+
+bool WriteCollapsedStacks(const std::string& filename)
+{
+  std::map<u32, u64> samples;
+  {
+    std::lock_guard<std::mutex> lk(s_samples_mutex);
+    samples = s_samples;
+  }
+
+  File::IOFile f(filename, "w");
+  if (!f)
+  {
+    ERROR_LOG(POWERPC, "Failed to open %s", filename.c_str());
+    return false;
+  }
+
+  for (const auto& [address, count] : samples)
+  {
+    const Common::Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+    // Semicolons separate the frames of a stack.
+    const std::string function_name =
+        ReplaceAll(symbol ? symbol->function_name : "[unknown]", ";", ":");
+
+    fprintf(f.GetHandle(), "%s;%08x %" PRIu64 "\n", function_name.c_str(), address, count);
+  }
+
+  return true;
+}
+
+}  // namespace Profiler
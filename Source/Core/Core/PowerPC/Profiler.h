@@ -14,8 +14,10 @@ namespace Profiler
 {
 struct BlockStat
 {
-  BlockStat(u32 _addr, u64 c, u64 ticks, u64 run, u32 size)
-      : addr(_addr), cost(c), tick_counter(ticks), run_count(run), block_size(size)
+  BlockStat(u32 _addr, u64 c, u64 ticks, u64 run, u32 size, u32 spills, u64 ic_hits,
+            u64 ic_misses)
+      : addr(_addr), cost(c), tick_counter(ticks), run_count(run), block_size(size),
+        register_spills(spills), inline_cache_hits(ic_hits), inline_cache_misses(ic_misses)
   {
   }
   u32 addr;
@@ -23,6 +25,9 @@ struct BlockStat
   u64 tick_counter;
   u64 run_count;
   u32 block_size;
+  u32 register_spills;
+  u64 inline_cache_hits;
+  u64 inline_cache_misses;
 
   bool operator<(const BlockStat& other) const { return cost > other.cost; }
 };
@@ -34,4 +39,22 @@ struct ProfileStats
   u64 countsPerSec;
 };
 
+// Sampling profiler
+//
+// While sampling is enabled, a host thread periodically records the guest PC the CPU thread is
+// executing. Apart from the JITs keeping PC up to date on block entry, the generated code isn't
+// instrumented, so unlike block profiling this is cheap enough to be left on during normal play.
+void Init();
+void Shutdown();
+
+bool IsSamplingEnabled();
+void SetSamplingEnabled(bool enabled);
+
+void ClearSamples();
+u64 GetSampleCount();
+
+// Writes the samples in the collapsed stack format used by flamegraph.pl: one line per sampled
+// address, consisting of the containing function and the address, followed by the sample count.
+bool WriteCollapsedStacks(const std::string& filename);
+
 }  // namespace Profiler
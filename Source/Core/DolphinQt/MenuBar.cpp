@@ -22,6 +22,7 @@
 #include "Common/CDUtils.h"
 #include "Core/Boot/Boot.h"
 #include "Core/CommonTitles.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/Debugger/RSO.h"
@@ -37,6 +38,7 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/SignatureDB/SignatureDB.h"
 #include "Core/State.h"
 #include "Core/TitleDatabase.h"
@@ -116,6 +118,7 @@ void MenuBar::OnEmulationStateChanged(Core::State state)
   m_jit_clear_cache->setEnabled(running);
   m_jit_log_coverage->setEnabled(!running);
   m_jit_search_instruction->setEnabled(running);
+  m_jit_write_perf_map->setEnabled(running);
 
   for (QAction* action :
        {m_jit_off, m_jit_loadstore_off, m_jit_loadstore_lbzx_off, m_jit_loadstore_lxz_off,
@@ -765,6 +768,18 @@ void MenuBar::AddJITMenu()
 
   m_jit->addSeparator();
 
+  m_jit_sampling_profiler = m_jit->addAction(tr("Enable Sampling Profiler"));
+  m_jit_sampling_profiler->setCheckable(true);
+  m_jit_sampling_profiler->setChecked(Config::Get(Config::MAIN_SAMPLING_PROFILER));
+  connect(m_jit_sampling_profiler, &QAction::toggled,
+          [](bool enabled) { Profiler::SetSamplingEnabled(enabled); });
+
+  m_jit_write_profiler_samples = m_jit->addAction(tr("Write Profiler Samples..."), this,
+                                                  &MenuBar::WriteProfilerSamples);
+  m_jit_write_perf_map = m_jit->addAction(tr("Write perf Map"), this, &MenuBar::WritePerfMap);
+
+  m_jit->addSeparator();
+
   m_jit_off = m_jit->addAction(tr("JIT Off (JIT Core)"));
   m_jit_off->setCheckable(true);
   m_jit_off->setChecked(SConfig::GetInstance().bJITOff);
@@ -1418,6 +1433,28 @@ void MenuBar::LogInstructions()
   PPCTables::LogCompiledInstructions();
 }
 
+void MenuBar::WriteProfilerSamples()
+{
+  const QString file = QFileDialog::getSaveFileName(
+      this, tr("Write profiler samples"),
+      QString::fromStdString(File::GetUserPath(D_LOGS_IDX) + "profile_samples.txt"),
+      tr("Collapsed Stacks (*.txt)"));
+
+  if (file.isEmpty())
+    return;
+
+  if (!Profiler::WriteCollapsedStacks(file.toStdString()))
+  {
+    QMessageBox::warning(this, tr("Error"),
+                         tr("Failed to write profiler samples to path '%1'").arg(file));
+  }
+}
+
+void MenuBar::WritePerfMap()
+{
+  JitInterface::WritePerfMap();
+}
+
 void MenuBar::SearchInstruction()
 {
   bool good;
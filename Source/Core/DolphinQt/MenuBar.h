@@ -158,6 +158,8 @@ private:
   void AppendSignatureFile();
   void ApplySignatureFile();
   void CombineSignatureFiles();
+  void WriteProfilerSamples();
+  void WritePerfMap();
   void PatchHLEFunctions();
   void ClearCache();
   void LogInstructions();
@@ -235,6 +237,9 @@ private:
   QAction* m_jit_clear_cache;
   QAction* m_jit_log_coverage;
   QAction* m_jit_search_instruction;
+  QAction* m_jit_sampling_profiler;
+  QAction* m_jit_write_profiler_samples;
+  QAction* m_jit_write_perf_map;
   QAction* m_jit_off;
   QAction* m_jit_loadstore_off;
   QAction* m_jit_loadstore_lbzx_off;
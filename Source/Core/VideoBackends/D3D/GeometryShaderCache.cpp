@@ -16,6 +16,7 @@
 #include "VideoBackends/D3D/FramebufferManager.h"
 #include "VideoBackends/D3D/GeometryShaderCache.h"
 
+#include "VideoCommon/ConstantUploadTracker.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/GeometryShaderManager.h"
@@ -37,21 +38,24 @@ ID3D11GeometryShader* GeometryShaderCache::GetCopyGeometryShader()
 }
 
 ID3D11Buffer* gscbuf = nullptr;
+static ConstantUploadTracker s_constants_tracker(sizeof(GeometryShaderConstants));
 
 ID3D11Buffer*& GeometryShaderCache::GetConstantBuffer()
 {
   // TODO: divide the global variables of the generated shaders into about 5 constant buffers to
   // speed this up
-  if (GeometryShaderManager::dirty)
+  // The buffer keeps its contents if none of the values changed.
+  if (GeometryShaderManager::dirty &&
+      s_constants_tracker.Update(&GeometryShaderManager::constants))
   {
     D3D11_MAPPED_SUBRESOURCE map;
     D3D::context->Map(gscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
     memcpy(map.pData, &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
     D3D::context->Unmap(gscbuf, 0);
-    GeometryShaderManager::dirty = false;
 
     ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(GeometryShaderConstants));
   }
+  GeometryShaderManager::dirty = false;
   return gscbuf;
 }
 
@@ -124,6 +128,7 @@ void GeometryShaderCache::Init()
   CHECK(hr == S_OK, "Create geometry shader constant buffer (size=%u)", gbsize);
   D3D::SetDebugObjectName(gscbuf,
                           "geometry shader constant buffer used to emulate the GX pipeline");
+  s_constants_tracker.Invalidate();
 
   // used when drawing clear quads
   ClearGeometryShader = D3D::CompileAndCreateGeometryShader(clear_shader_code);
@@ -18,6 +18,7 @@
 #include "VideoBackends/D3D/D3DState.h"
 #include "VideoBackends/D3D/PixelShaderCache.h"
 
+#include "VideoCommon/ConstantUploadTracker.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/PixelShaderGen.h"
 #include "VideoCommon/PixelShaderManager.h"
@@ -33,6 +34,7 @@ ID3D11PixelShader* s_DepthResolveProgram = nullptr;
 ID3D11PixelShader* s_rgba6_to_rgb8[2] = {nullptr};
 ID3D11PixelShader* s_rgb8_to_rgba6[2] = {nullptr};
 ID3D11Buffer* pscbuf = nullptr;
+static ConstantUploadTracker s_constants_tracker(sizeof(PixelShaderConstants));
 
 const char clear_program_code[] = {"void main(\n"
                                    "out float4 ocol0 : SV_Target,\n"
@@ -279,16 +281,18 @@ ID3D11PixelShader* PixelShaderCache::GetDepthResolveProgram()
 
 static void UpdateConstantBuffers()
 {
-  if (PixelShaderManager::dirty)
+  // The buffer keeps its contents if none of the values changed.
+  if (PixelShaderManager::dirty &&
+      s_constants_tracker.Update(&PixelShaderManager::constants))
   {
     D3D11_MAPPED_SUBRESOURCE map;
     D3D::context->Map(pscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
     memcpy(map.pData, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
     D3D::context->Unmap(pscbuf, 0);
-    PixelShaderManager::dirty = false;
 
     ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(PixelShaderConstants));
   }
+  PixelShaderManager::dirty = false;
 }
 
 ID3D11Buffer* PixelShaderCache::GetConstantBuffer()
@@ -306,6 +310,7 @@ void PixelShaderCache::Init()
   D3D::device->CreateBuffer(&cbdesc, nullptr, &pscbuf);
   CHECK(pscbuf != nullptr, "Create pixel shader constant buffer");
   D3D::SetDebugObjectName(pscbuf, "pixel shader constant buffer used to emulate the GX pipeline");
+  s_constants_tracker.Invalidate();
 
   // used when drawing clear quads
   s_ClearProgram = D3D::CompileAndCreatePixelShader(clear_program_code);
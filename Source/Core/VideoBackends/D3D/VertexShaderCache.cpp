@@ -18,6 +18,7 @@
 #include "VideoBackends/D3D/VertexManager.h"
 #include "VideoBackends/D3D/VertexShaderCache.h"
 
+#include "VideoCommon/ConstantUploadTracker.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/UberShaderVertex.h"
@@ -50,21 +51,24 @@ ID3D11InputLayout* VertexShaderCache::GetClearInputLayout()
 }
 
 ID3D11Buffer* vscbuf = nullptr;
+static ConstantUploadTracker s_constants_tracker(sizeof(VertexShaderConstants));
 
 ID3D11Buffer*& VertexShaderCache::GetConstantBuffer()
 {
   // TODO: divide the global variables of the generated shaders into about 5 constant buffers to
   // speed this up
-  if (VertexShaderManager::dirty)
+  // The buffer keeps its contents if none of the values changed.
+  if (VertexShaderManager::dirty &&
+      s_constants_tracker.Update(&VertexShaderManager::constants))
   {
     D3D11_MAPPED_SUBRESOURCE map;
     D3D::context->Map(vscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
     memcpy(map.pData, &VertexShaderManager::constants, sizeof(VertexShaderConstants));
     D3D::context->Unmap(vscbuf, 0);
-    VertexShaderManager::dirty = false;
 
     ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(VertexShaderConstants));
   }
+  VertexShaderManager::dirty = false;
   return vscbuf;
 }
 
@@ -128,6 +132,7 @@ void VertexShaderCache::Init()
   HRESULT hr = D3D::device->CreateBuffer(&cbdesc, nullptr, &vscbuf);
   CHECK(hr == S_OK, "Create vertex shader constant buffer (size=%u)", cbsize);
   D3D::SetDebugObjectName(vscbuf, "vertex shader constant buffer used to emulate the GX pipeline");
+  s_constants_tracker.Invalidate();
 
   D3DBlob* blob;
   D3D::CompileVertexShader(simple_shader_code, &blob);
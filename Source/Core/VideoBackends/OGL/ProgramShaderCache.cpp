@@ -27,6 +27,7 @@
 #include "VideoBackends/OGL/VertexManager.h"
 
 #include "VideoCommon/AsyncShaderCompiler.h"
+#include "VideoCommon/ConstantUploadTracker.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/GeometryShaderManager.h"
@@ -48,6 +49,9 @@ GLuint ProgramShaderCache::s_attributeless_VAO = 0;
 GLuint ProgramShaderCache::s_last_VAO = 0;
 
 static std::unique_ptr<StreamBuffer> s_buffer;
+static ConstantUploadTracker s_vs_constants_tracker(sizeof(VertexShaderConstants));
+static ConstantUploadTracker s_gs_constants_tracker(sizeof(GeometryShaderConstants));
+static ConstantUploadTracker s_ps_constants_tracker(sizeof(PixelShaderConstants));
 static int num_failures = 0;
 
 static GLuint CurrentProgram = 0;
@@ -220,6 +224,9 @@ u32 ProgramShaderCache::GetUniformBufferAlignment()
 
 void ProgramShaderCache::InvalidateConstants()
 {
+  s_vs_constants_tracker.Invalidate();
+  s_gs_constants_tracker.Invalidate();
+  s_ps_constants_tracker.Invalidate();
   VertexShaderManager::dirty = true;
   GeometryShaderManager::dirty = true;
   PixelShaderManager::dirty = true;
@@ -229,6 +236,22 @@ void ProgramShaderCache::UploadConstants()
 {
   if (PixelShaderManager::dirty || VertexShaderManager::dirty || GeometryShaderManager::dirty)
   {
+    // The bound ranges are kept if none of the values changed. Otherwise all stages are uploaded
+    // together, as the stream buffer may orphan or overwrite the previous allocation on each map.
+    const bool ps_changed =
+        PixelShaderManager::dirty && s_ps_constants_tracker.Update(&PixelShaderManager::constants);
+    const bool vs_changed = VertexShaderManager::dirty &&
+                            s_vs_constants_tracker.Update(&VertexShaderManager::constants);
+    const bool gs_changed = GeometryShaderManager::dirty &&
+                            s_gs_constants_tracker.Update(&GeometryShaderManager::constants);
+
+    PixelShaderManager::dirty = false;
+    VertexShaderManager::dirty = false;
+    GeometryShaderManager::dirty = false;
+
+    if (!ps_changed && !vs_changed && !gs_changed)
+      return;
+
     auto buffer = s_buffer->Map(s_ubo_buffer_size, s_ubo_align);
 
     memcpy(buffer.first, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
@@ -251,10 +274,6 @@ void ProgramShaderCache::UploadConstants()
                           Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
                       sizeof(GeometryShaderConstants));
 
-    PixelShaderManager::dirty = false;
-    VertexShaderManager::dirty = false;
-    GeometryShaderManager::dirty = false;
-
     ADDSTAT(stats.thisFrame.bytesUniformStreamed, s_ubo_buffer_size);
   }
 }
@@ -488,6 +507,7 @@ void ProgramShaderCache::Init()
   // So multiply by four to get how many floats we have from vec4s
   // Then once more to get bytes
   s_buffer = StreamBuffer::Create(GL_UNIFORM_BUFFER, UBO_LENGTH);
+  InvalidateConstants();
 
   CreateHeader();
   CreateAttributelessVAO();
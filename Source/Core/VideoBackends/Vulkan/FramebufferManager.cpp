@@ -25,6 +25,7 @@
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace Vulkan
@@ -597,9 +598,49 @@ void FramebufferManager::DestroyConversionShaders()
   DestroyShader(m_ps_depth_resolve);
 }
 
+u32 FramebufferManager::GetPeekTile(u32 x, u32 y)
+{
+  return (y / EFB_PEEK_TILE_SIZE) * EFB_PEEK_TILES_WIDE + x / EFB_PEEK_TILE_SIZE;
+}
+
+VkRect2D FramebufferManager::GetPeekTileRect(u32 tile)
+{
+  const u32 x = (tile % EFB_PEEK_TILES_WIDE) * EFB_PEEK_TILE_SIZE;
+  const u32 y = (tile / EFB_PEEK_TILES_WIDE) * EFB_PEEK_TILE_SIZE;
+  const u32 width = std::min(EFB_PEEK_TILE_SIZE, EFB_WIDTH - x);
+  const u32 height = std::min(EFB_PEEK_TILE_SIZE, EFB_HEIGHT - y);
+  return {{static_cast<int>(x), static_cast<int>(y)}, {width, height}};
+}
+
+std::vector<u32> FramebufferManager::GetTilesToReadBack(ReadbackTiles* tiles, u32 tile)
+{
+  if (tiles->frame != frameCount)
+  {
+    tiles->peeked_last_frame = tiles->peeked;
+    tiles->peeked.fill(false);
+    tiles->frame = frameCount;
+  }
+  tiles->peeked[tile] = true;
+
+  if (tiles->valid[tile])
+    return {};
+
+  std::vector<u32> result = {tile};
+  if (g_ActiveConfig.bEFBPeekPrefetch)
+  {
+    for (u32 i = 0; i < EFB_PEEK_TILE_COUNT; i++)
+    {
+      if (i != tile && !tiles->valid[i] && (tiles->peeked[i] || tiles->peeked_last_frame[i]))
+        result.push_back(i);
+    }
+  }
+  return result;
+}
+
 u32 FramebufferManager::PeekEFBColor(u32 x, u32 y)
 {
-  if (!m_color_readback_texture_valid && !PopulateColorReadbackTexture())
+  const std::vector<u32> tiles = GetTilesToReadBack(&m_color_readback_tiles, GetPeekTile(x, y));
+  if (!tiles.empty() && !PopulateColorReadbackTiles(tiles))
     return 0;
 
   u32 value;
@@ -607,72 +648,92 @@ u32 FramebufferManager::PeekEFBColor(u32 x, u32 y)
   return value;
 }
 
-bool FramebufferManager::PopulateColorReadbackTexture()
+bool FramebufferManager::PopulateColorReadbackTiles(const std::vector<u32>& tiles)
 {
   // Can't be in our normal render pass.
   StateTracker::GetInstance()->EndRenderPass();
   StateTracker::GetInstance()->OnCPUEFBAccess();
 
-  // Issue a copy from framebuffer -> copy texture if we have >1xIR or MSAA on.
-  VkRect2D src_region = {{0, 0}, {GetEFBWidth(), GetEFBHeight()}};
-  Texture2D* src_texture = m_efb_color_texture.get();
-  if (GetEFBSamples() > 1)
-    src_texture = ResolveEFBColorTexture(src_region);
-
-  if (GetEFBWidth() != EFB_WIDTH || GetEFBHeight() != EFB_HEIGHT)
+  for (u32 tile : tiles)
   {
-    // Transition EFB to shader read before drawing.
+    const VkRect2D rect = GetPeekTileRect(tile);
+
+    // Issue a copy from framebuffer -> copy texture if we have >1xIR or MSAA on.
+    const int src_left = g_renderer->EFBToScaledX(rect.offset.x);
+    const int src_top = g_renderer->EFBToScaledY(rect.offset.y);
+    const int src_right =
+        g_renderer->EFBToScaledX(rect.offset.x + static_cast<int>(rect.extent.width));
+    const int src_bottom =
+        g_renderer->EFBToScaledY(rect.offset.y + static_cast<int>(rect.extent.height));
+    VkRect2D src_region = {{src_left, src_top},
+                           {static_cast<u32>(src_right - src_left),
+                            static_cast<u32>(src_bottom - src_top)}};
+    Texture2D* src_texture = m_efb_color_texture.get();
+    if (GetEFBSamples() > 1)
+      src_texture = ResolveEFBColorTexture(src_region);
+
+    if (GetEFBWidth() != EFB_WIDTH || GetEFBHeight() != EFB_HEIGHT)
+    {
+      // Transition EFB to shader read before drawing.
+      src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+      m_color_copy_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                               VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+      UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                             g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD),
+                             m_copy_color_render_pass, g_shader_cache->GetScreenQuadVertexShader(),
+                             VK_NULL_HANDLE, m_copy_color_shader);
+
+      // The quad covers the whole EFB, but only the pixels of the tile are drawn.
+      draw.BeginRenderPass(m_color_copy_framebuffer, rect);
+      draw.SetPSSampler(0, src_texture->GetView(), g_object_cache->GetPointSampler());
+      draw.SetViewportAndScissor(0, 0, EFB_WIDTH, EFB_HEIGHT);
+      vkCmdSetScissor(g_command_buffer_mgr->GetCurrentCommandBuffer(), 0, 1, &rect);
+      draw.DrawWithoutVertexBuffer(4);
+      draw.EndRenderPass();
+
+      // Restore EFB to color attachment, since we're done with it.
+      if (src_texture == m_efb_color_texture.get())
+      {
+        src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+      }
+
+      // Use this as a source texture now.
+      src_texture = m_color_copy_texture.get();
+    }
+
+    // Copy from EFB or copy texture to staging texture.
     src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    m_color_copy_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                           g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD),
-                           m_copy_color_render_pass, g_shader_cache->GetScreenQuadVertexShader(),
-                           VK_NULL_HANDLE, m_copy_color_shader);
-
-    VkRect2D rect = {{0, 0}, {EFB_WIDTH, EFB_HEIGHT}};
-    draw.BeginRenderPass(m_color_copy_framebuffer, rect);
-    draw.SetPSSampler(0, src_texture->GetView(), g_object_cache->GetPointSampler());
-    draw.SetViewportAndScissor(0, 0, EFB_WIDTH, EFB_HEIGHT);
-    draw.DrawWithoutVertexBuffer(4);
-    draw.EndRenderPass();
-
-    // Restore EFB to color attachment, since we're done with it.
+                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    const MathUtil::Rectangle<int> copy_rect(
+        rect.offset.x, rect.offset.y, rect.offset.x + static_cast<int>(rect.extent.width),
+        rect.offset.y + static_cast<int>(rect.extent.height));
+    static_cast<VKStagingTexture*>(m_color_readback_texture.get())
+        ->CopyFromTexture(src_texture, copy_rect, 0, 0, copy_rect);
+
+    // Restore original layout if we used the EFB as a source.
     if (src_texture == m_efb_color_texture.get())
     {
       src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     }
 
-    // Use this as a source texture now.
-    src_texture = m_color_copy_texture.get();
-  }
-
-  // Copy from EFB or copy texture to staging texture.
-  src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  static_cast<VKStagingTexture*>(m_color_readback_texture.get())
-      ->CopyFromTexture(src_texture, m_color_readback_texture->GetConfig().GetRect(), 0, 0,
-                        m_color_readback_texture->GetConfig().GetRect());
-
-  // Restore original layout if we used the EFB as a source.
-  if (src_texture == m_efb_color_texture.get())
-  {
-    src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    m_color_readback_tiles.valid[tile] = true;
   }
 
-  // Wait until the copy is complete.
+  // Wait until the copies are complete.
   m_color_readback_texture->Flush();
-  m_color_readback_texture_valid = true;
+  INCSTAT(stats.thisFrame.numEFBPeekStalls);
+  ADDSTAT(stats.thisFrame.numEFBPeekTilesRead, static_cast<int>(tiles.size()));
   return true;
 }
 
 float FramebufferManager::PeekEFBDepth(u32 x, u32 y)
 {
-  if (!m_depth_readback_texture_valid && !PopulateDepthReadbackTexture())
+  const std::vector<u32> tiles = GetTilesToReadBack(&m_depth_readback_tiles, GetPeekTile(x, y));
+  if (!tiles.empty() && !PopulateDepthReadbackTiles(tiles))
     return 0.0f;
 
   float value;
@@ -680,75 +741,94 @@ float FramebufferManager::PeekEFBDepth(u32 x, u32 y)
   return value;
 }
 
-bool FramebufferManager::PopulateDepthReadbackTexture()
+bool FramebufferManager::PopulateDepthReadbackTiles(const std::vector<u32>& tiles)
 {
   // Can't be in our normal render pass.
   StateTracker::GetInstance()->EndRenderPass();
   StateTracker::GetInstance()->OnCPUEFBAccess();
 
-  // Issue a copy from framebuffer -> copy texture if we have >1xIR or MSAA on.
-  VkRect2D src_region = {{0, 0}, {GetEFBWidth(), GetEFBHeight()}};
-  Texture2D* src_texture = m_efb_depth_texture.get();
-  if (GetEFBSamples() > 1)
-  {
-    // EFB depth resolves are written out as color textures
-    src_texture = ResolveEFBDepthTexture(src_region);
-  }
-  if (GetEFBWidth() != EFB_WIDTH || GetEFBHeight() != EFB_HEIGHT)
+  for (u32 tile : tiles)
   {
-    // Transition EFB to shader read before drawing.
+    const VkRect2D rect = GetPeekTileRect(tile);
+
+    // Issue a copy from framebuffer -> copy texture if we have >1xIR or MSAA on.
+    const int src_left = g_renderer->EFBToScaledX(rect.offset.x);
+    const int src_top = g_renderer->EFBToScaledY(rect.offset.y);
+    const int src_right =
+        g_renderer->EFBToScaledX(rect.offset.x + static_cast<int>(rect.extent.width));
+    const int src_bottom =
+        g_renderer->EFBToScaledY(rect.offset.y + static_cast<int>(rect.extent.height));
+    VkRect2D src_region = {{src_left, src_top},
+                           {static_cast<u32>(src_right - src_left),
+                            static_cast<u32>(src_bottom - src_top)}};
+    Texture2D* src_texture = m_efb_depth_texture.get();
+    if (GetEFBSamples() > 1)
+    {
+      // EFB depth resolves are written out as color textures
+      src_texture = ResolveEFBDepthTexture(src_region);
+    }
+    if (GetEFBWidth() != EFB_WIDTH || GetEFBHeight() != EFB_HEIGHT)
+    {
+      // Transition EFB to shader read before drawing.
+      src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+      m_depth_copy_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                               VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+      UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                             g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD),
+                             m_copy_depth_render_pass, g_shader_cache->GetScreenQuadVertexShader(),
+                             VK_NULL_HANDLE, m_copy_depth_shader);
+
+      // The quad covers the whole EFB, but only the pixels of the tile are drawn.
+      draw.BeginRenderPass(m_depth_copy_framebuffer, rect);
+      draw.SetPSSampler(0, src_texture->GetView(), g_object_cache->GetPointSampler());
+      draw.SetViewportAndScissor(0, 0, EFB_WIDTH, EFB_HEIGHT);
+      vkCmdSetScissor(g_command_buffer_mgr->GetCurrentCommandBuffer(), 0, 1, &rect);
+      draw.DrawWithoutVertexBuffer(4);
+      draw.EndRenderPass();
+
+      // Restore EFB to depth attachment, since we're done with it.
+      if (src_texture == m_efb_depth_texture.get())
+      {
+        src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+      }
+
+      // Use this as a source texture now.
+      src_texture = m_depth_copy_texture.get();
+    }
+
+    // Copy from EFB or copy texture to staging texture.
     src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    m_depth_copy_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                           g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD),
-                           m_copy_depth_render_pass, g_shader_cache->GetScreenQuadVertexShader(),
-                           VK_NULL_HANDLE, m_copy_depth_shader);
-
-    VkRect2D rect = {{0, 0}, {EFB_WIDTH, EFB_HEIGHT}};
-    draw.BeginRenderPass(m_depth_copy_framebuffer, rect);
-    draw.SetPSSampler(0, src_texture->GetView(), g_object_cache->GetPointSampler());
-    draw.SetViewportAndScissor(0, 0, EFB_WIDTH, EFB_HEIGHT);
-    draw.DrawWithoutVertexBuffer(4);
-    draw.EndRenderPass();
-
-    // Restore EFB to depth attachment, since we're done with it.
+                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    const MathUtil::Rectangle<int> copy_rect(
+        rect.offset.x, rect.offset.y, rect.offset.x + static_cast<int>(rect.extent.width),
+        rect.offset.y + static_cast<int>(rect.extent.height));
+    static_cast<VKStagingTexture*>(m_depth_readback_texture.get())
+        ->CopyFromTexture(src_texture, copy_rect, 0, 0, copy_rect);
+
+    // Restore original layout if we used the EFB as a source.
     if (src_texture == m_efb_depth_texture.get())
     {
       src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
                                       VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
     }
 
-    // Use this as a source texture now.
-    src_texture = m_depth_copy_texture.get();
-  }
-
-  // Copy from EFB or copy texture to staging texture.
-  src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  static_cast<VKStagingTexture*>(m_depth_readback_texture.get())
-      ->CopyFromTexture(src_texture, m_depth_readback_texture->GetConfig().GetRect(), 0, 0,
-                        m_depth_readback_texture->GetConfig().GetRect());
-
-  // Restore original layout if we used the EFB as a source.
-  if (src_texture == m_efb_depth_texture.get())
-  {
-    src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    m_depth_readback_tiles.valid[tile] = true;
   }
 
-  // Wait until the copy is complete.
+  // Wait until the copies are complete.
   m_depth_readback_texture->Flush();
-  m_depth_readback_texture_valid = true;
+  INCSTAT(stats.thisFrame.numEFBPeekStalls);
+  ADDSTAT(stats.thisFrame.numEFBPeekTilesRead, static_cast<int>(tiles.size()));
   return true;
 }
 
 void FramebufferManager::InvalidatePeekCache()
 {
-  m_color_readback_texture_valid = false;
-  m_depth_readback_texture_valid = false;
+  m_color_readback_tiles.valid.fill(false);
+  m_depth_readback_tiles.valid.fill(false);
 }
 
 bool FramebufferManager::CreateReadbackRenderPasses()
@@ -867,10 +947,10 @@ void FramebufferManager::DestroyReadbackTextures()
 {
   m_color_copy_texture.reset();
   m_color_readback_texture.reset();
-  m_color_readback_texture_valid = false;
+  m_color_readback_tiles.valid.fill(false);
   m_depth_copy_texture.reset();
   m_depth_readback_texture.reset();
-  m_depth_readback_texture_valid = false;
+  m_depth_readback_tiles.valid.fill(false);
 }
 
 bool FramebufferManager::CreateReadbackFramebuffer()
@@ -932,7 +1012,7 @@ void FramebufferManager::PokeEFBColor(u32 x, u32 y, u32 color)
   CreatePokeVertices(&m_color_poke_vertices, x, y, 0.0f, color);
 
   // Update the peek cache if it's valid, since we know the color of the pixel now.
-  if (m_color_readback_texture_valid)
+  if (m_color_readback_tiles.valid[GetPeekTile(x, y)])
     m_color_readback_texture->WriteTexel(x, y, &color);
 }
 
@@ -945,7 +1025,7 @@ void FramebufferManager::PokeEFBDepth(u32 x, u32 y, float depth)
   CreatePokeVertices(&m_depth_poke_vertices, x, y, depth, 0);
 
   // Update the peek cache if it's valid, since we know the color of the pixel now.
-  if (m_depth_readback_texture_valid)
+  if (m_depth_readback_tiles.valid[GetPeekTile(x, y)])
     m_depth_readback_texture->WriteTexel(x, y, &depth);
 }
 
@@ -4,14 +4,17 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
 #include "VideoBackends/Vulkan/TextureCache.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/RenderState.h"
+#include "VideoCommon/VideoCommon.h"
 
 class AbstractStagingTexture;
 
@@ -65,6 +68,8 @@ public:
   // Ensure ResolveEFBColorTexture is called before this method.
   Texture2D* GetResolvedEFBColorTexture() const { return m_efb_resolve_color_texture.get(); }
   // Reads a framebuffer value back from the GPU. This may block if the cache is not current.
+  // The cache is populated in tiles, and tiles which were peeked in the previous frame are read
+  // back along with the requested tile, so that a series of peeks only has to wait once.
   u32 PeekEFBColor(u32 x, u32 y);
   float PeekEFBDepth(u32 x, u32 y);
   void InvalidatePeekCache();
@@ -81,6 +86,23 @@ private:
     u32 color;
   };
 
+  static constexpr u32 EFB_PEEK_TILE_SIZE = 64;
+  static constexpr u32 EFB_PEEK_TILES_WIDE =
+      (EFB_WIDTH + EFB_PEEK_TILE_SIZE - 1) / EFB_PEEK_TILE_SIZE;
+  static constexpr u32 EFB_PEEK_TILES_HIGH =
+      (EFB_HEIGHT + EFB_PEEK_TILE_SIZE - 1) / EFB_PEEK_TILE_SIZE;
+  static constexpr u32 EFB_PEEK_TILE_COUNT = EFB_PEEK_TILES_WIDE * EFB_PEEK_TILES_HIGH;
+
+  struct ReadbackTiles
+  {
+    // Whether the tile in the readback texture matches the EFB.
+    std::array<bool, EFB_PEEK_TILE_COUNT> valid{};
+    // Which tiles were peeked in the current and in the previous frame.
+    std::array<bool, EFB_PEEK_TILE_COUNT> peeked{};
+    std::array<bool, EFB_PEEK_TILE_COUNT> peeked_last_frame{};
+    int frame = 0;
+  };
+
   bool CreateEFBRenderPasses();
   bool CreateEFBFramebuffer();
   void DestroyEFBFramebuffer();
@@ -102,8 +124,13 @@ private:
   bool CompilePokeShaders();
   void DestroyPokeShaders();
 
-  bool PopulateColorReadbackTexture();
-  bool PopulateDepthReadbackTexture();
+  static u32 GetPeekTile(u32 x, u32 y);
+  static VkRect2D GetPeekTileRect(u32 tile);
+  // Marks the tile as peeked, and returns the tiles that need to be read back if it isn't valid.
+  static std::vector<u32> GetTilesToReadBack(ReadbackTiles* tiles, u32 tile);
+
+  bool PopulateColorReadbackTiles(const std::vector<u32>& tiles);
+  bool PopulateDepthReadbackTiles(const std::vector<u32>& tiles);
 
   void CreatePokeVertices(std::vector<EFBPokeVertex>* destination_list, u32 x, u32 y, float z,
                           u32 color);
@@ -138,8 +165,8 @@ private:
   // CPU-side EFB readback texture
   std::unique_ptr<AbstractStagingTexture> m_color_readback_texture;
   std::unique_ptr<AbstractStagingTexture> m_depth_readback_texture;
-  bool m_color_readback_texture_valid = false;
-  bool m_depth_readback_texture_valid = false;
+  ReadbackTiles m_color_readback_tiles;
+  ReadbackTiles m_depth_readback_tiles;
 
   // EFB poke drawing setup
   std::unique_ptr<VertexFormat> m_poke_vertex_format;
@@ -36,6 +36,7 @@ ObjectCache::~ObjectCache()
 {
   DestroySamplers();
   DestroyPipelineLayouts();
+  DestroyDescriptorUpdateTemplates();
   DestroyDescriptorSetLayouts();
   DestroyRenderPassCache();
 }
@@ -45,6 +46,9 @@ bool ObjectCache::Initialize()
   if (!CreateDescriptorSetLayouts())
     return false;
 
+  if (g_vulkan_context->SupportsDescriptorUpdateTemplates())
+    CreateDescriptorUpdateTemplates();
+
   if (!CreatePipelineLayouts())
     return false;
 
@@ -183,6 +187,81 @@ void ObjectCache::DestroyDescriptorSetLayouts()
   }
 }
 
+void ObjectCache::CreateDescriptorUpdateTemplates()
+{
+  // The templates read the descriptors from arrays of buffer/image infos, indexed by binding.
+  // Like the layout, the UBO template doesn't include the GS binding if it isn't supported.
+  static const VkDescriptorUpdateTemplateEntryKHR per_stage_ubo_entries[] = {
+      {UBO_DESCRIPTOR_SET_BINDING_PS, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+       UBO_DESCRIPTOR_SET_BINDING_PS * sizeof(VkDescriptorBufferInfo),
+       sizeof(VkDescriptorBufferInfo)},
+      {UBO_DESCRIPTOR_SET_BINDING_VS, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+       UBO_DESCRIPTOR_SET_BINDING_VS * sizeof(VkDescriptorBufferInfo),
+       sizeof(VkDescriptorBufferInfo)},
+      {UBO_DESCRIPTOR_SET_BINDING_GS, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+       UBO_DESCRIPTOR_SET_BINDING_GS * sizeof(VkDescriptorBufferInfo),
+       sizeof(VkDescriptorBufferInfo)}};
+
+  static const VkDescriptorUpdateTemplateEntryKHR sampler_entries[] = {
+      {0, 0, static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+       0, sizeof(VkDescriptorImageInfo)}};
+
+  static const VkDescriptorUpdateTemplateEntryKHR ssbo_entries[] = {
+      {0, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0, sizeof(VkDescriptorBufferInfo)}};
+
+  struct TemplateInfo
+  {
+    DESCRIPTOR_SET_LAYOUT layout;
+    const VkDescriptorUpdateTemplateEntryKHR* entries;
+    u32 num_entries;
+  };
+  const TemplateInfo template_infos[] = {
+      {DESCRIPTOR_SET_LAYOUT_PER_STAGE_UNIFORM_BUFFERS, per_stage_ubo_entries,
+       static_cast<u32>(ArraySize(per_stage_ubo_entries)) -
+           (g_vulkan_context->SupportsGeometryShaders() ? 0 : 1)},
+      {DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS, sampler_entries,
+       static_cast<u32>(ArraySize(sampler_entries))},
+      {DESCRIPTOR_SET_LAYOUT_SHADER_STORAGE_BUFFERS, ssbo_entries,
+       static_cast<u32>(ArraySize(ssbo_entries))}};
+
+  for (const TemplateInfo& info : template_infos)
+  {
+    const VkDescriptorUpdateTemplateCreateInfoKHR create_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR,
+        nullptr,
+        0,
+        info.num_entries,
+        info.entries,
+        VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR,
+        m_descriptor_set_layouts[info.layout],
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        VK_NULL_HANDLE,
+        0};
+
+    // Not fatal, the state tracker writes the descriptors itself without a template.
+    VkResult res = vkCreateDescriptorUpdateTemplateKHR(g_vulkan_context->GetDevice(), &create_info,
+                                                       nullptr,
+                                                       &m_descriptor_update_templates[info.layout]);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkCreateDescriptorUpdateTemplateKHR failed: ");
+      m_descriptor_update_templates[info.layout] = VK_NULL_HANDLE;
+    }
+  }
+}
+
+void ObjectCache::DestroyDescriptorUpdateTemplates()
+{
+  for (VkDescriptorUpdateTemplateKHR update_template : m_descriptor_update_templates)
+  {
+    if (update_template != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorUpdateTemplateKHR(g_vulkan_context->GetDevice(), update_template,
+                                           nullptr);
+    }
+  }
+}
+
 bool ObjectCache::CreatePipelineLayouts()
 {
   VkResult res;
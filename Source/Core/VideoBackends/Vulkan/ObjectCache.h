@@ -40,6 +40,12 @@ public:
   {
     return m_descriptor_set_layouts[layout];
   }
+  // Descriptor update template accessor. Returns VK_NULL_HANDLE if the device doesn't support
+  // update templates, or the layout isn't used for game draws.
+  VkDescriptorUpdateTemplateKHR GetDescriptorUpdateTemplate(DESCRIPTOR_SET_LAYOUT layout) const
+  {
+    return m_descriptor_update_templates[layout];
+  }
   // Pipeline layout accessor. Used to fill in required field in PipelineInfo.
   VkPipelineLayout GetPipelineLayout(PIPELINE_LAYOUT layout) const
   {
@@ -81,6 +87,8 @@ public:
 private:
   bool CreateDescriptorSetLayouts();
   void DestroyDescriptorSetLayouts();
+  void CreateDescriptorUpdateTemplates();
+  void DestroyDescriptorUpdateTemplates();
   bool CreatePipelineLayouts();
   void DestroyPipelineLayouts();
   bool CreateUtilityShaderVertexFormat();
@@ -89,6 +97,8 @@ private:
   void DestroyRenderPassCache();
 
   std::array<VkDescriptorSetLayout, NUM_DESCRIPTOR_SET_LAYOUTS> m_descriptor_set_layouts = {};
+  std::array<VkDescriptorUpdateTemplateKHR, NUM_DESCRIPTOR_SET_LAYOUTS>
+      m_descriptor_update_templates = {};
   std::array<VkPipelineLayout, NUM_PIPELINE_LAYOUTS> m_pipeline_layouts = {};
 
   std::unique_ptr<VertexFormat> m_utility_shader_vertex_format;
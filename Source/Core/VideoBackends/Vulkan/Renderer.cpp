@@ -1135,8 +1135,10 @@ void Renderer::ResetSamplerStates()
     StateTracker::GetInstance()->SetSampler(i, g_object_cache->GetPointSampler());
   }
 
-  // Invalidate all sampler objects (some will be unused now).
+  // Invalidate all sampler objects (some will be unused now). New samplers can be created with
+  // the same handles, so don't reuse any of the descriptor sets which referenced the old ones.
   g_object_cache->ClearSamplerCache();
+  StateTracker::GetInstance()->InvalidateDescriptorSets();
 }
 
 void Renderer::SetInterlacingMode()
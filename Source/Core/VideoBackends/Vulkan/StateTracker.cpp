@@ -5,6 +5,7 @@
 #include "VideoBackends/Vulkan/StateTracker.h"
 
 #include <cstring>
+#include <xxhash.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -145,7 +146,17 @@ void StateTracker::SetPipeline(const VKPipeline* pipeline)
 
 void StateTracker::UpdateVertexShaderConstants()
 {
-  if (!VertexShaderManager::dirty || !ReserveConstantStorage())
+  if (!VertexShaderManager::dirty)
+    return;
+
+  // The previous upload can be bound again if none of the values changed.
+  if (!m_vs_constants_tracker.Update(&VertexShaderManager::constants))
+  {
+    VertexShaderManager::dirty = false;
+    return;
+  }
+
+  if (!ReserveConstantStorage())
     return;
 
   // Buffer allocation changed?
@@ -170,7 +181,17 @@ void StateTracker::UpdateVertexShaderConstants()
 
 void StateTracker::UpdateGeometryShaderConstants()
 {
-  if (!GeometryShaderManager::dirty || !ReserveConstantStorage())
+  if (!GeometryShaderManager::dirty)
+    return;
+
+  // The previous upload can be bound again if none of the values changed.
+  if (!m_gs_constants_tracker.Update(&GeometryShaderManager::constants))
+  {
+    GeometryShaderManager::dirty = false;
+    return;
+  }
+
+  if (!ReserveConstantStorage())
     return;
 
   // Buffer allocation changed?
@@ -195,7 +216,17 @@ void StateTracker::UpdateGeometryShaderConstants()
 
 void StateTracker::UpdatePixelShaderConstants()
 {
-  if (!PixelShaderManager::dirty || !ReserveConstantStorage())
+  if (!PixelShaderManager::dirty)
+    return;
+
+  // The previous upload can be bound again if none of the values changed.
+  if (!m_ps_constants_tracker.Update(&PixelShaderManager::constants))
+  {
+    PixelShaderManager::dirty = false;
+    return;
+  }
+
+  if (!ReserveConstantStorage())
     return;
 
   // Buffer allocation changed?
@@ -294,6 +325,10 @@ void StateTracker::UploadAllConstants()
 
   // Finally, flush buffer memory after copying
   m_uniform_stream_buffer->CommitMemory(allocation_size);
+  ADDSTAT(stats.thisFrame.bytesUniformStreamed, allocation_size);
+  m_vs_constants_tracker.Update(&VertexShaderManager::constants);
+  m_gs_constants_tracker.Update(&GeometryShaderManager::constants);
+  m_ps_constants_tracker.Update(&PixelShaderManager::constants);
 
   // Clear dirty flags
   VertexShaderManager::dirty = false;
@@ -346,11 +381,15 @@ void StateTracker::UnbindTexture(VkImageView view)
 void StateTracker::InvalidateDescriptorSets()
 {
   m_descriptor_sets.fill(VK_NULL_HANDLE);
+  m_sampler_descriptor_sets.clear();
   m_dirty_flags |= DIRTY_FLAG_ALL_DESCRIPTOR_SETS;
 }
 
 void StateTracker::InvalidateConstants()
 {
+  m_vs_constants_tracker.Invalidate();
+  m_gs_constants_tracker.Invalidate();
+  m_ps_constants_tracker.Invalidate();
   VertexShaderManager::dirty = true;
   GeometryShaderManager::dirty = true;
   PixelShaderManager::dirty = true;
@@ -638,10 +677,59 @@ void StateTracker::EndClearRenderPass()
   EndRenderPass();
 }
 
+size_t StateTracker::SamplerBindingKeyHash::operator()(const SamplerBindingKey& key) const
+{
+  return static_cast<size_t>(XXH64(key.data(), sizeof(key), 0));
+}
+
+VkDescriptorSet StateTracker::GetSamplerDescriptorSet()
+{
+  SamplerBindingKey key;
+  for (size_t i = 0; i < NUM_PIXEL_SHADER_SAMPLERS; i++)
+    key[i] = {m_bindings.ps_samplers[i].sampler, m_bindings.ps_samplers[i].imageView};
+
+  auto iter = m_sampler_descriptor_sets.find(key);
+  if (iter != m_sampler_descriptor_sets.end())
+  {
+    INCSTAT(stats.thisFrame.numDescriptorSetsReused);
+    return iter->second;
+  }
+
+  VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(
+      g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS));
+  if (set == VK_NULL_HANDLE)
+    return VK_NULL_HANDLE;
+
+  INCSTAT(stats.thisFrame.numDescriptorSetsAllocated);
+  VkDescriptorUpdateTemplateKHR update_template =
+      g_object_cache->GetDescriptorUpdateTemplate(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
+  if (update_template != VK_NULL_HANDLE)
+  {
+    vkUpdateDescriptorSetWithTemplateKHR(g_vulkan_context->GetDevice(), set, update_template,
+                                         m_bindings.ps_samplers.data());
+  }
+  else
+  {
+    VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                  nullptr,
+                                  set,
+                                  0,
+                                  0,
+                                  static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
+                                  VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                  m_bindings.ps_samplers.data(),
+                                  nullptr,
+                                  nullptr};
+    vkUpdateDescriptorSets(g_vulkan_context->GetDevice(), 1, &write, 0, nullptr);
+  }
+
+  m_sampler_descriptor_sets.emplace(key, set);
+  return set;
+}
+
 bool StateTracker::UpdateDescriptorSet()
 {
   const size_t MAX_DESCRIPTOR_WRITES = NUM_UBO_DESCRIPTOR_SET_BINDINGS +  // UBO
-                                       1 +                                // Samplers
                                        1;                                 // SSBO
   std::array<VkWriteDescriptorSet, MAX_DESCRIPTOR_WRITES> writes;
   u32 num_writes = 0;
@@ -655,21 +743,32 @@ bool StateTracker::UpdateDescriptorSet()
     if (set == VK_NULL_HANDLE)
       return false;
 
-    for (size_t i = 0; i < NUM_UBO_DESCRIPTOR_SET_BINDINGS; i++)
+    INCSTAT(stats.thisFrame.numDescriptorSetsAllocated);
+    VkDescriptorUpdateTemplateKHR update_template = g_object_cache->GetDescriptorUpdateTemplate(
+        DESCRIPTOR_SET_LAYOUT_PER_STAGE_UNIFORM_BUFFERS);
+    if (update_template != VK_NULL_HANDLE)
     {
-      if (i == UBO_DESCRIPTOR_SET_BINDING_GS && !g_vulkan_context->SupportsGeometryShaders())
-        continue;
-
-      writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                              nullptr,
-                              set,
-                              static_cast<uint32_t>(i),
-                              0,
-                              1,
-                              VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
-                              nullptr,
-                              &m_bindings.uniform_buffer_bindings[i],
-                              nullptr};
+      vkUpdateDescriptorSetWithTemplateKHR(g_vulkan_context->GetDevice(), set, update_template,
+                                           m_bindings.uniform_buffer_bindings.data());
+    }
+    else
+    {
+      for (size_t i = 0; i < NUM_UBO_DESCRIPTOR_SET_BINDINGS; i++)
+      {
+        if (i == UBO_DESCRIPTOR_SET_BINDING_GS && !g_vulkan_context->SupportsGeometryShaders())
+          continue;
+
+        writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                nullptr,
+                                set,
+                                static_cast<uint32_t>(i),
+                                0,
+                                1,
+                                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                nullptr,
+                                &m_bindings.uniform_buffer_bindings[i],
+                                nullptr};
+      }
     }
 
     m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_UNIFORM_BUFFERS] = set;
@@ -679,25 +778,15 @@ bool StateTracker::UpdateDescriptorSet()
   if (m_dirty_flags & DIRTY_FLAG_PS_SAMPLERS ||
       m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] == VK_NULL_HANDLE)
   {
-    VkDescriptorSetLayout layout =
-        g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
-    VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(layout);
+    VkDescriptorSet set = GetSamplerDescriptorSet();
     if (set == VK_NULL_HANDLE)
       return false;
 
-    writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                            nullptr,
-                            set,
-                            0,
-                            0,
-                            static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
-                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                            m_bindings.ps_samplers.data(),
-                            nullptr,
-                            nullptr};
-
-    m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
-    m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+    if (m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] != set)
+    {
+      m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
+      m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+    }
   }
 
   if (g_vulkan_context->SupportsBoundingBox() &&
@@ -710,16 +799,27 @@ bool StateTracker::UpdateDescriptorSet()
     if (set == VK_NULL_HANDLE)
       return false;
 
-    writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                            nullptr,
-                            set,
-                            0,
-                            0,
-                            1,
-                            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                            nullptr,
-                            &m_bindings.ps_ssbo,
-                            nullptr};
+    INCSTAT(stats.thisFrame.numDescriptorSetsAllocated);
+    VkDescriptorUpdateTemplateKHR update_template =
+        g_object_cache->GetDescriptorUpdateTemplate(DESCRIPTOR_SET_LAYOUT_SHADER_STORAGE_BUFFERS);
+    if (update_template != VK_NULL_HANDLE)
+    {
+      vkUpdateDescriptorSetWithTemplateKHR(g_vulkan_context->GetDevice(), set, update_template,
+                                           &m_bindings.ps_ssbo);
+    }
+    else
+    {
+      writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                              nullptr,
+                              set,
+                              0,
+                              0,
+                              1,
+                              VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                              nullptr,
+                              &m_bindings.ps_ssbo,
+                              nullptr};
+    }
 
     m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_STORAGE_OR_TEXEL_BUFFER] = set;
     m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
@@ -7,10 +7,14 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
 #include "VideoBackends/Vulkan/ShaderCache.h"
+#include "VideoCommon/ConstantManager.h"
+#include "VideoCommon/ConstantUploadTracker.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
 
@@ -133,6 +137,7 @@ private:
   bool IsViewportWithinRenderArea() const;
 
   bool UpdateDescriptorSet();
+  VkDescriptorSet GetSamplerDescriptorSet();
 
   // Allocates storage in the uniform buffer of the specified size. If this storage cannot be
   // allocated immediately, the current command buffer will be submitted and all stage's
@@ -168,12 +173,28 @@ private:
   size_t m_uniform_buffer_reserve_size = 0;
   u32 m_num_active_descriptor_sets = 0;
 
+  // Sampler descriptor sets which have already been written in the current command buffer, keyed
+  // by the sampler and image view of each binding. Games tend to switch between a small number of
+  // texture combinations, so most changes can be handled by binding an existing set again. The
+  // sets come from the command buffer's descriptor pool, so the cache is cleared with it.
+  using SamplerBindingKey =
+      std::array<std::pair<VkSampler, VkImageView>, NUM_PIXEL_SHADER_SAMPLERS>;
+  struct SamplerBindingKeyHash
+  {
+    size_t operator()(const SamplerBindingKey& key) const;
+  };
+  std::unordered_map<SamplerBindingKey, VkDescriptorSet, SamplerBindingKeyHash>
+      m_sampler_descriptor_sets;
+
   // rasterization
   VkViewport m_viewport = {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
   VkRect2D m_scissor = {{0, 0}, {1, 1}};
 
   // uniform buffers
   std::unique_ptr<StreamBuffer> m_uniform_stream_buffer;
+  ConstantUploadTracker m_vs_constants_tracker{sizeof(VertexShaderConstants)};
+  ConstantUploadTracker m_gs_constants_tracker{sizeof(GeometryShaderConstants)};
+  ConstantUploadTracker m_ps_constants_tracker{sizeof(PixelShaderConstants)};
 
   VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
   VkRenderPass m_load_render_pass = VK_NULL_HANDLE;
@@ -418,6 +418,9 @@ bool VulkanContext::SelectDeviceExtensions(ExtensionList* extension_list, bool e
   if (enable_surface && !SupportsExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, true))
     return false;
 
+  m_supports_descriptor_update_templates =
+      SupportsExtension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME, false);
+
   return true;
 }
 
@@ -598,6 +601,13 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
   if (!LoadVulkanDeviceFunctions(m_device))
     return false;
 
+  // Only use update templates if all of the entry points were found.
+  if (!vkCreateDescriptorUpdateTemplateKHR || !vkDestroyDescriptorUpdateTemplateKHR ||
+      !vkUpdateDescriptorSetWithTemplateKHR)
+  {
+    m_supports_descriptor_update_templates = false;
+  }
+
   // Grab the graphics and present queues.
   vkGetDeviceQueue(m_device, m_graphics_queue_family_index, 0, &m_graphics_queue);
   if (surface)
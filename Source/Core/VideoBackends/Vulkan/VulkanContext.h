@@ -83,6 +83,7 @@ public:
   {
     return m_device_features.occlusionQueryPrecise == VK_TRUE;
   }
+  bool SupportsDescriptorUpdateTemplates() const { return m_supports_descriptor_update_templates; }
 
   // Helpers for getting constants
   VkDeviceSize GetUniformBufferAlignment() const
@@ -131,6 +132,8 @@ private:
   VkPhysicalDeviceFeatures m_device_features = {};
   VkPhysicalDeviceProperties m_device_properties = {};
   VkPhysicalDeviceMemoryProperties m_device_memory_properties = {};
+
+  bool m_supports_descriptor_update_templates = false;
 };
 
 extern std::unique_ptr<VulkanContext> g_vulkan_context;
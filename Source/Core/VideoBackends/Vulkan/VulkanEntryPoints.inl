@@ -194,4 +194,8 @@ VULKAN_DEVICE_ENTRY_POINT(vkGetSwapchainImagesKHR, false)
 VULKAN_DEVICE_ENTRY_POINT(vkAcquireNextImageKHR, false)
 VULKAN_DEVICE_ENTRY_POINT(vkQueuePresentKHR, false)
 
+VULKAN_DEVICE_ENTRY_POINT(vkCreateDescriptorUpdateTemplateKHR, false)
+VULKAN_DEVICE_ENTRY_POINT(vkDestroyDescriptorUpdateTemplateKHR, false)
+VULKAN_DEVICE_ENTRY_POINT(vkUpdateDescriptorSetWithTemplateKHR, false)
+
 #endif		// VULKAN_DEVICE_ENTRY_POINT
@@ -6,20 +6,29 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
 #include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
+#include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/WorkQueueThread.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/SystemTimers.h"
@@ -43,6 +52,36 @@ static AVFrame* s_src_frame = nullptr;
 static AVFrame* s_scaled_frame = nullptr;
 static AVPixelFormat s_pix_fmt = AV_PIX_FMT_BGR24;
 static SwsContext* s_sws_context = nullptr;
+// Unless the frame is scaled, the conversion to the pixel format of the encoder is split into
+// horizontal bands, which are converted in parallel by worker threads, each with its own context.
+// The chroma planes are subsampled with a filter that reaches beyond a pair of rows, so every band
+// converts a few rows of its neighbours as well, and only keeps its own rows. Otherwise the chroma
+// would differ from a conversion of the whole frame at the band boundaries.
+struct ConversionBand
+{
+  SwsContext* context = nullptr;
+  // The converted rows, including the ones of the neighbours.
+  u8* data[4] = {};
+  int linesize[4] = {};
+  int buffer_rows = 0;
+  int top = 0;
+  int bottom = 0;
+  Common::Event done;
+};
+static constexpr int MAX_CONVERSION_BANDS = 4;
+static constexpr int MIN_CONVERSION_BAND_HEIGHT = 64;
+// Rows converted beyond each side of a band. This is more than the support of the chroma filter,
+// and even, so that the chroma rows of the band line up with the ones of the frame.
+static constexpr int CONVERSION_BAND_OVERLAP = 16;
+static std::array<ConversionBand, MAX_CONVERSION_BANDS> s_conversion_bands;
+struct FrameSize
+{
+  int width;
+  int height;
+};
+// The first band is converted by the thread that dumps the frames, the others by these.
+static std::array<std::unique_ptr<Common::WorkQueueThread<FrameSize>>, MAX_CONVERSION_BANDS - 1>
+    s_conversion_threads;
 static int s_width;
 static int s_height;
 static u64 s_last_frame;
@@ -192,6 +231,8 @@ bool AVIDump::CreateVideoFile()
   s_codec_context->time_base.den = VideoInterface::GetTargetRefreshRate();
   s_codec_context->gop_size = 12;
   s_codec_context->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
+  // Let the encoder pick the number of threads, for the codecs that support threading.
+  s_codec_context->thread_count = 0;
 
   if (output_format->flags & AVFMT_GLOBALHEADER)
     s_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -295,6 +336,120 @@ static void WritePacket(AVPacket& pkt)
   av_interleaved_write_frame(s_format_context, &pkt);
 }
 
+static void FreeConversionContexts()
+{
+  for (auto& thread : s_conversion_threads)
+    thread.reset();
+
+  sws_freeContext(s_sws_context);
+  s_sws_context = nullptr;
+  for (ConversionBand& band : s_conversion_bands)
+  {
+    sws_freeContext(band.context);
+    band.context = nullptr;
+    av_freep(&band.data[0]);
+    band.buffer_rows = 0;
+  }
+}
+
+// Converts the rows of the band, and copies them to the scaled frame. The frame isn't scaled.
+static void ConvertBand(ConversionBand& band, int width, int height)
+{
+  if (band.bottom <= band.top)
+    return;
+
+  const int src_top = std::max(band.top - CONVERSION_BAND_OVERLAP, 0);
+  const int src_bottom = std::min(band.bottom + CONVERSION_BAND_OVERLAP, height);
+  const int rows = src_bottom - src_top;
+  const AVPixelFormat dst_format = s_codec_context->pix_fmt;
+  band.context = sws_getCachedContext(band.context, width, rows, s_pix_fmt, width, rows, dst_format,
+                                      SWS_BICUBIC, nullptr, nullptr, nullptr);
+  if (!band.context)
+    return;
+
+  if (rows > band.buffer_rows)
+  {
+    av_freep(&band.data[0]);
+    band.buffer_rows = 0;
+    if (av_image_alloc(band.data, band.linesize, width, rows, dst_format, 1) < 0)
+      return;
+    band.buffer_rows = rows;
+  }
+
+  const u8* src_data[4] = {s_src_frame->data[0] + src_top * s_src_frame->linesize[0]};
+  const int src_linesize[4] = {s_src_frame->linesize[0]};
+  sws_scale(band.context, src_data, src_linesize, 0, rows, band.data, band.linesize);
+
+  const AVPixFmtDescriptor* dst_desc = av_pix_fmt_desc_get(dst_format);
+  for (int plane = 0; plane < 4 && s_scaled_frame->data[plane]; plane++)
+  {
+    // The chroma planes are subsampled vertically. The band boundaries are on even rows, except
+    // for the bottom of the frame, where the last chroma row may only cover one row.
+    const bool chroma = plane == 1 || plane == 2;
+    const int shift = chroma ? dst_desc->log2_chroma_h : 0;
+    const int dst_top = band.top >> shift;
+    const int dst_bottom = -((-band.bottom) >> shift);
+    const int skipped_rows = (band.top - src_top) >> shift;
+    av_image_copy_plane(s_scaled_frame->data[plane] + dst_top * s_scaled_frame->linesize[plane],
+                        s_scaled_frame->linesize[plane],
+                        band.data[plane] + skipped_rows * band.linesize[plane],
+                        band.linesize[plane], av_image_get_linesize(dst_format, width, plane),
+                        dst_bottom - dst_top);
+  }
+}
+
+static void ConvertFrame(int width, int height)
+{
+  // The frame can only be split into bands if it has the size of the video. The sizes only differ
+  // if the VI disabled the output with a zero width or height, see CheckResolution.
+  int bands = 1;
+  if (width == s_width && height == s_height)
+  {
+    const int threads = static_cast<int>(std::thread::hardware_concurrency());
+    bands = MathUtil::Clamp(height / MIN_CONVERSION_BAND_HEIGHT, 1,
+                            MathUtil::Clamp(threads, 1, MAX_CONVERSION_BANDS));
+  }
+
+  if (bands == 1)
+  {
+    s_sws_context =
+        sws_getCachedContext(s_sws_context, width, height, s_pix_fmt, s_width, s_height,
+                             s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    if (s_sws_context)
+    {
+      sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, height,
+                s_scaled_frame->data, s_scaled_frame->linesize);
+    }
+    return;
+  }
+
+  // Band boundaries have to be on even rows for the subsampled chroma planes.
+  const int band_height = ((height + bands - 1) / bands + 1) & ~1;
+  for (int i = 0; i < bands; i++)
+  {
+    s_conversion_bands[i].top = std::min(i * band_height, height);
+    s_conversion_bands[i].bottom = std::min((i + 1) * band_height, height);
+  }
+
+  for (int i = 1; i < bands; i++)
+  {
+    auto& thread = s_conversion_threads[i - 1];
+    if (!thread)
+    {
+      ConversionBand* band = &s_conversion_bands[i];
+      thread = std::make_unique<Common::WorkQueueThread<FrameSize>>([band](FrameSize size) {
+        ConvertBand(*band, size.width, size.height);
+        band->done.Set();
+      });
+    }
+    thread->EmplaceItem(FrameSize{width, height});
+  }
+
+  ConvertBand(s_conversion_bands[0], width, height);
+  for (int i = 1; i < bands; i++)
+    s_conversion_bands[i].done.Wait();
+}
+
 void AVIDump::AddFrame(const u8* data, int width, int height, int stride, const Frame& state)
 {
   // Assume that the timing is valid, if the savestate id of the new frame
@@ -313,14 +468,7 @@ void AVIDump::AddFrame(const u8* data, int width, int height, int stride, const
   s_src_frame->height = s_height;
 
   // Convert image from {BGR24, RGBA} to desired pixel format
-  s_sws_context =
-      sws_getCachedContext(s_sws_context, width, height, s_pix_fmt, s_width, s_height,
-                           s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-  if (s_sws_context)
-  {
-    sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, height,
-              s_scaled_frame->data, s_scaled_frame->linesize);
-  }
+  ConvertFrame(width, height);
 
   // Encode and write the image.
   AVPacket pkt;
@@ -410,11 +558,7 @@ void AVIDump::CloseVideoFile()
   avformat_free_context(s_format_context);
   s_format_context = nullptr;
 
-  if (s_sws_context)
-  {
-    sws_freeContext(s_sws_context);
-    s_sws_context = nullptr;
-  }
+  FreeConversionContexts();
 }
 
 void AVIDump::DoState()
@@ -0,0 +1,101 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Index of values that cover ranges of guest memory, for finding all of the values which overlap
+// a given range.
+//
+// The address space is split into pages, and each value is listed in the bucket of every page
+// that its range touches. A query only has to look at the buckets of the pages it covers, so it
+// doesn't depend on the number of values elsewhere in memory, or on the size of the largest value.
+// Buckets are never freed, so once the index has warmed up, inserting and removing values doesn't
+// allocate memory.
+template <typename T, u32 page_shift = 16>
+class AddressRangeIndex
+{
+public:
+  // Adds a value which covers size bytes starting at address. Values with a size of zero are
+  // treated as covering a single byte, so they can still be found at their address.
+  void Insert(u32 address, u32 size, const T& value)
+  {
+    const Item item{address, GetEnd(address, size), value};
+    for (u32 page = GetPage(item.start); page <= GetPage(item.end - 1); ++page)
+      m_pages[page].push_back(item);
+    m_size++;
+  }
+
+  // Removes a value, which must have been inserted with the same range.
+  void Remove(u32 address, u32 size, const T& value)
+  {
+    const u64 end = GetEnd(address, size);
+    for (u32 page = GetPage(address); page <= GetPage(end - 1); ++page)
+    {
+      std::vector<Item>& bucket = m_pages[page];
+      auto iter = std::find_if(bucket.begin(), bucket.end(),
+                               [&value](const Item& item) { return item.value == value; });
+      if (iter == bucket.end())
+        continue;
+
+      *iter = bucket.back();
+      bucket.pop_back();
+    }
+    m_size--;
+  }
+
+  void Clear()
+  {
+    for (auto& page : m_pages)
+      page.second.clear();
+    m_size = 0;
+  }
+
+  size_t Size() const { return m_size; }
+
+  // Calls func once for each value whose range overlaps the given one, in no particular order.
+  template <typename Func>
+  void ForEachOverlapping(u32 address, u32 size, Func func) const
+  {
+    const u64 end = GetEnd(address, size);
+    const u32 first_page = GetPage(address);
+    for (u32 page = first_page; page <= GetPage(end - 1); ++page)
+    {
+      auto bucket = m_pages.find(page);
+      if (bucket == m_pages.end())
+        continue;
+
+      for (const Item& item : bucket->second)
+      {
+        // Values which cover several of the pages are only reported from the first one.
+        if (item.start >= end || item.end <= address ||
+            page != std::max(first_page, GetPage(item.start)))
+        {
+          continue;
+        }
+        func(item.value);
+      }
+    }
+  }
+
+private:
+  struct Item
+  {
+    u32 start;
+    u64 end;
+    T value;
+  };
+
+  static u32 GetPage(u64 address) { return static_cast<u32>(address >> page_shift); }
+  static u64 GetEnd(u32 address, u32 size) { return u64{address} + std::max<u32>(size, 1); }
+
+  std::unordered_map<u32, std::vector<Item>> m_pages;
+  size_t m_size = 0;
+};
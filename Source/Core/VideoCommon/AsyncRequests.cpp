@@ -7,6 +7,7 @@
 #include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -144,7 +145,9 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
     break;
 
   case Event::BBOX_READ:
-    *e.bbox.data = g_renderer->BBoxRead(e.bbox.index);
+    for (int i = 0; i < 4; ++i)
+      e.bbox.data[i] = g_renderer->BBoxRead(i);
+    INCSTAT(stats.thisFrame.numBBoxReadbacks);
     break;
 
   case Event::PERF_QUERY:
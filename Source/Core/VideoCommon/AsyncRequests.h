@@ -55,9 +55,9 @@ public:
         u32 fbHeight;
       } swap_event;
 
+      // Reads all four values.
       struct
       {
-        int index;
         u16* data;
       } bbox;
 
@@ -6,9 +6,14 @@
 #include <thread>
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
+#include "Common/PerfMetrics.h"
 
 namespace VideoCommon
 {
+// Time from queueing a work item until a worker thread starts compiling it.
+static PerfMetrics::Histogram s_queue_latency("shadercompiler.queue_latency_us");
+static PerfMetrics::Counter s_cancelled_items("shadercompiler.cancelled");
+
 AsyncShaderCompiler::AsyncShaderCompiler()
 {
 }
@@ -20,28 +25,121 @@ AsyncShaderCompiler::~AsyncShaderCompiler()
   ASSERT(!HasWorkerThreads());
 }
 
-void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
+AsyncShaderCompiler::WorkItemId AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
+{
+  return AddPendingWorkItem(std::move(item), priority, {}, false);
+}
+
+AsyncShaderCompiler::WorkItemId
+AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority, Clock::time_point deadline)
+{
+  return AddPendingWorkItem(std::move(item), priority, deadline, true);
+}
+
+AsyncShaderCompiler::PendingWorkKey
+AsyncShaderCompiler::GetPendingWorkKey(u32 priority, Clock::time_point queue_time) const
+{
+  const s64 queue_time_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(queue_time.time_since_epoch()).count();
+  if (priority < m_priority_aging_limit)
+    return {priority, queue_time_us};
+
+  return {m_priority_aging_limit, priority * PRIORITY_AGING_INTERVAL_US + queue_time_us};
+}
+
+AsyncShaderCompiler::WorkItemId
+AsyncShaderCompiler::AddPendingWorkItem(WorkItemPtr item, u32 priority, Clock::time_point deadline,
+                                        bool has_deadline)
 {
   // If no worker threads are available, compile synchronously.
   if (!HasWorkerThreads())
   {
     item->Compile();
     m_completed_work.push_back(std::move(item));
+    return 0;
   }
-  else
+
+  const Clock::time_point now = Clock::now();
+  const PendingWorkKey key = GetPendingWorkKey(priority, now);
+
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  const WorkItemId id = m_next_work_item_id++;
+  auto iter = m_pending_work.emplace(
+      key, PendingWorkItem{id, std::move(item), now, deadline, has_deadline});
+  m_pending_work_by_id.emplace(id, iter);
+  if (has_deadline)
+    m_pending_work_with_deadline++;
+  m_worker_thread_wake.notify_one();
+  return id;
+}
+
+void AsyncShaderCompiler::PromoteWorkItem(WorkItemId id, u32 priority)
+{
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  auto id_iter = m_pending_work_by_id.find(id);
+  if (id_iter == m_pending_work_by_id.end())
+    return;
+
+  auto iter = id_iter->second;
+  const PendingWorkKey key = GetPendingWorkKey(priority, iter->second.queue_time);
+  if (key >= iter->first)
+    return;
+
+  PendingWorkItem work = std::move(iter->second);
+  m_pending_work.erase(iter);
+  if (work.has_deadline)
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
-    m_worker_thread_wake.notify_one();
+    work.has_deadline = false;
+    m_pending_work_with_deadline--;
+  }
+  id_iter->second = m_pending_work.emplace(key, std::move(work));
+}
+
+AsyncShaderCompiler::PendingWorkMap::iterator
+AsyncShaderCompiler::ErasePendingWorkItem(PendingWorkMap::iterator iter)
+{
+  m_pending_work_by_id.erase(iter->second.id);
+  if (iter->second.has_deadline)
+    m_pending_work_with_deadline--;
+  return m_pending_work.erase(iter);
+}
+
+void AsyncShaderCompiler::CancelExpiredWorkItems(Clock::time_point now)
+{
+  for (auto iter = m_pending_work.begin();
+       m_pending_work_with_deadline > 0 && iter != m_pending_work.end();)
+  {
+    if (!iter->second.has_deadline || iter->second.deadline > now)
+    {
+      ++iter;
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
+      m_cancelled_work.push_back(std::move(iter->second.item));
+    }
+    s_cancelled_items.Add();
+    iter = ErasePendingWorkItem(iter);
   }
 }
 
 void AsyncShaderCompiler::RetrieveWorkItems()
 {
+  // Cancel the expired work items here as well, the worker threads only notice them once they
+  // get to them, which may take a while for work items with a low priority.
+  {
+    std::lock_guard<std::mutex> guard(m_pending_work_lock);
+    if (m_pending_work_with_deadline > 0)
+      CancelExpiredWorkItems(Clock::now());
+  }
+
   std::deque<WorkItemPtr> completed_work;
+  std::deque<WorkItemPtr> cancelled_work;
   {
     std::lock_guard<std::mutex> guard(m_completed_work_lock);
     m_completed_work.swap(completed_work);
+    m_cancelled_work.swap(cancelled_work);
   }
 
   while (!completed_work.empty())
@@ -49,6 +147,12 @@ void AsyncShaderCompiler::RetrieveWorkItems()
     completed_work.front()->Retrieve();
     completed_work.pop_front();
   }
+
+  while (!cancelled_work.empty())
+  {
+    cancelled_work.front()->Cancel();
+    cancelled_work.pop_front();
+  }
 }
 
 bool AsyncShaderCompiler::HasPendingWork()
@@ -60,7 +164,7 @@ bool AsyncShaderCompiler::HasPendingWork()
 bool AsyncShaderCompiler::HasCompletedWork()
 {
   std::lock_guard<std::mutex> guard(m_completed_work_lock);
-  return !m_completed_work.empty();
+  return !m_completed_work.empty() || !m_cancelled_work.empty();
 }
 
 void AsyncShaderCompiler::WaitUntilCompletion()
@@ -89,7 +193,7 @@ void AsyncShaderCompiler::WaitUntilCompletion(
   // Grab the number of pending items. We use this to work out how many are left.
   size_t total_items = 0;
   {
-    // Safe to hold both locks here, since nowhere else does.
+    // Safe to hold both locks here, since they are always taken in this order.
     std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
     std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
     total_items = m_completed_work.size() + m_pending_work.size() + m_busy_workers.load() + 1;
@@ -214,14 +318,26 @@ void AsyncShaderCompiler::WorkerThreadRun()
   std::unique_lock<std::mutex> pending_lock(m_pending_work_lock);
   while (!m_exit_flag.IsSet())
   {
-    m_worker_thread_wake.wait(pending_lock);
+    // Work may have been queued before this thread started waiting.
+    m_worker_thread_wake.wait(pending_lock,
+                              [this] { return !m_pending_work.empty() || m_exit_flag.IsSet(); });
 
     while (!m_pending_work.empty() && !m_exit_flag.IsSet())
     {
-      m_busy_workers++;
+      const Clock::time_point now = Clock::now();
       auto iter = m_pending_work.begin();
-      WorkItemPtr item(std::move(iter->second));
-      m_pending_work.erase(iter);
+      if (iter->second.has_deadline && iter->second.deadline <= now)
+      {
+        CancelExpiredWorkItems(now);
+        continue;
+      }
+
+      m_busy_workers++;
+      WorkItemPtr item(std::move(iter->second.item));
+      s_queue_latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                 now - iter->second.queue_time)
+                                 .count());
+      ErasePendingWorkItem(iter);
       pending_lock.unlock();
 
       if (item->Compile())
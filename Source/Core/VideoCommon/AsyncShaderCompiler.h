@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -12,6 +13,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -30,9 +32,20 @@ public:
     virtual ~WorkItem() = default;
     virtual bool Compile() = 0;
     virtual void Retrieve() = 0;
+
+    // Called instead of Compile and Retrieve, on the thread that retrieves the work items, if the
+    // deadline of the work item passed before a worker thread started compiling it.
+    virtual void Cancel() {}
   };
 
   using WorkItemPtr = std::unique_ptr<WorkItem>;
+  using WorkItemId = u64;
+  using Clock = std::chrono::steady_clock;
+
+  // The priority of a waiting work item improves by one every interval, in microseconds. Work
+  // items which keep getting queued at a lower value therefore can't hold back the others forever.
+  // Aging stops at the limit set with SetPriorityAgingLimit.
+  static constexpr s64 PRIORITY_AGING_INTERVAL_US = 10000;
 
   AsyncShaderCompiler();
   virtual ~AsyncShaderCompiler();
@@ -43,9 +56,19 @@ public:
     return std::make_unique<T>(std::forward<Params>(params)...);
   }
 
+  // Work items with a priority below the limit don't age, and are always compiled before the
+  // others, which can't age past the limit. Must be called before any work is queued.
+  void SetPriorityAgingLimit(u32 priority) { m_priority_aging_limit = priority; }
+
   // Queues a new work item to the compiler threads. The lower the priority, the sooner
   // this work item will be compiled, relative to the other work items.
-  void QueueWorkItem(WorkItemPtr item, u32 priority);
+  WorkItemId QueueWorkItem(WorkItemPtr item, u32 priority);
+  // Same, but the work item is cancelled if it is still waiting at the deadline, for work that is
+  // only useful for a while, like pipelines which may be needed soon.
+  WorkItemId QueueWorkItem(WorkItemPtr item, u32 priority, Clock::time_point deadline);
+  // Moves a work item which is still waiting ahead, as if it had been queued at the given priority,
+  // and removes its deadline. Does nothing if it would end up further back than it already is.
+  void PromoteWorkItem(WorkItemId id, u32 priority);
   void RetrieveWorkItems();
   bool HasPendingWork();
   bool HasCompletedWork();
@@ -68,6 +91,29 @@ protected:
   virtual void WorkerThreadExit(void* param);
 
 private:
+  struct PendingWorkItem
+  {
+    WorkItemId id;
+    WorkItemPtr item;
+    Clock::time_point queue_time;
+    Clock::time_point deadline;
+    bool has_deadline;
+  };
+
+  // The priority band, which is the priority below the aging limit and the limit otherwise, and
+  // the order within the band.
+  using PendingWorkKey = std::pair<u32, s64>;
+  using PendingWorkMap = std::multimap<PendingWorkKey, PendingWorkItem>;
+
+  PendingWorkKey GetPendingWorkKey(u32 priority, Clock::time_point queue_time) const;
+  WorkItemId AddPendingWorkItem(WorkItemPtr item, u32 priority, Clock::time_point deadline,
+                                bool has_deadline);
+  // Must be called with m_pending_work_lock held.
+  PendingWorkMap::iterator ErasePendingWorkItem(PendingWorkMap::iterator iter);
+  // Moves the waiting work items which are past their deadline to the cancelled work.
+  // Must be called with m_pending_work_lock held.
+  void CancelExpiredWorkItems(Clock::time_point now);
+
   void WorkerThreadEntryPoint(void* param);
   void WorkerThreadRun();
 
@@ -79,12 +125,20 @@ private:
 
   // A multimap is used to store the work items. We can't use a priority_queue here, because
   // there's no way to obtain a non-const reference, which we need for the unique_ptr.
-  std::multimap<u32, WorkItemPtr> m_pending_work;
+  // Within the aging band, the key is the priority in aging intervals plus the queue time, which
+  // orders the work items the same way as their aged priorities would, without having to update
+  // them.
+  PendingWorkMap m_pending_work;
+  std::unordered_map<WorkItemId, PendingWorkMap::iterator> m_pending_work_by_id;
+  size_t m_pending_work_with_deadline = 0;
+  u32 m_priority_aging_limit = 0;
+  WorkItemId m_next_work_item_id = 1;
   std::mutex m_pending_work_lock;
   std::condition_variable m_worker_thread_wake;
   std::atomic_size_t m_busy_workers{0};
 
   std::deque<WorkItemPtr> m_completed_work;
+  std::deque<WorkItemPtr> m_cancelled_work;
   std::mutex m_completed_work_lock;
 };
 
@@ -21,14 +21,17 @@
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/DeferredBPWrites.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -38,657 +41,755 @@ using namespace BPFunctions;
 
 static const float s_gammaLUT[] = {1.0f, 1.7f, 2.2f, 1.0f};
 
+static DeferredBPWrites s_deferred_writes;
+
 void BPInit()
 {
   memset(&bpmem, 0, sizeof(bpmem));
   bpmem.bpMask = 0xFFFFFF;
+
+  s_deferred_writes.Clear();
 }
 
-static void BPWritten(const BPCmd& bp)
+// Writes to the BP registers (Bypass Raster State Registers, controlling the register groups
+// RAS1/2, SU, TF, TEV, C/Z and PEC) are dispatched through a table with a handler for each
+// register, which is built at compile time. Handlers are only called after the pipeline has
+// been flushed and the new value has been stored in bpmem.
+using BPHandler = void (*)(const BPCmd& bp);
+
+static void BPGenModeWritten(const BPCmd& bp)
 {
-  /*
-  ----------------------------------------------------------------------------------------------------------------
-  Purpose: Writes to the BP registers
-  Called: At the end of every: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg
-  How It Works: First the pipeline is flushed then update the bpmem with the new value.
-          Some of the BP cases have to call certain functions while others just update the bpmem.
-          some bp cases check the changes variable, because they might not have to be updated all
-  the time
-  NOTE: it seems not all bp cases like checking changes, so calling if (bp.changes == 0 ? false :
-  true)
-      had to be ditched and the games seem to work fine with out it.
-  NOTE2: Yet Another GameCube Documentation calls them Bypass Raster State Registers but possibly
-  completely wrong
-  NOTE3: This controls the register groups: RAS1/2, SU, TF, TEV, C/Z, PEC
-  TODO: Turn into function table. The (future) DisplayList (DL) jit can then call the functions
-  directly,
-      getting rid of dynamic dispatch. Unfortunately, few games use DLs properly - most\
-      just stuff geometry in them and don't put state changes there
-  ----------------------------------------------------------------------------------------------------------------
-  */
+  PRIM_LOG("genmode: texgen=%d, col=%d, multisampling=%d, tev=%d, cullmode=%d, ind=%d, zfeeze=%d",
+           (u32)bpmem.genMode.numtexgens, (u32)bpmem.genMode.numcolchans,
+           (u32)bpmem.genMode.multisampling, (u32)bpmem.genMode.numtevstages + 1,
+           (u32)bpmem.genMode.cullmode, (u32)bpmem.genMode.numindstages,
+           (u32)bpmem.genMode.zfreeze);
+
+  if (bp.changes)
+    PixelShaderManager::SetGenModeChanged();
+
+  // Only call SetGenerationMode when cull mode changes.
+  if (bp.changes & 0xC000)
+    SetGenerationMode();
+}
 
-  // check for invalid state, else unneeded configuration are built
-  g_video_backend->CheckInvalidState();
+static void BPIndMatrixWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetIndMatrixChanged((bp.address - BPMEM_IND_MTXA) / 3);
+}
 
-  if (((s32*)&bpmem)[bp.address] == bp.newvalue)
-  {
-    if (!(bp.address == BPMEM_TRIGGER_EFB_COPY || bp.address == BPMEM_CLEARBBOX1 ||
-          bp.address == BPMEM_CLEARBBOX2 || bp.address == BPMEM_SETDRAWDONE ||
-          bp.address == BPMEM_PE_TOKEN_ID || bp.address == BPMEM_PE_TOKEN_INT_ID ||
-          bp.address == BPMEM_LOADTLUT0 || bp.address == BPMEM_LOADTLUT1 ||
-          bp.address == BPMEM_TEXINVALIDATE || bp.address == BPMEM_PRELOAD_MODE ||
-          bp.address == BPMEM_CLEAR_PIXEL_PERF))
-    {
-      return;
-    }
-  }
+static void BPIndTexScaleWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetIndTexScaleChanged(bp.address == BPMEM_RAS1_SS1);
+}
 
-  FlushPipeline();
+static void BPScissorWritten(const BPCmd& bp)
+{
+  SetScissor();
+  SetViewport();
+  VertexShaderManager::SetViewportChanged();
+  GeometryShaderManager::SetViewportChanged();
+}
 
-  ((u32*)&bpmem)[bp.address] = bp.newvalue;
+static void BPLinePtWidthWritten(const BPCmd& bp)
+{
+  GeometryShaderManager::SetLinePtWidthChanged();
+}
+
+static void BPZModeWritten(const BPCmd& bp)
+{
+  PRIM_LOG("zmode: test=%u, func=%u, upd=%u", bpmem.zmode.testenable.Value(),
+           bpmem.zmode.func.Value(), bpmem.zmode.updateenable.Value());
+  SetDepthMode();
+  PixelShaderManager::SetZModeControl();
+}
 
-  switch (bp.address)
+static void BPBlendModeWritten(const BPCmd& bp)
+{
+  if (bp.changes & 0xFFFF)
   {
-  case BPMEM_GENMODE:  // Set the Generation Mode
-    PRIM_LOG("genmode: texgen=%d, col=%d, multisampling=%d, tev=%d, cullmode=%d, ind=%d, zfeeze=%d",
-             (u32)bpmem.genMode.numtexgens, (u32)bpmem.genMode.numcolchans,
-             (u32)bpmem.genMode.multisampling, (u32)bpmem.genMode.numtevstages + 1,
-             (u32)bpmem.genMode.cullmode, (u32)bpmem.genMode.numindstages,
-             (u32)bpmem.genMode.zfreeze);
-
-    if (bp.changes)
-      PixelShaderManager::SetGenModeChanged();
-
-    // Only call SetGenerationMode when cull mode changes.
-    if (bp.changes & 0xC000)
-      SetGenerationMode();
-    return;
-  case BPMEM_IND_MTXA:  // Index Matrix Changed
-  case BPMEM_IND_MTXB:
-  case BPMEM_IND_MTXC:
-  case BPMEM_IND_MTXA + 3:
-  case BPMEM_IND_MTXB + 3:
-  case BPMEM_IND_MTXC + 3:
-  case BPMEM_IND_MTXA + 6:
-  case BPMEM_IND_MTXB + 6:
-  case BPMEM_IND_MTXC + 6:
-    if (bp.changes)
-      PixelShaderManager::SetIndMatrixChanged((bp.address - BPMEM_IND_MTXA) / 3);
-    return;
-  case BPMEM_RAS1_SS0:  // Index Texture Coordinate Scale 0
-    if (bp.changes)
-      PixelShaderManager::SetIndTexScaleChanged(false);
-    return;
-  case BPMEM_RAS1_SS1:  // Index Texture Coordinate Scale 1
-    if (bp.changes)
-      PixelShaderManager::SetIndTexScaleChanged(true);
-    return;
-  // ----------------
-  // Scissor Control
-  // ----------------
-  case BPMEM_SCISSORTL:      // Scissor Rectable Top, Left
-  case BPMEM_SCISSORBR:      // Scissor Rectable Bottom, Right
-  case BPMEM_SCISSOROFFSET:  // Scissor Offset
-    SetScissor();
-    SetViewport();
-    VertexShaderManager::SetViewportChanged();
-    GeometryShaderManager::SetViewportChanged();
-    return;
-  case BPMEM_LINEPTWIDTH:  // Line Width
-    GeometryShaderManager::SetLinePtWidthChanged();
-    return;
-  case BPMEM_ZMODE:  // Depth Control
-    PRIM_LOG("zmode: test=%u, func=%u, upd=%u", bpmem.zmode.testenable.Value(),
-             bpmem.zmode.func.Value(), bpmem.zmode.updateenable.Value());
-    SetDepthMode();
-    PixelShaderManager::SetZModeControl();
-    return;
-  case BPMEM_BLENDMODE:  // Blending Control
-    if (bp.changes & 0xFFFF)
-    {
-      PRIM_LOG("blendmode: en=%u, open=%u, colupd=%u, alphaupd=%u, dst=%u, src=%u, sub=%u, mode=%u",
-               bpmem.blendmode.blendenable.Value(), bpmem.blendmode.logicopenable.Value(),
-               bpmem.blendmode.colorupdate.Value(), bpmem.blendmode.alphaupdate.Value(),
-               bpmem.blendmode.dstfactor.Value(), bpmem.blendmode.srcfactor.Value(),
-               bpmem.blendmode.subtract.Value(), bpmem.blendmode.logicmode.Value());
+    PRIM_LOG("blendmode: en=%u, open=%u, colupd=%u, alphaupd=%u, dst=%u, src=%u, sub=%u, mode=%u",
+             bpmem.blendmode.blendenable.Value(), bpmem.blendmode.logicopenable.Value(),
+             bpmem.blendmode.colorupdate.Value(), bpmem.blendmode.alphaupdate.Value(),
+             bpmem.blendmode.dstfactor.Value(), bpmem.blendmode.srcfactor.Value(),
+             bpmem.blendmode.subtract.Value(), bpmem.blendmode.logicmode.Value());
 
-      SetBlendMode();
+    SetBlendMode();
 
-      PixelShaderManager::SetBlendModeChanged();
-    }
-    return;
-  case BPMEM_CONSTANTALPHA:  // Set Destination Alpha
-    PRIM_LOG("constalpha: alp=%d, en=%d", bpmem.dstalpha.alpha.Value(),
-             bpmem.dstalpha.enable.Value());
-    if (bp.changes)
-    {
-      PixelShaderManager::SetAlpha();
-      PixelShaderManager::SetDestAlphaChanged();
-    }
-    if (bp.changes & 0x100)
-      SetBlendMode();
-    return;
+    PixelShaderManager::SetBlendModeChanged();
+  }
+}
 
-  // This is called when the game is done drawing the new frame (eg: like in DX: Begin(); Draw();
-  // End();)
-  // Triggers an interrupt on the PPC side so that the game knows when the GPU has finished drawing.
-  // Tokens are similar.
-  case BPMEM_SETDRAWDONE:
-    switch (bp.newvalue & 0xFF)
-    {
-    case 0x02:
-      g_texture_cache->FlushEFBCopies();
-      if (!Fifo::UseDeterministicGPUThread())
-        PixelEngine::SetFinish();  // may generate interrupt
-      DEBUG_LOG(VIDEO, "GXSetDrawDone SetPEFinish (value: 0x%02X)", (bp.newvalue & 0xFFFF));
-      return;
-
-    default:
-      WARN_LOG(VIDEO, "GXSetDrawDone ??? (value 0x%02X)", (bp.newvalue & 0xFFFF));
-      return;
-    }
-    return;
-  case BPMEM_PE_TOKEN_ID:  // Pixel Engine Token ID
+static void BPConstantAlphaWritten(const BPCmd& bp)
+{
+  PRIM_LOG("constalpha: alp=%d, en=%d", bpmem.dstalpha.alpha.Value(),
+           bpmem.dstalpha.enable.Value());
+  if (bp.changes)
+  {
+    PixelShaderManager::SetAlpha();
+    PixelShaderManager::SetDestAlphaChanged();
+  }
+  if (bp.changes & 0x100)
+    SetBlendMode();
+}
+
+// This is called when the game is done drawing the new frame (eg: like in DX: Begin(); Draw();
+// End();)
+// Triggers an interrupt on the PPC side so that the game knows when the GPU has finished drawing.
+// Tokens are similar.
+static void BPSetDrawDoneWritten(const BPCmd& bp)
+{
+  switch (bp.newvalue & 0xFF)
+  {
+  case 0x02:
     g_texture_cache->FlushEFBCopies();
     if (!Fifo::UseDeterministicGPUThread())
-      PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
-    DEBUG_LOG(VIDEO, "SetPEToken 0x%04x", (bp.newvalue & 0xFFFF));
+      PixelEngine::SetFinish();  // may generate interrupt
+    DEBUG_LOG(VIDEO, "GXSetDrawDone SetPEFinish (value: 0x%02X)", (bp.newvalue & 0xFFFF));
     return;
-  case BPMEM_PE_TOKEN_INT_ID:  // Pixel Engine Interrupt Token ID
-    g_texture_cache->FlushEFBCopies();
-    if (!Fifo::UseDeterministicGPUThread())
-      PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
-    DEBUG_LOG(VIDEO, "SetPEToken + INT 0x%04x", (bp.newvalue & 0xFFFF));
+
+  default:
+    WARN_LOG(VIDEO, "GXSetDrawDone ??? (value 0x%02X)", (bp.newvalue & 0xFFFF));
     return;
+  }
+}
+
+static void BPTokenWritten(const BPCmd& bp)
+{
+  const bool interrupt = bp.address == BPMEM_PE_TOKEN_INT_ID;
+  g_texture_cache->FlushEFBCopies();
+  if (!Fifo::UseDeterministicGPUThread())
+    PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), interrupt);
+  DEBUG_LOG(VIDEO, interrupt ? "SetPEToken + INT 0x%04x" : "SetPEToken 0x%04x",
+            (bp.newvalue & 0xFFFF));
+}
+
+// ------------------------
+// EFB copy command. This copies a rectangle from the EFB to either RAM in a texture format or to
+// XFB as YUYV.
+// It can also optionally clear the EFB while copying from it. To emulate this, we of course copy
+// first and clear afterwards.
+static void BPTriggerEFBCopyWritten(const BPCmd& bp)
+{
+  // The bottom right is within the rectangle
+  // The values in bpmem.copyTexSrcXY and bpmem.copyTexSrcWH are updated in case 0x49 and 0x4a in
+  // this function
 
-  // ------------------------
-  // EFB copy command. This copies a rectangle from the EFB to either RAM in a texture format or to
-  // XFB as YUYV.
-  // It can also optionally clear the EFB while copying from it. To emulate this, we of course copy
-  // first and clear afterwards.
-  case BPMEM_TRIGGER_EFB_COPY:  // Copy EFB Region or Render to the XFB or Clear the screen.
+  u32 destAddr = bpmem.copyTexDest << 5;
+  u32 destStride = bpmem.copyMipMapStrideChannels << 5;
+
+  EFBRectangle srcRect;
+  srcRect.left = static_cast<int>(bpmem.copyTexSrcXY.x);
+  srcRect.top = static_cast<int>(bpmem.copyTexSrcXY.y);
+
+  // Here Width+1 like Height, otherwise some textures are corrupted already since the native
+  // resolution.
+  // TODO: What's the behavior of out of bound access?
+  srcRect.right = static_cast<int>(bpmem.copyTexSrcXY.x + bpmem.copyTexSrcWH.x + 1);
+  srcRect.bottom = static_cast<int>(bpmem.copyTexSrcXY.y + bpmem.copyTexSrcWH.y + 1);
+
+  UPE_Copy PE_copy = bpmem.triggerEFBCopy;
+
+  // Check if we are to copy from the EFB or draw to the XFB
+  if (PE_copy.copy_to_xfb == 0)
   {
-    // The bottom right is within the rectangle
-    // The values in bpmem.copyTexSrcXY and bpmem.copyTexSrcWH are updated in case 0x49 and 0x4a in
-    // this function
+    // bpmem.zcontrol.pixel_format to PEControl::Z24 is when the game wants to copy from ZBuffer
+    // (Zbuffer uses 24-bit Format)
+    static constexpr CopyFilterCoefficients::Values filter_coefficients = {
+        {0, 0, 21, 22, 21, 0, 0}};
+    bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
+    g_texture_cache->CopyRenderTargetToTexture(
+        destAddr, PE_copy.tp_realFormat(), srcRect.GetWidth(), srcRect.GetHeight(), destStride,
+        is_depth_copy, srcRect, !!PE_copy.intensity_fmt, !!PE_copy.half_scale, 1.0f, 1.0f,
+        bpmem.triggerEFBCopy.clamp_top, bpmem.triggerEFBCopy.clamp_bottom, filter_coefficients);
+  }
+  else
+  {
+    // We should be able to get away with deactivating the current bbox tracking
+    // here. Not sure if there's a better spot to put this.
+    // the number of lines copied is determined by the y scale * source efb height
+
+    BoundingBox::active = false;
+    PixelShaderManager::SetBoundingBoxActive(false);
+
+    float yScale;
+    if (PE_copy.scale_invert)
+      yScale = 256.0f / static_cast<float>(bpmem.dispcopyyscale);
+    else
+      yScale = static_cast<float>(bpmem.dispcopyyscale) / 256.0f;
 
-    u32 destAddr = bpmem.copyTexDest << 5;
-    u32 destStride = bpmem.copyMipMapStrideChannels << 5;
+    float num_xfb_lines = 1.0f + bpmem.copyTexSrcWH.y * yScale;
 
-    EFBRectangle srcRect;
-    srcRect.left = static_cast<int>(bpmem.copyTexSrcXY.x);
-    srcRect.top = static_cast<int>(bpmem.copyTexSrcXY.y);
+    u32 height = static_cast<u32>(num_xfb_lines);
 
-    // Here Width+1 like Height, otherwise some textures are corrupted already since the native
-    // resolution.
-    // TODO: What's the behavior of out of bound access?
-    srcRect.right = static_cast<int>(bpmem.copyTexSrcXY.x + bpmem.copyTexSrcWH.x + 1);
-    srcRect.bottom = static_cast<int>(bpmem.copyTexSrcXY.y + bpmem.copyTexSrcWH.y + 1);
+    DEBUG_LOG(VIDEO,
+              "RenderToXFB: destAddr: %08x | srcRect {%d %d %d %d} | fbWidth: %u | "
+              "fbStride: %u | fbHeight: %u | yScale: %f",
+              destAddr, srcRect.left, srcRect.top, srcRect.right, srcRect.bottom,
+              bpmem.copyTexSrcWH.x + 1, destStride, height, yScale);
 
-    UPE_Copy PE_copy = bpmem.triggerEFBCopy;
+    bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
+    g_texture_cache->CopyRenderTargetToTexture(
+        destAddr, EFBCopyFormat::XFB, srcRect.GetWidth(), height, destStride, is_depth_copy,
+        srcRect, false, false, yScale, s_gammaLUT[PE_copy.gamma], bpmem.triggerEFBCopy.clamp_top,
+        bpmem.triggerEFBCopy.clamp_bottom, bpmem.copyfilter.GetCoefficients());
 
-    // Check if we are to copy from the EFB or draw to the XFB
-    if (PE_copy.copy_to_xfb == 0)
+    // This stays in to signal end of a "frame"
+    g_renderer->RenderToXFB(destAddr, srcRect, destStride, height, s_gammaLUT[PE_copy.gamma]);
+
+    if (g_ActiveConfig.bImmediateXFB)
     {
-      // bpmem.zcontrol.pixel_format to PEControl::Z24 is when the game wants to copy from ZBuffer
-      // (Zbuffer uses 24-bit Format)
-      static constexpr CopyFilterCoefficients::Values filter_coefficients = {
-          {0, 0, 21, 22, 21, 0, 0}};
-      bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
-      g_texture_cache->CopyRenderTargetToTexture(
-          destAddr, PE_copy.tp_realFormat(), srcRect.GetWidth(), srcRect.GetHeight(), destStride,
-          is_depth_copy, srcRect, !!PE_copy.intensity_fmt, !!PE_copy.half_scale, 1.0f, 1.0f,
-          bpmem.triggerEFBCopy.clamp_top, bpmem.triggerEFBCopy.clamp_bottom, filter_coefficients);
+      // below div two to convert from bytes to pixels - it expects width, not stride
+      g_renderer->Swap(destAddr, destStride / 2, destStride / 2, height, srcRect,
+                       CoreTiming::GetTicks());
     }
     else
     {
-      // We should be able to get away with deactivating the current bbox tracking
-      // here. Not sure if there's a better spot to put this.
-      // the number of lines copied is determined by the y scale * source efb height
+      if (FifoPlayer::GetInstance().IsRunningWithFakeVideoInterfaceUpdates())
+      {
+        VideoInterface::FakeVIUpdate(destAddr, srcRect.GetWidth(), height);
+      }
+    }
+  }
 
-      BoundingBox::active = false;
-      PixelShaderManager::SetBoundingBoxActive(false);
+  // Clear the rectangular region after copying it.
+  if (PE_copy.clear)
+  {
+    ClearScreen(srcRect);
+  }
+}
 
-      float yScale;
-      if (PE_copy.scale_invert)
-        yScale = 256.0f / static_cast<float>(bpmem.dispcopyyscale);
-      else
-        yScale = static_cast<float>(bpmem.dispcopyyscale) / 256.0f;
+// Load a Texture Look Up Table
+static void BPLoadTlutWritten(const BPCmd& bp)
+{
+  u32 tlutTMemAddr = (bp.newvalue & 0x3FF) << 9;
+  u32 tlutXferCount = (bp.newvalue & 0x1FFC00) >> 5;
+  u32 addr = bpmem.tmem_config.tlut_src << 5;
 
-      float num_xfb_lines = 1.0f + bpmem.copyTexSrcWH.y * yScale;
+  // The GameCube ignores the upper bits of this address. Some games (WW, MKDD) set them.
+  if (!SConfig::GetInstance().bWii)
+    addr = addr & 0x01FFFFFF;
 
-      u32 height = static_cast<u32>(num_xfb_lines);
+  Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
 
-      DEBUG_LOG(VIDEO,
-                "RenderToXFB: destAddr: %08x | srcRect {%d %d %d %d} | fbWidth: %u | "
-                "fbStride: %u | fbHeight: %u | yScale: %f",
-                destAddr, srcRect.left, srcRect.top, srcRect.right, srcRect.bottom,
-                bpmem.copyTexSrcWH.x + 1, destStride, height, yScale);
+  if (g_bRecordFifoData)
+    FifoRecorder::GetInstance().UseMemory(addr, tlutXferCount, MemoryUpdate::TMEM);
 
-      bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
-      g_texture_cache->CopyRenderTargetToTexture(
-          destAddr, EFBCopyFormat::XFB, srcRect.GetWidth(), height, destStride, is_depth_copy,
-          srcRect, false, false, yScale, s_gammaLUT[PE_copy.gamma], bpmem.triggerEFBCopy.clamp_top,
-          bpmem.triggerEFBCopy.clamp_bottom, bpmem.copyfilter.GetCoefficients());
+  TextureCacheBase::InvalidateAllBindPoints();
+}
 
-      // This stays in to signal end of a "frame"
-      g_renderer->RenderToXFB(destAddr, srcRect, destStride, height, s_gammaLUT[PE_copy.gamma]);
+static void BPFogRangeWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogRangeAdjustChanged();
+}
 
-      if (g_ActiveConfig.bImmediateXFB)
-      {
-        // below div two to convert from bytes to pixels - it expects width, not stride
-        g_renderer->Swap(destAddr, destStride / 2, destStride / 2, height, srcRect,
-                         CoreTiming::GetTicks());
-      }
-      else
-      {
-        if (FifoPlayer::GetInstance().IsRunningWithFakeVideoInterfaceUpdates())
-        {
-          VideoInterface::FakeVIUpdate(destAddr, srcRect.GetWidth(), height);
-        }
-      }
-    }
+static void BPFogParamWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogParamChanged();
+}
 
-    // Clear the rectangular region after copying it.
-    if (PE_copy.clear)
-    {
-      ClearScreen(srcRect);
-    }
+static void BPFogColorWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogColorChanged();
+}
 
-    return;
+static void BPAlphaCompareWritten(const BPCmd& bp)
+{
+  PRIM_LOG("alphacmp: ref0=%d, ref1=%d, comp0=%d, comp1=%d, logic=%d", (int)bpmem.alpha_test.ref0,
+           (int)bpmem.alpha_test.ref1, (int)bpmem.alpha_test.comp0, (int)bpmem.alpha_test.comp1,
+           (int)bpmem.alpha_test.logic);
+  if (bp.changes & 0xFFFF)
+    PixelShaderManager::SetAlpha();
+  if (bp.changes)
+  {
+    PixelShaderManager::SetAlphaTestChanged();
+    SetBlendMode();
   }
-  case BPMEM_LOADTLUT0:  // This one updates bpmem.tlutXferSrc, no need to do anything here.
-    return;
-  case BPMEM_LOADTLUT1:  // Load a Texture Look Up Table
+}
+
+static void BPZTextureBiasWritten(const BPCmd& bp)
+{
+  PRIM_LOG("ztex bias=0x%x", bpmem.ztex1.bias.Value());
+  if (bp.changes)
+    PixelShaderManager::SetZTextureBias();
+}
+
+static void BPZTextureTypeWritten(const BPCmd& bp)
+{
+  if (bp.changes & 3)
+    PixelShaderManager::SetZTextureTypeChanged();
+  if (bp.changes & 12)
+    PixelShaderManager::SetZTextureOpChanged();
+#if defined(_DEBUG) || defined(DEBUGFAST)
+  const char* pzop[] = {"DISABLE", "ADD", "REPLACE", "?"};
+  const char* pztype[] = {"Z8", "Z16", "Z24", "?"};
+  PRIM_LOG("ztex op=%s, type=%s", pzop[bpmem.ztex2.op], pztype[bpmem.ztex2.type]);
+#endif
+}
+
+// Registers which only need to be stored in bpmem, e.g. the EFB copy and clear configuration,
+// the display copy filter (GX_SetCopyFilter), and the interlacing, clock and perf registers.
+static void BPStoredWritten(const BPCmd& bp)
+{
+}
+
+static void BPClearBBoxWritten(const BPCmd& bp)
+{
+  u8 offset = bp.address & 2;
+  BoundingBox::active = true;
+  PixelShaderManager::SetBoundingBoxActive(true);
+
+  if (g_ActiveConfig.backend_info.bSupportsBBox && g_ActiveConfig.bBBoxEnable)
   {
-    u32 tlutTMemAddr = (bp.newvalue & 0x3FF) << 9;
-    u32 tlutXferCount = (bp.newvalue & 0x1FFC00) >> 5;
-    u32 addr = bpmem.tmem_config.tlut_src << 5;
+    g_renderer->BBoxWrite(offset, bp.newvalue & 0x3ff);
+    g_renderer->BBoxWrite(offset + 1, bp.newvalue >> 10);
+  }
+}
 
-    // The GameCube ignores the upper bits of this address. Some games (WW, MKDD) set them.
-    if (!SConfig::GetInstance().bWii)
-      addr = addr & 0x01FFFFFF;
+static void BPTexInvalidateWritten(const BPCmd& bp)
+{
+  // TODO: Needs some restructuring in TextureCacheBase.
+  TextureCacheBase::InvalidateAllBindPoints();
+}
 
-    Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
+// Set the Z-Compare and EFB pixel format
+static void BPZCompareWritten(const BPCmd& bp)
+{
+  OnPixelFormatChange();
+  if (bp.changes & 7)
+    SetBlendMode();  // dual source could be activated by changing to PIXELFMT_RGBA6_Z24
+  PixelShaderManager::SetZModeControl();
+}
 
-    if (g_bRecordFifoData)
-      FifoRecorder::GetInstance().UseMemory(addr, tlutXferCount, MemoryUpdate::TMEM);
+/* 24 RID
+ * 21 BC3 - Ind. Tex Stage 3 NTexCoord
+ * 18 BI3 - Ind. Tex Stage 3 NTexMap
+ * 15 BC2 - Ind. Tex Stage 2 NTexCoord
+ * 12 BI2 - Ind. Tex Stage 2 NTexMap
+ * 9 BC1 - Ind. Tex Stage 1 NTexCoord
+ * 6 BI1 - Ind. Tex Stage 1 NTexMap
+ * 3 BC0 - Ind. Tex Stage 0 NTexCoord
+ * 0 BI0 - Ind. Tex Stage 0 NTexMap */
+static void BPIRefWritten(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetTevIndirectChanged();
+}
 
-    TextureCacheBase::InvalidateAllBindPoints();
+// Texture Environment Swap Mode Table
+static void BPTevKSelWritten(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevKSel(bp.address - BPMEM_TEV_KSEL, bp.newvalue);
+}
 
+static void BPClearPixelPerfWritten(const BPCmd& bp)
+{
+  // GXClearPixMetric writes 0xAAA here, Sunshine alternates this register between values 0x000
+  // and 0xAAA
+  if (PerfQueryBase::ShouldEmulate())
+    g_perf_query->ResetQuery();
+}
+
+// Set to 0 when GX_TexModeSync() is called.
+static void BPPreloadModeWritten(const BPCmd& bp)
+{
+  // if this is different from 0, manual TMEM management is used (GX_PreloadEntireTexture).
+  if (bp.newvalue == 0)
     return;
+
+  // TODO: Not quite sure if this is completely correct (likely not)
+  // NOTE: libogc's implementation of GX_PreloadEntireTexture seems flawed, so it's not
+  // necessarily a good reference for RE'ing this feature.
+
+  BPS_TmemConfig& tmem_cfg = bpmem.tmem_config;
+  u32 src_addr = tmem_cfg.preload_addr << 5;  // TODO: Should we add mask here on GC?
+  u32 bytes_read = 0;
+  u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
+
+  if (tmem_cfg.preload_tile_info.type != 3)
+  {
+    bytes_read = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
+    if (tmem_addr_even + bytes_read > TMEM_SIZE)
+      bytes_read = TMEM_SIZE - tmem_addr_even;
+
+    Memory::CopyFromEmu(texMem + tmem_addr_even, src_addr, bytes_read);
   }
-  case BPMEM_FOGRANGE:  // Fog Settings Control
-  case BPMEM_FOGRANGE + 1:
-  case BPMEM_FOGRANGE + 2:
-  case BPMEM_FOGRANGE + 3:
-  case BPMEM_FOGRANGE + 4:
-  case BPMEM_FOGRANGE + 5:
-    if (bp.changes)
-      PixelShaderManager::SetFogRangeAdjustChanged();
-    return;
-  case BPMEM_FOGPARAM0:
-  case BPMEM_FOGBMAGNITUDE:
-  case BPMEM_FOGBEXPONENT:
-  case BPMEM_FOGPARAM3:
-    if (bp.changes)
-      PixelShaderManager::SetFogParamChanged();
-    return;
-  case BPMEM_FOGCOLOR:  // Fog Color
-    if (bp.changes)
-      PixelShaderManager::SetFogColorChanged();
-    return;
-  case BPMEM_ALPHACOMPARE:  // Compare Alpha Values
-    PRIM_LOG("alphacmp: ref0=%d, ref1=%d, comp0=%d, comp1=%d, logic=%d", (int)bpmem.alpha_test.ref0,
-             (int)bpmem.alpha_test.ref1, (int)bpmem.alpha_test.comp0, (int)bpmem.alpha_test.comp1,
-             (int)bpmem.alpha_test.logic);
-    if (bp.changes & 0xFFFF)
-      PixelShaderManager::SetAlpha();
-    if (bp.changes)
+  else  // RGBA8 tiles (and CI14, but that might just be stupid libogc!)
+  {
+    u8* src_ptr = Memory::GetPointer(src_addr);
+
+    // AR and GB tiles are stored in separate TMEM banks => can't use a single memcpy for
+    // everything
+    u32 tmem_addr_odd = tmem_cfg.preload_tmem_odd * TMEM_LINE_SIZE;
+
+    for (u32 i = 0; i < tmem_cfg.preload_tile_info.count; ++i)
     {
-      PixelShaderManager::SetAlphaTestChanged();
-      SetBlendMode();
+      if (tmem_addr_even + TMEM_LINE_SIZE > TMEM_SIZE ||
+          tmem_addr_odd + TMEM_LINE_SIZE > TMEM_SIZE)
+        break;
+
+      memcpy(texMem + tmem_addr_even, src_ptr + bytes_read, TMEM_LINE_SIZE);
+      memcpy(texMem + tmem_addr_odd, src_ptr + bytes_read + TMEM_LINE_SIZE, TMEM_LINE_SIZE);
+      tmem_addr_even += TMEM_LINE_SIZE;
+      tmem_addr_odd += TMEM_LINE_SIZE;
+      bytes_read += TMEM_LINE_SIZE * 2;
     }
-    return;
-  case BPMEM_BIAS:  // BIAS
-    PRIM_LOG("ztex bias=0x%x", bpmem.ztex1.bias.Value());
-    if (bp.changes)
-      PixelShaderManager::SetZTextureBias();
-    return;
-  case BPMEM_ZTEX2:  // Z Texture type
+  }
+
+  if (g_bRecordFifoData)
+    FifoRecorder::GetInstance().UseMemory(src_addr, bytes_read, MemoryUpdate::TMEM);
+
+  TextureCacheBase::InvalidateAllBindPoints();
+}
+
+// ---------------------------------------------------
+// Set the TEV Color
+// ---------------------------------------------------
+//
+// NOTE: Each of these registers actually maps to two variables internally.
+//       There's a bit that specifies which one is currently written to.
+//
+// NOTE: Some games write only to the RA register (or only to the BG register).
+//       We may not assume that the unwritten register holds a valid value, hence
+//       both component pairs need to be loaded individually.
+static void BPTevColorRAWritten(const BPCmd& bp)
+{
+  int num = (bp.address >> 1) & 0x3;
+  if (bpmem.tevregs[num].type_ra)
   {
-    if (bp.changes & 3)
-      PixelShaderManager::SetZTextureTypeChanged();
-    if (bp.changes & 12)
-      PixelShaderManager::SetZTextureOpChanged();
-#if defined(_DEBUG) || defined(DEBUGFAST)
-    const char* pzop[] = {"DISABLE", "ADD", "REPLACE", "?"};
-    const char* pztype[] = {"Z8", "Z16", "Z24", "?"};
-    PRIM_LOG("ztex op=%s, type=%s", pzop[bpmem.ztex2.op], pztype[bpmem.ztex2.type]);
-#endif
+    PixelShaderManager::SetTevKonstColor(num, 0, (s32)bpmem.tevregs[num].red);
+    PixelShaderManager::SetTevKonstColor(num, 3, (s32)bpmem.tevregs[num].alpha);
   }
-    return;
-  // ----------------------------------
-  // Display Copy Filtering Control - GX_SetCopyFilter(u8 aa,u8 sample_pattern[12][2],u8 vf,u8
-  // vfilter[7])
-  // Fields: Destination, Frame2Field, Gamma, Source
-  // ----------------------------------
-  case BPMEM_DISPLAYCOPYFILTER:      // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 1:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 2:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 3:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_COPYFILTER0:            // if (vf) { use vfilter } else { use 595000 }
-  case BPMEM_COPYFILTER1:            // if (vf) { use vfilter } else { use 000015 }
-    return;
-  // -----------------------------------
-  // Interlacing Control
-  // -----------------------------------
-  case BPMEM_FIELDMASK:  // GX_SetFieldMask(u8 even_mask,u8 odd_mask)
-  case BPMEM_FIELDMODE:  // GX_SetFieldMode(u8 field_mode,u8 half_aspect_ratio)
-    // TODO
-    return;
-  // ----------------------------------------
-  // Unimportant regs (Clock, Perf, ...)
-  // ----------------------------------------
-  case BPMEM_BUSCLOCK0:   // TB Bus Clock ?
-  case BPMEM_BUSCLOCK1:   // TB Bus Clock ?
-  case BPMEM_PERF0_TRI:   // Perf: Triangles
-  case BPMEM_PERF0_QUAD:  // Perf: Quads
-  case BPMEM_PERF1:       // Perf: Some Clock, Texels, TX, TC
-    return;
-  // ----------------
-  // EFB Copy config
-  // ----------------
-  case BPMEM_EFB_TL:    // EFB Source Rect. Top, Left
-  case BPMEM_EFB_BR:    // EFB Source Rect. Bottom, Right (w, h - 1)
-  case BPMEM_EFB_ADDR:  // EFB Target Address
-    return;
-  // --------------
-  // Clear Config
-  // --------------
-  case BPMEM_CLEAR_AR:  // Alpha and Red Components
-  case BPMEM_CLEAR_GB:  // Green and Blue Components
-  case BPMEM_CLEAR_Z:   // Z Components (24-bit Zbuffer)
-    return;
-  // -------------------------
-  // Bounding Box Control
-  // -------------------------
-  case BPMEM_CLEARBBOX1:
-  case BPMEM_CLEARBBOX2:
+  else
   {
-    u8 offset = bp.address & 2;
-    BoundingBox::active = true;
-    PixelShaderManager::SetBoundingBoxActive(true);
+    PixelShaderManager::SetTevColor(num, 0, (s32)bpmem.tevregs[num].red);
+    PixelShaderManager::SetTevColor(num, 3, (s32)bpmem.tevregs[num].alpha);
+  }
+}
 
-    if (g_ActiveConfig.backend_info.bSupportsBBox && g_ActiveConfig.bBBoxEnable)
-    {
-      g_renderer->BBoxWrite(offset, bp.newvalue & 0x3ff);
-      g_renderer->BBoxWrite(offset + 1, bp.newvalue >> 10);
-    }
+static void BPTevColorBGWritten(const BPCmd& bp)
+{
+  int num = (bp.address >> 1) & 0x3;
+  if (bpmem.tevregs[num].type_bg)
+  {
+    PixelShaderManager::SetTevKonstColor(num, 1, (s32)bpmem.tevregs[num].green);
+    PixelShaderManager::SetTevKonstColor(num, 2, (s32)bpmem.tevregs[num].blue);
   }
-    return;
-  case BPMEM_TEXINVALIDATE:
-    // TODO: Needs some restructuring in TextureCacheBase.
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
+  else
+  {
+    PixelShaderManager::SetTevColor(num, 1, (s32)bpmem.tevregs[num].green);
+    PixelShaderManager::SetTevColor(num, 2, (s32)bpmem.tevregs[num].blue);
+  }
+}
 
-  case BPMEM_ZCOMPARE:  // Set the Z-Compare and EFB pixel format
-    OnPixelFormatChange();
-    if (bp.changes & 7)
-      SetBlendMode();  // dual source could be activated by changing to PIXELFMT_RGBA6_Z24
-    PixelShaderManager::SetZModeControl();
-    return;
+// Texture Environment Order
+static void BPTevOrderWritten(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevOrder(bp.address - BPMEM_TREF, bp.newvalue);
+}
 
-  case BPMEM_MIPMAP_STRIDE:  // MipMap Stride Channel
-  case BPMEM_COPYYSCALE:     // Display Copy Y Scale
-
-  /* 24 RID
-   * 21 BC3 - Ind. Tex Stage 3 NTexCoord
-   * 18 BI3 - Ind. Tex Stage 3 NTexMap
-   * 15 BC2 - Ind. Tex Stage 2 NTexCoord
-   * 12 BI2 - Ind. Tex Stage 2 NTexMap
-   * 9 BC1 - Ind. Tex Stage 1 NTexCoord
-   * 6 BI1 - Ind. Tex Stage 1 NTexMap
-   * 3 BC0 - Ind. Tex Stage 0 NTexCoord
-   * 0 BI0 - Ind. Tex Stage 0 NTexMap */
-  case BPMEM_IREF:
+// Set wrap size
+static void BPTexCoordSizeWritten(const BPCmd& bp)
+{
+  if (bp.changes)
   {
-    if (bp.changes)
-      PixelShaderManager::SetTevIndirectChanged();
-    return;
+    PixelShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
+    GeometryShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
   }
+}
 
-  case BPMEM_TEV_KSEL:      // Texture Environment Swap Mode Table 0
-  case BPMEM_TEV_KSEL + 1:  // Texture Environment Swap Mode Table 1
-  case BPMEM_TEV_KSEL + 2:  // Texture Environment Swap Mode Table 2
-  case BPMEM_TEV_KSEL + 3:  // Texture Environment Swap Mode Table 3
-  case BPMEM_TEV_KSEL + 4:  // Texture Environment Swap Mode Table 4
-  case BPMEM_TEV_KSEL + 5:  // Texture Environment Swap Mode Table 5
-  case BPMEM_TEV_KSEL + 6:  // Texture Environment Swap Mode Table 6
-  case BPMEM_TEV_KSEL + 7:  // Texture Environment Swap Mode Table 7
-    PixelShaderManager::SetTevKSel(bp.address - BPMEM_TEV_KSEL, bp.newvalue);
-    return;
+// BPMEM_TX_SETMODE0 - (Texture lookup and filtering mode) LOD/BIAS Clamp, MaxAnsio, LODBIAS,
+// DiagLoad, Min Filter, Mag Filter, Wrap T, S
+// BPMEM_TX_SETMODE1 - (LOD Stuff) - Max LOD, Min LOD
+// BPMEM_TX_SETIMAGE0 - Texture width, height, format
+// BPMEM_TX_SETIMAGE1 - even LOD address in TMEM - Image Type, Cache Height, Cache Width, TMEM
+// Offset
+// BPMEM_TX_SETIMAGE2 - odd LOD address in TMEM - Cache Height, Cache Width, TMEM Offset
+// BPMEM_TX_SETIMAGE3 - Address of Texture in main memory
+// BPMEM_TX_SETTLUT - Format, TMEM Offset (offset of TLUT from start of TMEM high bank > > 5)
+static void BPTextureWritten(const BPCmd& bp)
+{
+  TextureCacheBase::InvalidateAllBindPoints();
+}
 
-  /* This Register can be used to limit to which bits of BP registers is
-   * actually written to. The mask is only valid for the next BP write,
-   * and will reset itself afterwards. It's handled as a special case in
-   * LoadBPReg. */
-  case BPMEM_BP_MASK:
+// Indirect Tev
+static void BPTevIndirectWritten(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevIndirectChanged();
+}
 
-  case BPMEM_IND_IMASK:  // Index Mask ?
-  case BPMEM_REVBITS:    // Always set to 0x0F when GX_InitRevBits() is called.
-    return;
+// Set Color/Alpha of a Tev
+// BPMEM_TEV_COLOR_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D
+// BPMEM_TEV_ALPHA_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D, T Swap, R Swap
+static void BPTevCombinerWritten(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevCombiner((bp.address - BPMEM_TEV_COLOR_ENV) >> 1,
+                                     (bp.address - BPMEM_TEV_COLOR_ENV) & 1, bp.newvalue);
+}
 
-  case BPMEM_CLEAR_PIXEL_PERF:
-    // GXClearPixMetric writes 0xAAA here, Sunshine alternates this register between values 0x000
-    // and 0xAAA
-    if (PerfQueryBase::ShouldEmulate())
-      g_perf_query->ResetQuery();
-    return;
+static void BPUnknownWritten(const BPCmd& bp)
+{
+  WARN_LOG(VIDEO, "Unknown BP opcode: address = 0x%08x value = 0x%08x", bp.address, bp.newvalue);
+}
 
-  case BPMEM_PRELOAD_ADDR:
-  case BPMEM_PRELOAD_TMEMEVEN:
-  case BPMEM_PRELOAD_TMEMODD:  // Used when PRELOAD_MODE is set
-    return;
+struct BPRegisterInfo
+{
+  BPHandler handler = BPUnknownWritten;
+  // Writing the register triggers an action, so it has to be handled even if the value doesn't
+  // change.
+  bool is_command = false;
+  // Parts of the pipeline configuration which are generated from the register. Most registers
+  // are read by the pixel shader uid, so that's the default.
+  u32 pipeline_state = VertexManagerBase::DIRTY_PIXEL_SHADER;
+  // The register is only read when the vertices are flushed, so a write can wait until the next
+  // primitive comes in. Games often set a register and set it back again in between draws.
+  bool deferrable = false;
+};
+
+struct BPRegisterTable
+{
+  BPRegisterInfo registers[256];
+};
 
-  case BPMEM_PRELOAD_MODE:  // Set to 0 when GX_TexModeSync() is called.
-    // if this is different from 0, manual TMEM management is used (GX_PreloadEntireTexture).
-    if (bp.newvalue != 0)
-    {
-      // TODO: Not quite sure if this is completely correct (likely not)
-      // NOTE: libogc's implementation of GX_PreloadEntireTexture seems flawed, so it's not
-      // necessarily a good reference for RE'ing this feature.
+constexpr u32 NO_PIPELINE_STATE = 0;
 
-      BPS_TmemConfig& tmem_cfg = bpmem.tmem_config;
-      u32 src_addr = tmem_cfg.preload_addr << 5;  // TODO: Should we add mask here on GC?
-      u32 bytes_read = 0;
-      u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
+static constexpr void SetBPHandler(BPRegisterTable& table, u32 first, u32 count, u32 step,
+                                   BPHandler handler, u32 pipeline_state)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    table.registers[first + i * step].handler = handler;
+    table.registers[first + i * step].pipeline_state = pipeline_state;
+  }
+}
 
-      if (tmem_cfg.preload_tile_info.type != 3)
-      {
-        bytes_read = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
-        if (tmem_addr_even + bytes_read > TMEM_SIZE)
-          bytes_read = TMEM_SIZE - tmem_addr_even;
+static constexpr void SetBPHandler(BPRegisterTable& table, u32 address, BPHandler handler,
+                                   u32 pipeline_state)
+{
+  SetBPHandler(table, address, 1, 1, handler, pipeline_state);
+}
 
-        Memory::CopyFromEmu(texMem + tmem_addr_even, src_addr, bytes_read);
-      }
-      else  // RGBA8 tiles (and CI14, but that might just be stupid libogc!)
-      {
-        u8* src_ptr = Memory::GetPointer(src_addr);
-
-        // AR and GB tiles are stored in separate TMEM banks => can't use a single memcpy for
-        // everything
-        u32 tmem_addr_odd = tmem_cfg.preload_tmem_odd * TMEM_LINE_SIZE;
-
-        for (u32 i = 0; i < tmem_cfg.preload_tile_info.count; ++i)
-        {
-          if (tmem_addr_even + TMEM_LINE_SIZE > TMEM_SIZE ||
-              tmem_addr_odd + TMEM_LINE_SIZE > TMEM_SIZE)
-            break;
-
-          memcpy(texMem + tmem_addr_even, src_ptr + bytes_read, TMEM_LINE_SIZE);
-          memcpy(texMem + tmem_addr_odd, src_ptr + bytes_read + TMEM_LINE_SIZE, TMEM_LINE_SIZE);
-          tmem_addr_even += TMEM_LINE_SIZE;
-          tmem_addr_odd += TMEM_LINE_SIZE;
-          bytes_read += TMEM_LINE_SIZE * 2;
-        }
-      }
+static constexpr void SetBPCommand(BPRegisterTable& table, u32 address, BPHandler handler,
+                                   u32 pipeline_state = NO_PIPELINE_STATE)
+{
+  SetBPHandler(table, address, handler, pipeline_state);
+  table.registers[address].is_command = true;
+}
 
-      if (g_bRecordFifoData)
-        FifoRecorder::GetInstance().UseMemory(src_addr, bytes_read, MemoryUpdate::TMEM);
+static constexpr void SetBPDeferrable(BPRegisterTable& table, u32 first, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+    table.registers[first + i].deferrable = true;
+}
 
-      TextureCacheBase::InvalidateAllBindPoints();
-    }
-    return;
+static constexpr BPRegisterTable MakeBPRegisterTable()
+{
+  constexpr u32 VERTEX_SHADER = VertexManagerBase::DIRTY_VERTEX_SHADER;
+  constexpr u32 PIXEL_SHADER = VertexManagerBase::DIRTY_PIXEL_SHADER;
+  constexpr u32 NONE = NO_PIPELINE_STATE;
+
+  BPRegisterTable table = {};
+
+  SetBPHandler(table, BPMEM_GENMODE, BPGenModeWritten, VERTEX_SHADER | PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_DISPLAYCOPYFILTER, 4, 1, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_IND_MTXA, 9, 1, BPIndMatrixWritten, NONE);
+  // BPMEM_BP_MASK limits which bits of the next BP write are written. It's handled as a special
+  // case in LoadBPReg.
+  SetBPHandler(table, BPMEM_IND_IMASK, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_BP_MASK, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_IND_CMD, 16, 1, BPTevIndirectWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_SCISSORTL, BPScissorWritten, NONE);
+  SetBPHandler(table, BPMEM_SCISSORBR, BPScissorWritten, NONE);
+  SetBPHandler(table, BPMEM_SCISSOROFFSET, BPScissorWritten, NONE);
+  SetBPHandler(table, BPMEM_LINEPTWIDTH, BPLinePtWidthWritten, NONE);
+  SetBPHandler(table, BPMEM_PERF0_TRI, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_PERF0_QUAD, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_RAS1_SS0, 2, 1, BPIndTexScaleWritten, NONE);
+  SetBPHandler(table, BPMEM_IREF, BPIRefWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_TREF, 8, 1, BPTevOrderWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_SU_SSIZE, 16, 1, BPTexCoordSizeWritten, NONE);
+
+  SetBPHandler(table, BPMEM_ZMODE, BPZModeWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_BLENDMODE, BPBlendModeWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_CONSTANTALPHA, BPConstantAlphaWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_ZCOMPARE, BPZCompareWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_FIELDMASK, BPStoredWritten, NONE);
+  SetBPCommand(table, BPMEM_SETDRAWDONE, BPSetDrawDoneWritten);
+  SetBPHandler(table, BPMEM_BUSCLOCK0, BPStoredWritten, NONE);
+  SetBPCommand(table, BPMEM_PE_TOKEN_ID, BPTokenWritten);
+  SetBPCommand(table, BPMEM_PE_TOKEN_INT_ID, BPTokenWritten);
+  SetBPHandler(table, BPMEM_EFB_TL, 3, 1, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_MIPMAP_STRIDE, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_COPYYSCALE, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_CLEAR_AR, 3, 1, BPStoredWritten, NONE);
+  SetBPCommand(table, BPMEM_TRIGGER_EFB_COPY, BPTriggerEFBCopyWritten);
+  SetBPHandler(table, BPMEM_COPYFILTER0, 2, 1, BPStoredWritten, NONE);
+  SetBPCommand(table, BPMEM_CLEARBBOX1, BPClearBBoxWritten);
+  SetBPCommand(table, BPMEM_CLEARBBOX2, BPClearBBoxWritten);
+  SetBPCommand(table, BPMEM_CLEAR_PIXEL_PERF, BPClearPixelPerfWritten);
+  // Always set to 0x0F when GX_InitRevBits() is called.
+  SetBPHandler(table, BPMEM_REVBITS, BPStoredWritten, NONE);
+
+  // BPMEM_PRELOAD_ADDR and BPMEM_PRELOAD_TMEMEVEN/ODD are used when PRELOAD_MODE is set.
+  SetBPHandler(table, BPMEM_PRELOAD_ADDR, 3, 1, BPStoredWritten, NONE);
+  SetBPCommand(table, BPMEM_PRELOAD_MODE, BPPreloadModeWritten);
+  // BPMEM_LOADTLUT0 updates bpmem.tlutXferSrc, no need to do anything there.
+  SetBPCommand(table, BPMEM_LOADTLUT0, BPStoredWritten);
+  SetBPCommand(table, BPMEM_LOADTLUT1, BPLoadTlutWritten);
+  SetBPCommand(table, BPMEM_TEXINVALIDATE, BPTexInvalidateWritten);
+  SetBPHandler(table, BPMEM_PERF1, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_FIELDMODE, BPStoredWritten, NONE);
+  SetBPHandler(table, BPMEM_BUSCLOCK1, BPStoredWritten, NONE);
+
+  // The texture registers are only read when textures are bound, and not by the shader uids.
+  SetBPHandler(table, BPMEM_TX_SETMODE0, 8, 1, BPTextureWritten, NONE);
+  SetBPHandler(table, BPMEM_TX_SETIMAGE0, 16, 1, BPTextureWritten, NONE);
+  SetBPHandler(table, BPMEM_TX_SETTLUT, 4, 1, BPTextureWritten, NONE);
+  SetBPHandler(table, BPMEM_TX_SETMODE0_4, 8, 1, BPTextureWritten, NONE);
+  SetBPHandler(table, BPMEM_TX_SETIMAGE0_4, 16, 1, BPTextureWritten, NONE);
+  SetBPHandler(table, BPMEM_TX_SETTLUT_4, 4, 1, BPTextureWritten, NONE);
+
+  SetBPHandler(table, BPMEM_TEV_COLOR_ENV, 32, 1, BPTevCombinerWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_TEV_COLOR_RA, 4, 2, BPTevColorRAWritten, NONE);
+  SetBPHandler(table, BPMEM_TEV_COLOR_BG, 4, 2, BPTevColorBGWritten, NONE);
+  // Only the first fog range register holds the enable bit, the others are the adjustment
+  // factors.
+  SetBPHandler(table, BPMEM_FOGRANGE, BPFogRangeWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_FOGRANGE + 1, 5, 1, BPFogRangeWritten, NONE);
+  SetBPHandler(table, BPMEM_FOGPARAM0, BPFogParamWritten, NONE);
+  SetBPHandler(table, BPMEM_FOGBMAGNITUDE, BPFogParamWritten, NONE);
+  SetBPHandler(table, BPMEM_FOGBEXPONENT, BPFogParamWritten, NONE);
+  SetBPHandler(table, BPMEM_FOGPARAM3, BPFogParamWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_FOGCOLOR, BPFogColorWritten, NONE);
+  SetBPHandler(table, BPMEM_ALPHACOMPARE, BPAlphaCompareWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_BIAS, BPZTextureBiasWritten, NONE);
+  SetBPHandler(table, BPMEM_ZTEX2, BPZTextureTypeWritten, PIXEL_SHADER);
+  SetBPHandler(table, BPMEM_TEV_KSEL, 8, 1, BPTevKSelWritten, PIXEL_SHADER);
+
+  // Registers which only end up in the shader uids, the shader constants and the render state,
+  // or select the textures. Nothing reads them until the next flush. The TEV color registers
+  // aren't included, each of them sets one of two colors, so every write has to be handled.
+  SetBPDeferrable(table, BPMEM_IND_MTXA, 9);
+  SetBPDeferrable(table, BPMEM_IND_CMD, 16);
+  SetBPDeferrable(table, BPMEM_RAS1_SS0, 2);
+  SetBPDeferrable(table, BPMEM_IREF, 1);
+  SetBPDeferrable(table, BPMEM_TREF, 8);
+  SetBPDeferrable(table, BPMEM_SU_SSIZE, 16);
+  SetBPDeferrable(table, BPMEM_ZMODE, 1);
+  SetBPDeferrable(table, BPMEM_BLENDMODE, 1);
+  SetBPDeferrable(table, BPMEM_CONSTANTALPHA, 1);
+  SetBPDeferrable(table, BPMEM_TX_SETMODE0, 8);
+  SetBPDeferrable(table, BPMEM_TX_SETIMAGE0, 16);
+  SetBPDeferrable(table, BPMEM_TX_SETTLUT, 4);
+  SetBPDeferrable(table, BPMEM_TX_SETMODE0_4, 8);
+  SetBPDeferrable(table, BPMEM_TX_SETIMAGE0_4, 16);
+  SetBPDeferrable(table, BPMEM_TX_SETTLUT_4, 4);
+  SetBPDeferrable(table, BPMEM_TEV_COLOR_ENV, 32);
+  SetBPDeferrable(table, BPMEM_FOGRANGE, 6);
+  SetBPDeferrable(table, BPMEM_FOGPARAM0, 1);
+  SetBPDeferrable(table, BPMEM_FOGBMAGNITUDE, 1);
+  SetBPDeferrable(table, BPMEM_FOGBEXPONENT, 1);
+  SetBPDeferrable(table, BPMEM_FOGPARAM3, 1);
+  SetBPDeferrable(table, BPMEM_FOGCOLOR, 1);
+  SetBPDeferrable(table, BPMEM_ALPHACOMPARE, 1);
+  SetBPDeferrable(table, BPMEM_BIAS, 1);
+  SetBPDeferrable(table, BPMEM_ZTEX2, 1);
+  SetBPDeferrable(table, BPMEM_TEV_KSEL, 8);
+
+  return table;
+}
 
-  // ---------------------------------------------------
-  // Set the TEV Color
-  // ---------------------------------------------------
-  //
-  // NOTE: Each of these registers actually maps to two variables internally.
-  //       There's a bit that specifies which one is currently written to.
-  //
-  // NOTE: Some games write only to the RA register (or only to the BG register).
-  //       We may not assume that the unwritten register holds a valid value, hence
-  //       both component pairs need to be loaded individually.
-  case BPMEM_TEV_COLOR_RA:
-  case BPMEM_TEV_COLOR_RA + 2:
-  case BPMEM_TEV_COLOR_RA + 4:
-  case BPMEM_TEV_COLOR_RA + 6:
-  {
-    int num = (bp.address >> 1) & 0x3;
-    if (bpmem.tevregs[num].type_ra)
-    {
-      PixelShaderManager::SetTevKonstColor(num, 0, (s32)bpmem.tevregs[num].red);
-      PixelShaderManager::SetTevKonstColor(num, 3, (s32)bpmem.tevregs[num].alpha);
-    }
-    else
-    {
-      PixelShaderManager::SetTevColor(num, 0, (s32)bpmem.tevregs[num].red);
-      PixelShaderManager::SetTevColor(num, 3, (s32)bpmem.tevregs[num].alpha);
-    }
+static constexpr BPRegisterTable s_bp_registers = MakeBPRegisterTable();
+
+// Returns the value the register will have for the next primitive, including held back writes.
+static u32 GetBPRegValue(u32 address)
+{
+  return s_deferred_writes.GetValue(address, (u32*)&bpmem);
+}
+
+static void ApplyBPWrite(u32 address, u32 value)
+{
+  const BPRegisterInfo& info = s_bp_registers.registers[address];
+  const u32 changes = (((u32*)&bpmem)[address] ^ value) & 0xFFFFFF;
+  BPCmd bp = {static_cast<int>(address), static_cast<int>(changes), static_cast<int>(value)};
+
+  ((u32*)&bpmem)[address] = value;
+
+  if (changes)
+    g_vertex_manager->SetPipelineStateDirty(info.pipeline_state);
+
+  info.handler(bp);
+}
+
+static void BPWritten(const BPCmd& bp)
+{
+  // check for invalid state, else unneeded configuration are built
+  g_video_backend->CheckInvalidState();
+
+  const BPRegisterInfo& info = s_bp_registers.registers[bp.address];
+  if (static_cast<s32>(GetBPRegValue(bp.address)) == bp.newvalue && !info.is_command)
     return;
-  }
 
-  case BPMEM_TEV_COLOR_BG:
-  case BPMEM_TEV_COLOR_BG + 2:
-  case BPMEM_TEV_COLOR_BG + 4:
-  case BPMEM_TEV_COLOR_BG + 6:
+  // While vertices are queued, hold back writes to registers which are only read at flush time.
+  // If they are set back to the values used by the queued vertices before the next primitive,
+  // the primitives can go into the same draw.
+  if (info.deferrable && !g_vertex_manager->IsFlushed())
   {
-    int num = (bp.address >> 1) & 0x3;
-    if (bpmem.tevregs[num].type_bg)
-    {
-      PixelShaderManager::SetTevKonstColor(num, 1, (s32)bpmem.tevregs[num].green);
-      PixelShaderManager::SetTevKonstColor(num, 2, (s32)bpmem.tevregs[num].blue);
-    }
-    else
-    {
-      PixelShaderManager::SetTevColor(num, 1, (s32)bpmem.tevregs[num].green);
-      PixelShaderManager::SetTevColor(num, 2, (s32)bpmem.tevregs[num].blue);
-    }
+    s_deferred_writes.Defer(bp.address, bp.newvalue);
     return;
   }
 
-  default:
-    break;
-  }
+  FlushPipeline();
+  // Flushing applies the held back writes, but they may also be left over from a savestate that
+  // was loaded while nothing was queued.
+  ApplyDeferredBPWrites();
 
-  switch (bp.address & 0xFC)  // Texture sampler filter
-  {
-  // -------------------------
-  // Texture Environment Order
-  // -------------------------
-  case BPMEM_TREF:
-  case BPMEM_TREF + 4:
-    PixelShaderManager::SetTevOrder(bp.address - BPMEM_TREF, bp.newvalue);
-    return;
-  // ----------------------
-  // Set wrap size
-  // ----------------------
-  case BPMEM_SU_SSIZE:  // Matches BPMEM_SU_TSIZE too
-  case BPMEM_SU_SSIZE + 4:
-  case BPMEM_SU_SSIZE + 8:
-  case BPMEM_SU_SSIZE + 12:
-    if (bp.changes)
-    {
-      PixelShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
-      GeometryShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
-    }
-    return;
-  // ------------------------
-  // BPMEM_TX_SETMODE0 - (Texture lookup and filtering mode) LOD/BIAS Clamp, MaxAnsio, LODBIAS,
-  // DiagLoad, Min Filter, Mag Filter, Wrap T, S
-  // BPMEM_TX_SETMODE1 - (LOD Stuff) - Max LOD, Min LOD
-  // ------------------------
-  case BPMEM_TX_SETMODE0:  // (0x90 for linear)
-  case BPMEM_TX_SETMODE0_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
+  ((u32*)&bpmem)[bp.address] = bp.newvalue;
 
-  case BPMEM_TX_SETMODE1:
-  case BPMEM_TX_SETMODE1_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-  // --------------------------------------------
-  // BPMEM_TX_SETIMAGE0 - Texture width, height, format
-  // BPMEM_TX_SETIMAGE1 - even LOD address in TMEM - Image Type, Cache Height, Cache Width, TMEM
-  // Offset
-  // BPMEM_TX_SETIMAGE2 - odd LOD address in TMEM - Cache Height, Cache Width, TMEM Offset
-  // BPMEM_TX_SETIMAGE3 - Address of Texture in main memory
-  // --------------------------------------------
-  case BPMEM_TX_SETIMAGE0:
-  case BPMEM_TX_SETIMAGE0_4:
-  case BPMEM_TX_SETIMAGE1:
-  case BPMEM_TX_SETIMAGE1_4:
-  case BPMEM_TX_SETIMAGE2:
-  case BPMEM_TX_SETIMAGE2_4:
-  case BPMEM_TX_SETIMAGE3:
-  case BPMEM_TX_SETIMAGE3_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-  // -------------------------------
-  // Set a TLUT
-  // BPMEM_TX_SETTLUT - Format, TMEM Offset (offset of TLUT from start of TMEM high bank > > 5)
-  // -------------------------------
-  case BPMEM_TX_SETTLUT:
-  case BPMEM_TX_SETTLUT_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
+  if (bp.changes)
+    g_vertex_manager->SetPipelineStateDirty(info.pipeline_state);
 
-  default:
-    break;
-  }
+  info.handler(bp);
+}
 
-  switch (bp.address & 0xF0)
-  {
-  // --------------
-  // Indirect Tev
-  // --------------
-  case BPMEM_IND_CMD:
-    PixelShaderManager::SetTevIndirectChanged();
+void ResolveDeferredBPWrites()
+{
+  if (s_deferred_writes.IsEmpty())
     return;
-  // --------------------------------------------------
-  // Set Color/Alpha of a Tev
-  // BPMEM_TEV_COLOR_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D
-  // BPMEM_TEV_ALPHA_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D, T Swap, R Swap
-  // --------------------------------------------------
-  case BPMEM_TEV_COLOR_ENV:  // Texture Environment 1
-  case BPMEM_TEV_COLOR_ENV + 16:
-    PixelShaderManager::SetTevCombiner((bp.address - BPMEM_TEV_COLOR_ENV) >> 1,
-                                       (bp.address - BPMEM_TEV_COLOR_ENV) & 1, bp.newvalue);
+
+  // All of the registers may have been set back to the state of the queued vertices.
+  if (s_deferred_writes.DropIfUnchanged((u32*)&bpmem))
+  {
+    INCSTAT(stats.thisFrame.numDrawsMerged);
     return;
-  default:
-    break;
   }
 
-  WARN_LOG(VIDEO, "Unknown BP opcode: address = 0x%08x value = 0x%08x", bp.address, bp.newvalue);
+  // The state changed, so the queued vertices have to be drawn first. Flushing applies the held
+  // back writes, unless nothing was queued, which happens after loading a savestate.
+  g_vertex_manager->Flush();
+  ApplyDeferredBPWrites();
+}
+
+void ApplyDeferredBPWrites()
+{
+  s_deferred_writes.Apply((u32*)&bpmem, ApplyBPWrite);
+}
+
+void DoDeferredBPState(PointerWrap& p)
+{
+  s_deferred_writes.DoState(p);
 }
 
 // Call browser: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg()
 void LoadBPReg(u32 value0)
 {
   int regNum = value0 >> 24;
-  int oldval = ((u32*)&bpmem)[regNum];
+  int oldval = GetBPRegValue(regNum);
   int newval = (oldval & ~bpmem.bpMask) | (value0 & bpmem.bpMask);
   int changes = (oldval ^ newval) & 0xFFFFFF;
 
@@ -4,5 +4,14 @@
 
 #pragma once
 
+class PointerWrap;
+
 void BPInit();
 void BPReload();
+
+// Called before new vertices are added. Drops the held back BP writes if they didn't change any
+// registers, otherwise flushes the queued vertices.
+void ResolveDeferredBPWrites();
+// Called by the vertex manager after a flush, to apply the held back BP writes.
+void ApplyDeferredBPWrites();
+void DoDeferredBPState(PointerWrap& p);
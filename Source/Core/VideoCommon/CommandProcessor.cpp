@@ -37,6 +37,10 @@ static u16 m_bboxright;
 static u16 m_bboxbottom;
 static u16 m_tokenReg;
 
+// Counts the times the CPU sent more commands to the GPU or changed the FIFO, so that results
+// read back from the GPU can be reused until the next change.
+static u64 s_fifo_write_count;
+
 static Common::Flag s_interrupt_set;
 static Common::Flag s_interrupt_waiting;
 
@@ -276,6 +280,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
                  MMIO::ComplexWrite<u16>([WMASK_HI_RESTRICT](u32, u16 val) {
                    WriteHigh(fifo.CPReadWriteDistance, val & WMASK_HI_RESTRICT);
                    Fifo::SyncGPU(Fifo::SyncGPUReason::Other);
+                   s_fifo_write_count++;
                    if (fifo.CPReadWriteDistance == 0)
                    {
                      GPFifo::ResetGatherPipe();
@@ -300,12 +305,19 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
           MMIO::ComplexWrite<u16>([WMASK_HI_RESTRICT](u32, u16 val) {
             WriteHigh(fifo.CPReadPointer, val & WMASK_HI_RESTRICT);
             fifo.SafeCPReadPointer = fifo.CPReadPointer;
+            s_fifo_write_count++;
           }) :
           MMIO::DirectWrite<u16>(MMIO::Utils::HighPart(&fifo.CPReadPointer), WMASK_HI_RESTRICT));
 }
 
+u64 GetFifoWriteCount()
+{
+  return s_fifo_write_count;
+}
+
 void GatherPipeBursted()
 {
+  s_fifo_write_count++;
   SetCPStatusFromCPU();
 
   // if we aren't linked, we don't care about gather pipe data
@@ -500,6 +512,7 @@ void SetCpControlRegister()
   fifo.bFF_HiWatermarkInt = m_CPCtrlReg.FifoOverflowIntEnable;
   fifo.bFF_LoWatermarkInt = m_CPCtrlReg.FifoUnderflowIntEnable;
   fifo.bFF_GPLinkEnable = m_CPCtrlReg.GPLinkEnable;
+  s_fifo_write_count++;
 
   if (fifo.bFF_GPReadEnable && !m_CPCtrlReg.GPReadEnable)
   {
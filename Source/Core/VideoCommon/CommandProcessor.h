@@ -158,6 +158,8 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base);
 void SetCPStatusFromGPU();
 void SetCPStatusFromCPU();
 void GatherPipeBursted();
+// Must be called from the CPU thread.
+u64 GetFifoWriteCount();
 void UpdateInterrupts(u64 userdata);
 void UpdateInterruptsFromVideoBackend(u64 userdata);
 
@@ -0,0 +1,27 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ConstantUploadTracker.h"
+
+#include <cstring>
+
+#include "VideoCommon/Statistics.h"
+
+ConstantUploadTracker::ConstantUploadTracker(u32 size) : m_last_upload(size)
+{
+}
+
+bool ConstantUploadTracker::Update(const void* constants)
+{
+  const u32 size = static_cast<u32>(m_last_upload.size());
+  if (m_valid && std::memcmp(m_last_upload.data(), constants, size) == 0)
+  {
+    ADDSTAT(stats.thisFrame.bytesUniformSkipped, size);
+    return false;
+  }
+
+  std::memcpy(m_last_upload.data(), constants, size);
+  m_valid = true;
+  return true;
+}
@@ -0,0 +1,34 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Keeps a copy of the shader constants that a backend last uploaded, so that it can find out
+// whether they changed since then.
+//
+// The shader managers set their dirty flag whenever one of the registers that the constants are
+// built from is written, whether or not that changes any values. Games rewrite the same values
+// all the time, so a dirty stage often doesn't need a new upload, and the backend can keep using
+// the one it made before.
+class ConstantUploadTracker
+{
+public:
+  explicit ConstantUploadTracker(u32 size);
+
+  // Compares the constants with the copy from the last upload, and replaces the copy with them.
+  // Returns whether any of the values differ.
+  bool Update(const void* constants);
+
+  // Forgets the last upload, so that the next update reports the constants as changed.
+  // Backends call this when they can't use the previous upload anymore.
+  void Invalidate() { m_valid = false; }
+
+private:
+  std::vector<u8> m_last_upload;
+  bool m_valid = false;
+};
@@ -0,0 +1,52 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DeferredBPWrites.h"
+
+#include <algorithm>
+
+#include "Common/ChunkFile.h"
+
+DeferredBPWrites::DeferredBPWrites()
+{
+  Clear();
+}
+
+void DeferredBPWrites::Defer(u32 address, u32 value)
+{
+  if (!m_is_deferred[address])
+  {
+    m_is_deferred[address] = true;
+    m_addresses.push_back(static_cast<u8>(address));
+  }
+  m_values[address] = value;
+}
+
+bool DeferredBPWrites::DropIfUnchanged(const u32* registers)
+{
+  const bool unchanged = std::all_of(m_addresses.begin(), m_addresses.end(), [&](u8 address) {
+    return m_values[address] == registers[address];
+  });
+  if (!unchanged)
+    return false;
+
+  for (u8 address : m_addresses)
+    m_is_deferred[address] = false;
+  m_addresses.clear();
+  return true;
+}
+
+void DeferredBPWrites::Clear()
+{
+  m_values.fill(0);
+  m_is_deferred.fill(false);
+  m_addresses.clear();
+}
+
+void DeferredBPWrites::DoState(PointerWrap& p)
+{
+  p.DoArray(m_values);
+  p.DoArray(m_is_deferred);
+  p.Do(m_addresses);
+}
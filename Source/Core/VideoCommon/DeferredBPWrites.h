@@ -0,0 +1,56 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+class PointerWrap;
+
+// BP register writes which are held back while vertices are queued, see BPWritten. If a game sets
+// a register back to its previous value before the next primitive, the writes can be dropped, and
+// the primitive can go into the same draw as the queued vertices.
+class DeferredBPWrites
+{
+public:
+  DeferredBPWrites();
+
+  bool IsEmpty() const { return m_addresses.empty(); }
+  // Returns the value the register will have for the next primitive.
+  u32 GetValue(u32 address, const u32* registers) const
+  {
+    return m_is_deferred[address] ? m_values[address] : registers[address];
+  }
+
+  void Defer(u32 address, u32 value);
+
+  // Drops the held back writes if none of them changes a register, and returns whether they were
+  // dropped.
+  bool DropIfUnchanged(const u32* registers);
+
+  // Calls apply(address, value) for every held back write that changes a register, and forgets
+  // all of them.
+  template <typename ApplyFunc>
+  void Apply(const u32* registers, ApplyFunc apply)
+  {
+    for (u8 address : m_addresses)
+    {
+      m_is_deferred[address] = false;
+      if (m_values[address] != registers[address])
+        apply(address, m_values[address]);
+    }
+    m_addresses.clear();
+  }
+
+  void Clear();
+  void DoState(PointerWrap& p);
+
+private:
+  std::array<u32, 256> m_values;
+  std::array<bool, 256> m_is_deferred;
+  std::vector<u8> m_addresses;
+};
@@ -2,20 +2,44 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cinttypes>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <numeric>
+#include <string>
+#include <utility>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/PerfMetrics.h"
 #include "Common/Timer.h"
+#include "Core/HW/SystemTimers.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/VideoConfig.h"
 
 static constexpr u64 FPS_REFRESH_INTERVAL = 250000;
 
+// A frame is a stutter if it takes at least twice as long as the average of the frames before
+// it, and at least 5 ms longer. The average is only trusted once it has seen a few frames.
+static constexpr double STUTTER_FACTOR = 2.0;
+static constexpr u64 STUTTER_MIN_EXCESS = 5000;
+static constexpr u64 STUTTER_MIN_FRAMES = 16;
+// Weight of a new frame in the moving average of the frame times.
+static constexpr double AVERAGE_WEIGHT = 1.0 / 8;
+
+static PerfMetrics::Counter s_stutters("fpscounter.stutters");
+
 FPSCounter::FPSCounter()
 {
   m_last_time = Common::Timer::GetTimeUs();
+  m_last_gpu_busy_time = Fifo::GetGpuBusyTime();
+  m_last_cpu_wait_time = Fifo::GetCpuWaitTime() + SystemTimers::GetTimeSpentSleeping();
+  m_sorted_frame_times.reserve(NUM_SAMPLES);
 }
 
 void FPSCounter::LogRenderTimeToFile(u64 val)
@@ -35,15 +59,102 @@ void FPSCounter::Update()
   u64 diff = time - m_last_time;
   if (g_ActiveConfig.bLogRenderTimeToFile)
     LogRenderTimeToFile(diff);
+  m_last_time = time;
+
+  const u64 gpu_busy_time = Fifo::GetGpuBusyTime();
+  const u64 cpu_wait_time = Fifo::GetCpuWaitTime() + SystemTimers::GetTimeSpentSleeping();
+
+  FrameSample sample;
+  sample.frame_time = diff;
+  sample.gpu_busy_time = gpu_busy_time - m_last_gpu_busy_time;
+  sample.cpu_busy_time = diff - std::min(diff, cpu_wait_time - m_last_cpu_wait_time);
+  sample.events = PerfMetrics::TakeFrameEvents();
+  m_last_gpu_busy_time = gpu_busy_time;
+  m_last_cpu_wait_time = cpu_wait_time;
+
+  AddFrame(sample);
+}
+
+void FPSCounter::AddFrame(const FrameSample& sample)
+{
+  m_samples[m_total_frames % NUM_SAMPLES] = sample;
+  m_num_samples = std::min(m_num_samples + 1, NUM_SAMPLES);
+  m_total_frames++;
+
+  if (m_total_frames > STUTTER_MIN_FRAMES &&
+      sample.frame_time >= m_average_frame_time * STUTTER_FACTOR &&
+      sample.frame_time >= m_average_frame_time + STUTTER_MIN_EXCESS)
+  {
+    ReportStutter(sample);
+  }
+
+  if (m_total_frames == 1)
+    m_average_frame_time = static_cast<double>(sample.frame_time);
+  else
+    m_average_frame_time += (sample.frame_time - m_average_frame_time) * AVERAGE_WEIGHT;
 
   m_frame_counter++;
-  m_time_since_update += diff;
-  m_last_time = time;
+  m_time_since_update += sample.frame_time;
 
   if (m_time_since_update >= FPS_REFRESH_INTERVAL)
   {
     m_fps = m_frame_counter / (m_time_since_update / 1000000.0);
     m_frame_counter = 0;
     m_time_since_update = 0;
+    UpdateLowFPS();
   }
 }
+
+void FPSCounter::UpdateLowFPS()
+{
+  m_sorted_frame_times.clear();
+  for (size_t i = 0; i < m_num_samples; ++i)
+    m_sorted_frame_times.push_back(m_samples[i].frame_time);
+
+  // Only the slowest 1% need to be in order, the 0.1% are the start of them.
+  const size_t one_percent = std::max<size_t>(m_num_samples / 100, 1);
+  const size_t point_one_percent = std::max<size_t>(m_num_samples / 1000, 1);
+  std::partial_sort(m_sorted_frame_times.begin(), m_sorted_frame_times.begin() + one_percent,
+                    m_sorted_frame_times.end(), std::greater<u64>());
+
+  const auto AverageFPS = [this](size_t count) {
+    const u64 total =
+        std::accumulate(m_sorted_frame_times.begin(), m_sorted_frame_times.begin() + count, u64{0});
+    return total ? static_cast<float>(count * 1000000.0 / total) : 0.0f;
+  };
+  m_one_percent_low_fps = AverageFPS(one_percent);
+  m_point_one_percent_low_fps = AverageFPS(point_one_percent);
+}
+
+void FPSCounter::ReportStutter(const FrameSample& sample)
+{
+  s_stutters.Add();
+  m_stutter_count++;
+
+  const u64 frame = m_total_frames - 1;
+  const u64 average = static_cast<u64>(m_average_frame_time);
+  m_recent_stutters.push_back({frame, sample, average});
+  if (m_recent_stutters.size() > MAX_RECENT_STUTTERS)
+    m_recent_stutters.pop_front();
+
+  static constexpr std::array<std::pair<u32, const char*>, 4> event_names = {{
+      {PerfMetrics::FRAME_EVENT_SHADER_COMPILE, "shader compile"},
+      {PerfMetrics::FRAME_EVENT_TEXTURE_LOAD, "texture load"},
+      {PerfMetrics::FRAME_EVENT_JIT_COMPILE, "JIT compile"},
+      {PerfMetrics::FRAME_EVENT_DVD_READ, "DVD read"},
+  }};
+  std::string events;
+  for (const auto& event : event_names)
+  {
+    if (!(sample.events & event.first))
+      continue;
+    events += events.empty() ? " during " : ", ";
+    events += event.second;
+  }
+
+  INFO_LOG(VIDEO,
+           "Stutter: frame %" PRIu64 " took %.2f ms, average %.2f ms "
+           "(GPU busy %.2f ms, CPU busy %.2f ms)%s",
+           frame, sample.frame_time / 1000.0, average / 1000.0, sample.gpu_busy_time / 1000.0,
+           sample.cpu_busy_time / 1000.0, events.c_str());
+}
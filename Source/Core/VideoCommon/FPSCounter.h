@@ -4,20 +4,60 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
 #include <fstream>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
+// Besides the average frame rate, the FPS counter keeps the times of the recent frames, to find
+// the slow frames that the average hides. A frame that takes much longer than the ones before it
+// is reported as a stutter, along with the PerfMetrics::FrameEvent flags of what happened during
+// that frame.
 class FPSCounter
 {
 public:
+  // All times are in microseconds.
+  struct FrameSample
+  {
+    // From the previous present to this one.
+    u64 frame_time = 0;
+    // Spent running GPU commands.
+    u64 gpu_busy_time = 0;
+    // The frame time without the time the CPU thread spent waiting for the GPU thread, or sleeping
+    // to limit the emulation speed.
+    u64 cpu_busy_time = 0;
+    u32 events = 0;
+  };
+
+  struct Stutter
+  {
+    u64 frame;
+    FrameSample sample;
+    u64 average_frame_time;
+  };
+
+  // About a minute at 60 FPS, enough for the 0.1% lows to be more than a single frame.
+  static constexpr size_t NUM_SAMPLES = 4096;
+  static constexpr size_t MAX_RECENT_STUTTERS = 16;
+
   // Initializes the FPS counter.
   FPSCounter();
 
   // Called when a frame is rendered (updated every second).
   void Update();
 
+  // Adds a frame to the statistics. Update calls this with the measured times.
+  void AddFrame(const FrameSample& sample);
+
   float GetFPS() const { return m_fps; }
+  // The average frame rate of the slowest 1% and 0.1% of the recent frames.
+  float GetOnePercentLowFPS() const { return m_one_percent_low_fps; }
+  float GetPointOnePercentLowFPS() const { return m_point_one_percent_low_fps; }
+
+  u64 GetStutterCount() const { return m_stutter_count; }
+  const std::deque<Stutter>& GetRecentStutters() const { return m_recent_stutters; }
 
 private:
   u64 m_last_time = 0;
@@ -26,5 +66,21 @@ private:
   float m_fps = 0;
   std::ofstream m_bench_file;
 
+  u64 m_last_gpu_busy_time = 0;
+  u64 m_last_cpu_wait_time = 0;
+
+  std::array<FrameSample, NUM_SAMPLES> m_samples;
+  size_t m_num_samples = 0;
+  u64 m_total_frames = 0;
+  std::vector<u64> m_sorted_frame_times;
+  float m_one_percent_low_fps = 0;
+  float m_point_one_percent_low_fps = 0;
+
+  double m_average_frame_time = 0;
+  u64 m_stutter_count = 0;
+  std::deque<Stutter> m_recent_stutters;
+
   void LogRenderTimeToFile(u64 val);
+  void UpdateLowFPS();
+  void ReportStutter(const FrameSample& sample);
 };
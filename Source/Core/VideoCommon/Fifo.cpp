@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <optional>
 
 #include "Common/Assert.h"
 #include "Common/Atomic.h"
@@ -15,6 +16,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -26,6 +28,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -72,6 +75,12 @@ static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
 
+static PerfMetrics::Counter s_bytes_read("fifo.bytes_read");
+// Time the CPU thread spends waiting for the GPU thread to catch up.
+static PerfMetrics::Histogram s_cpu_wait_time("fifo.cpu_wait_us");
+// Time spent running the opcode decoder, on whichever thread does that.
+static PerfMetrics::Histogram s_gpu_busy_time("fifo.gpu_busy_us");
+
 void DoState(PointerWrap& p)
 {
   p.DoArray(s_video_buffer, FIFO_SIZE);
@@ -161,7 +170,10 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wait();
+    {
+      PerfMetrics::ScopedTimer timer(s_cpu_wait_time);
+      s_gpu_mainloop.Wait();
+    }
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -236,10 +248,13 @@ static void ReadDataFromFifo(u32 readPtr)
     memmove(s_video_buffer, s_video_buffer_read_ptr, existing_len);
     s_video_buffer_write_ptr = s_video_buffer + existing_len;
     s_video_buffer_read_ptr = s_video_buffer;
+    ADDSTAT(stats.thisFrame.bytesFifoMoved, existing_len);
   }
   // Copy new video instructions to s_video_buffer for future use in rendering the new picture
   Memory::CopyFromEmu(s_video_buffer_write_ptr, readPtr, len);
   s_video_buffer_write_ptr += len;
+  s_bytes_read.Add(len);
+  ADDSTAT(stats.thisFrame.bytesFifoRead, len);
 }
 
 // The deterministic_gpu_thread version.
@@ -272,6 +287,8 @@ static void ReadDataFromFifoOnCPU(u32 readPtr)
     }
   }
   Memory::CopyFromEmu(s_video_buffer_write_ptr, readPtr, len);
+  s_bytes_read.Add(len);
+  ADDSTAT(stats.thisFrame.bytesFifoRead, len);
   s_video_buffer_pp_read_ptr = OpcodeDecoder::Run<true>(
       DataReader(s_video_buffer_pp_read_ptr, write_ptr + len), nullptr, false);
   // This would have to be locked if the GPU thread didn't spin.
@@ -303,6 +320,8 @@ void RunGpuLoop()
         if (!s_emu_running_state.IsSet())
           return;
 
+        PerfMetrics::ScopedTimer busy_timer(s_gpu_busy_time);
+
         if (s_use_deterministic_gpu_thread)
         {
           AsyncRequests::GetInstance()->PullEvents();
@@ -400,6 +419,7 @@ void FlushGpu()
   if (!param.bCPUThread || s_use_deterministic_gpu_thread)
     return;
 
+  PerfMetrics::ScopedTimer timer(s_cpu_wait_time);
   s_gpu_mainloop.Wait();
 }
 
@@ -440,6 +460,9 @@ static int RunGpuOnCpu(int ticks)
 {
   CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
   bool reset_simd_state = false;
+  // The whole slice is timed, as a single run of the opcode decoder is usually shorter than the
+  // resolution of the timer.
+  std::optional<PerfMetrics::ScopedTimer> busy_timer;
   int available_ticks = int(ticks * SConfig::GetInstance().fSyncGpuOverclock) + s_sync_ticks.load();
   while (fifo.bFF_GPReadEnable && fifo.CPReadWriteDistance && !AtBreakpoint() &&
          available_ticks >= 0)
@@ -456,6 +479,7 @@ static int RunGpuOnCpu(int ticks)
         FPURoundMode::SaveSIMDState();
         FPURoundMode::LoadDefaultSIMDState();
         reset_simd_state = true;
+        busy_timer.emplace(s_gpu_busy_time);
       }
       ReadDataFromFifo(fifo.CPReadPointer);
       u32 cycles = 0;
@@ -490,6 +514,16 @@ static int RunGpuOnCpu(int ticks)
   return -available_ticks + GPU_TIME_SLOT_SIZE;
 }
 
+u64 GetGpuBusyTime()
+{
+  return s_gpu_busy_time.GetTotal();
+}
+
+u64 GetCpuWaitTime()
+{
+  return s_cpu_wait_time.GetTotal();
+}
+
 void UpdateWantDeterminism(bool want)
 {
   // We are paused (or not running at all yet), so
@@ -555,7 +589,10 @@ static int WaitForGpuThread(int ticks)
 
   // Wait for GPU
   if (now >= param.iSyncGpuMaxDistance)
+  {
+    PerfMetrics::ScopedTimer timer(s_cpu_wait_time);
     s_sync_wakeup_event.Wait();
+  }
 
   return GPU_TIME_SLOT_SIZE;
 }
@@ -45,4 +45,9 @@ void EmulatorState(bool running);
 bool AtBreakpoint();
 void ResetVideoBuffer();
 
+// Total microseconds spent running GPU commands, and spent by the CPU thread waiting for the GPU
+// thread, for the frame time analysis.
+u64 GetGpuBusyTime();
+u64 GetCpuWaitTime();
+
 }  // namespace Fifo
@@ -4,6 +4,12 @@
 
 #include <cstddef>
 
+#if defined(_M_X86)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/CommonTypes.h"
 #include "Common/Compiler.h"
 #include "Common/Logging/Log.h"
@@ -20,6 +26,124 @@ static const u16 s_primitive_restart = UINT16_MAX;
 
 static u16* (*primitive_table[8])(u16*, u32, u32);
 
+namespace
+{
+// The indices of most primitive types repeat with a fixed distance between the vertices, so the
+// bulk of a batch is written as vectors of 8 indices. Each pattern describes one step, which is
+// a whole number of primitives filling a whole number of vectors. The entries are offsets from
+// the running index, or one of the markers below.
+constexpr int RESTART = 0x10000;
+// The first vertex of the batch, which all the triangles of a fan share.
+constexpr int FIRST = 0x20000;
+
+template <size_t N>
+struct IndexPattern
+{
+  static_assert(N % 8 == 0, "Patterns must fill whole vectors");
+
+  alignas(16) u16 offset[N];
+  // All ones if the entry is relative to the running index, zero if it's the first vertex.
+  alignas(16) u16 running[N];
+  // All ones for primitive restart entries, which are ORed into the indices.
+  alignas(16) u16 restart[N];
+};
+
+template <size_t N>
+constexpr IndexPattern<N> MakeIndexPattern(const int (&entries)[N])
+{
+  IndexPattern<N> pattern = {};
+  for (size_t i = 0; i < N; ++i)
+  {
+    const bool is_marker = entries[i] == RESTART || entries[i] == FIRST;
+    pattern.offset[i] = is_marker ? 0 : static_cast<u16>(entries[i]);
+    pattern.running[i] = entries[i] == FIRST ? 0 : 0xFFFF;
+    pattern.restart[i] = entries[i] == RESTART ? 0xFFFF : 0;
+  }
+  return pattern;
+}
+
+constexpr int R = RESTART;
+constexpr int F = FIRST;
+
+// Points, line lists and triangle strips with primitive restart.
+constexpr auto s_sequential_pattern = MakeIndexPattern<8>({0, 1, 2, 3, 4, 5, 6, 7});
+// Triangle lists need 24 indices, so that a step ends on a whole triangle.
+constexpr auto s_list_pattern = MakeIndexPattern<24>(
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23});
+constexpr auto s_list_pr_pattern = MakeIndexPattern<8>({0, 1, 2, R, 3, 4, 5, R});
+// Every other triangle of a strip has its winding reversed.
+constexpr auto s_strip_pattern = MakeIndexPattern<24>({0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4,
+                                                       4, 5, 6, 5, 7, 6, 6, 7, 8, 7, 9, 8});
+// Relative to the third vertex, see the fan simulator below.
+constexpr auto s_fan_pr_pattern = MakeIndexPattern<24>({-1, 0, F, 1, 2,  R, 2,  3, F, 4,  5,  R,
+                                                        5,  6, F, 7, 8,  R, 8,  9, F, 10, 11, R});
+constexpr auto s_fan_pattern = MakeIndexPattern<24>({F, -1, 0, F, 0, 1, F, 1, 2, F, 2, 3,
+                                                     F, 3,  4, F, 4, 5, F, 5, 6, F, 6, 7});
+constexpr auto s_quads_pr_pattern = MakeIndexPattern<40>(
+    {1,  2,  0,  3,  R, 5,  6,  4,  7,  R, 9,  10, 8,  11, R, 13, 14, 12, 15, R,
+     17, 18, 16, 19, R, 21, 22, 20, 23, R, 25, 26, 24, 27, R, 29, 30, 28, 31, R});
+constexpr auto s_quads_pattern = MakeIndexPattern<24>(
+    {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 8, 9, 10, 8, 10, 11, 12, 13, 14, 12, 14, 15});
+constexpr auto s_line_strip_pattern = MakeIndexPattern<8>({0, 1, 1, 2, 2, 3, 3, 4});
+
+// Writes count steps of the pattern. The running index starts at running and advances by
+// vertices_per_step after each step.
+template <size_t N>
+u16* WriteIndexPattern(u16* Iptr, const IndexPattern<N>& pattern, u32 first, u32 running,
+                       u32 vertices_per_step, u32 count)
+{
+#if defined(_M_X86)
+  const __m128i first_vec = _mm_set1_epi16(static_cast<s16>(first));
+  const __m128i step_vec = _mm_set1_epi16(static_cast<s16>(vertices_per_step));
+  __m128i running_vec = _mm_set1_epi16(static_cast<s16>(running));
+  for (u32 i = 0; i < count; ++i)
+  {
+    for (size_t j = 0; j < N; j += 8)
+    {
+      const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(&pattern.running[j]));
+      const __m128i offset = _mm_load_si128(reinterpret_cast<const __m128i*>(&pattern.offset[j]));
+      const __m128i restart =
+          _mm_load_si128(reinterpret_cast<const __m128i*>(&pattern.restart[j]));
+      const __m128i base =
+          _mm_or_si128(_mm_and_si128(mask, running_vec), _mm_andnot_si128(mask, first_vec));
+      const __m128i indices = _mm_or_si128(_mm_add_epi16(base, offset), restart);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(Iptr + j), indices);
+    }
+    Iptr += N;
+    running_vec = _mm_add_epi16(running_vec, step_vec);
+  }
+#elif defined(_M_ARM_64)
+  const uint16x8_t first_vec = vdupq_n_u16(static_cast<u16>(first));
+  const uint16x8_t step_vec = vdupq_n_u16(static_cast<u16>(vertices_per_step));
+  uint16x8_t running_vec = vdupq_n_u16(static_cast<u16>(running));
+  for (u32 i = 0; i < count; ++i)
+  {
+    for (size_t j = 0; j < N; j += 8)
+    {
+      const uint16x8_t base = vbslq_u16(vld1q_u16(&pattern.running[j]), running_vec, first_vec);
+      const uint16x8_t indices =
+          vorrq_u16(vaddq_u16(base, vld1q_u16(&pattern.offset[j])), vld1q_u16(&pattern.restart[j]));
+      vst1q_u16(Iptr + j, indices);
+    }
+    Iptr += N;
+    running_vec = vaddq_u16(running_vec, step_vec);
+  }
+#else
+  for (u32 i = 0; i < count; ++i)
+  {
+    for (size_t j = 0; j < N; ++j)
+    {
+      const u32 base = pattern.running[j] ? running : first;
+      Iptr[j] = static_cast<u16>(base + pattern.offset[j]) | pattern.restart[j];
+    }
+    Iptr += N;
+    running += vertices_per_step;
+  }
+#endif
+  return Iptr;
+}
+}  // Anonymous namespace
+
 void IndexGenerator::Init()
 {
   if (g_Config.backend_info.bSupportsPrimitiveRestart)
@@ -72,7 +196,21 @@ DOLPHIN_FORCE_INLINE u16* IndexGenerator::WriteTriangle(u16* Iptr, u32 index1, u
 template <bool pr>
 u16* IndexGenerator::AddList(u16* Iptr, u32 const numVerts, u32 index)
 {
-  for (u32 i = 2; i < numVerts; i += 3)
+  u32 i = 2;
+  if (pr)
+  {
+    const u32 steps = numVerts / 6;
+    Iptr = WriteIndexPattern(Iptr, s_list_pr_pattern, index, index, 6, steps);
+    i += steps * 6;
+  }
+  else
+  {
+    const u32 steps = numVerts / 24;
+    Iptr = WriteIndexPattern(Iptr, s_list_pattern, index, index, 24, steps);
+    i += steps * 24;
+  }
+
+  for (; i < numVerts; i += 3)
   {
     Iptr = WriteTriangle<pr>(Iptr, index + i - 2, index + i - 1, index + i);
   }
@@ -84,7 +222,10 @@ u16* IndexGenerator::AddStrip(u16* Iptr, u32 const numVerts, u32 index)
 {
   if (pr)
   {
-    for (u32 i = 0; i < numVerts; ++i)
+    const u32 steps = numVerts / 8;
+    Iptr = WriteIndexPattern(Iptr, s_sequential_pattern, index, index, 8, steps);
+
+    for (u32 i = steps * 8; i < numVerts; ++i)
     {
       *Iptr++ = index + i;
     }
@@ -92,8 +233,12 @@ u16* IndexGenerator::AddStrip(u16* Iptr, u32 const numVerts, u32 index)
   }
   else
   {
+    // Each step writes an even number of triangles, so the winding starts out the same after it.
+    const u32 steps = numVerts > 2 ? (numVerts - 2) / 8 : 0;
+    Iptr = WriteIndexPattern(Iptr, s_strip_pattern, index, index, 8, steps);
+
     bool wind = false;
-    for (u32 i = 2; i < numVerts; ++i)
+    for (u32 i = 2 + steps * 8; i < numVerts; ++i)
     {
       Iptr = WriteTriangle<pr>(Iptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -129,6 +274,10 @@ u16* IndexGenerator::AddFan(u16* Iptr, u32 numVerts, u32 index)
 
   if (pr)
   {
+    const u32 steps = numVerts > 2 ? (numVerts - 2) / 12 : 0;
+    Iptr = WriteIndexPattern(Iptr, s_fan_pr_pattern, index, index + i, 12, steps);
+    i += steps * 12;
+
     for (; i + 3 <= numVerts; i += 3)
     {
       *Iptr++ = index + i - 1;
@@ -148,6 +297,12 @@ u16* IndexGenerator::AddFan(u16* Iptr, u32 numVerts, u32 index)
       *Iptr++ = s_primitive_restart;
     }
   }
+  else
+  {
+    const u32 steps = numVerts > 2 ? (numVerts - 2) / 8 : 0;
+    Iptr = WriteIndexPattern(Iptr, s_fan_pattern, index, index + i, 8, steps);
+    i += steps * 8;
+  }
 
   for (; i < numVerts; ++i)
   {
@@ -177,6 +332,19 @@ template <bool pr>
 u16* IndexGenerator::AddQuads(u16* Iptr, u32 numVerts, u32 index)
 {
   u32 i = 3;
+  if (pr)
+  {
+    const u32 steps = numVerts / 32;
+    Iptr = WriteIndexPattern(Iptr, s_quads_pr_pattern, index, index, 32, steps);
+    i += steps * 32;
+  }
+  else
+  {
+    const u32 steps = numVerts / 16;
+    Iptr = WriteIndexPattern(Iptr, s_quads_pattern, index, index, 16, steps);
+    i += steps * 16;
+  }
+
   for (; i < numVerts; i += 4)
   {
     if (pr)
@@ -213,7 +381,10 @@ u16* IndexGenerator::AddQuads_nonstandard(u16* Iptr, u32 numVerts, u32 index)
 // Lines
 u16* IndexGenerator::AddLineList(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 1; i < numVerts; i += 2)
+  const u32 steps = numVerts / 8;
+  Iptr = WriteIndexPattern(Iptr, s_sequential_pattern, index, index, 8, steps);
+
+  for (u32 i = 1 + steps * 8; i < numVerts; i += 2)
   {
     *Iptr++ = index + i - 1;
     *Iptr++ = index + i;
@@ -225,7 +396,10 @@ u16* IndexGenerator::AddLineList(u16* Iptr, u32 numVerts, u32 index)
 // so converting them to lists
 u16* IndexGenerator::AddLineStrip(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 1; i < numVerts; ++i)
+  const u32 steps = numVerts > 1 ? (numVerts - 1) / 4 : 0;
+  Iptr = WriteIndexPattern(Iptr, s_line_strip_pattern, index, index, 4, steps);
+
+  for (u32 i = 1 + steps * 4; i < numVerts; ++i)
   {
     *Iptr++ = index + i - 1;
     *Iptr++ = index + i;
@@ -236,7 +410,10 @@ u16* IndexGenerator::AddLineStrip(u16* Iptr, u32 numVerts, u32 index)
 // Points
 u16* IndexGenerator::AddPoints(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 0; i != numVerts; ++i)
+  const u32 steps = numVerts / 8;
+  Iptr = WriteIndexPattern(Iptr, s_sequential_pattern, index, index, 8, steps);
+
+  for (u32 i = steps * 8; i != numVerts; ++i)
   {
     *Iptr++ = index + i;
   }
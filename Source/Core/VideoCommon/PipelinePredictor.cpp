@@ -0,0 +1,81 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/PipelinePredictor.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace VideoCommon
+{
+bool PipelinePredictor::Observe(u64 pipeline)
+{
+  if (m_has_last_pipeline && m_last_pipeline == pipeline)
+    return false;
+
+  if (m_has_last_pipeline)
+    AddSuccessor(&m_successors[m_last_pipeline], pipeline, 1);
+
+  m_last_pipeline = pipeline;
+  m_has_last_pipeline = true;
+  return true;
+}
+
+void PipelinePredictor::AddSuccessor(Successors* successors, u64 pipeline, u32 count)
+{
+  auto iter = std::find_if(successors->begin(), successors->end(), [pipeline](const Successor& s) {
+    return s.count != 0 && s.pipeline == pipeline;
+  });
+
+  if (iter == successors->end())
+  {
+    // Replace the least common successor, or an empty slot, which are at the end.
+    iter = successors->end() - 1;
+    *iter = {pipeline, 0};
+  }
+
+  if (iter->count > std::numeric_limits<u32>::max() - count)
+  {
+    // Halve all counts instead of overflowing, which keeps their order.
+    for (Successor& successor : *successors)
+      successor.count /= 2;
+  }
+  iter->count += count;
+
+  // Keep the successors sorted by count.
+  while (iter != successors->begin() && (iter - 1)->count < iter->count)
+  {
+    std::swap(*(iter - 1), *iter);
+    --iter;
+  }
+}
+
+std::vector<PipelinePredictor::Transition> PipelinePredictor::GetTransitions() const
+{
+  std::vector<Transition> transitions;
+  for (const auto& entry : m_successors)
+  {
+    for (const Successor& successor : entry.second)
+    {
+      if (successor.count != 0)
+        transitions.push_back({entry.first, successor.pipeline, successor.count});
+    }
+  }
+  return transitions;
+}
+
+void PipelinePredictor::AddTransition(const Transition& transition)
+{
+  if (transition.count != 0)
+    AddSuccessor(&m_successors[transition.from], transition.to, transition.count);
+}
+
+void PipelinePredictor::Clear()
+{
+  m_successors.clear();
+  m_has_last_pipeline = false;
+}
+
+}  // namespace VideoCommon
@@ -0,0 +1,75 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace VideoCommon
+{
+// Learns which pipelines tend to be used after each other, so that the ones which are likely to
+// be needed next can be compiled before a draw asks for them. Pipelines are identified by a hash
+// of their UID, which stays the same across runs, so the transitions can be saved to disk.
+class PipelinePredictor
+{
+public:
+  // The number of successors remembered for each pipeline. When a new successor shows up, it
+  // replaces the one seen the least often.
+  static constexpr size_t MAX_SUCCESSORS = 4;
+  // Successors which were only seen once may just as well be a coincidence.
+  static constexpr u32 MIN_PREDICTION_COUNT = 2;
+
+  struct Transition
+  {
+    u64 from;
+    u64 to;
+    u32 count;
+  };
+
+  // Records that the pipeline is used after the previously observed one. Returns false if the
+  // pipeline is the same as the previous one, in which case there is nothing to learn.
+  bool Observe(u64 pipeline);
+
+  // Calls f with each pipeline that is likely to be used after the given one, the most likely
+  // one first.
+  template <typename F>
+  void ForEachPrediction(u64 pipeline, F f) const
+  {
+    auto iter = m_successors.find(pipeline);
+    if (iter == m_successors.end())
+      return;
+
+    for (const Successor& successor : iter->second)
+    {
+      // The successors are sorted by their count.
+      if (successor.count < MIN_PREDICTION_COUNT)
+        break;
+      f(successor.pipeline);
+    }
+  }
+
+  std::vector<Transition> GetTransitions() const;
+  void AddTransition(const Transition& transition);
+  void Clear();
+
+private:
+  struct Successor
+  {
+    u64 pipeline;
+    u32 count;
+  };
+  using Successors = std::array<Successor, MAX_SUCCESSORS>;
+
+  static void AddSuccessor(Successors* successors, u64 pipeline, u32 count);
+
+  std::unordered_map<u64, Successors> m_successors;
+  u64 m_last_pipeline = 0;
+  bool m_has_last_pipeline = false;
+};
+
+}  // namespace VideoCommon
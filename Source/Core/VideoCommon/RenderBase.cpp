@@ -29,6 +29,7 @@
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 #include "Common/Profiler.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
@@ -257,7 +258,9 @@ void Renderer::DrawDebugText()
   if (g_ActiveConfig.bShowFPS || SConfig::GetInstance().m_ShowFrameCount)
   {
     if (g_ActiveConfig.bShowFPS)
-      final_cyan += StringFromFormat("FPS: %.2f", m_fps_counter.GetFPS());
+      final_cyan += StringFromFormat("FPS: %.2f (1%% low: %.2f, 0.1%% low: %.2f)",
+                                     m_fps_counter.GetFPS(), m_fps_counter.GetOnePercentLowFPS(),
+                                     m_fps_counter.GetPointOnePercentLowFPS());
 
     if (g_ActiveConfig.bShowFPS && SConfig::GetInstance().m_ShowFrameCount)
       final_cyan += " - ";
@@ -699,6 +702,7 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
       SetWindowSize(texture_config.width, texture_config.height);
 
       m_fps_counter.Update();
+      PerfMetrics::SampleFrame();
 
       DolphinAnalytics::PerformanceSample perf_sample;
       perf_sample.speed_ratio = SystemTimers::GetEstimatedEmulationPerformance();
@@ -802,57 +806,78 @@ void Renderer::RenderFrameDump()
 
 void Renderer::QueueFrameDumpReadback()
 {
-  // Index 0 was just sent to AVI dump. Swap with the second texture.
-  if (m_frame_dump_readback_textures[0])
-    std::swap(m_frame_dump_readback_textures[0], m_frame_dump_readback_textures[1]);
+  // The frame that used this staging texture last must have been submitted and encoded.
+  SubmitFrameDumpReadbacks(FRAME_DUMP_BUFFERED_FRAMES - 1);
+  if (m_frame_dump_frames_queued - m_frame_dump_frames_encoded.load() >=
+      FRAME_DUMP_BUFFERED_FRAMES)
+  {
+    m_frame_dump_late_frames++;
+    while (m_frame_dump_frames_queued - m_frame_dump_frames_encoded.load() >=
+           FRAME_DUMP_BUFFERED_FRAMES)
+    {
+      m_frame_dump_done.Wait();
+    }
+  }
 
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
+  const size_t index = m_frame_dump_frames_queued % FRAME_DUMP_BUFFERED_FRAMES;
+  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[index];
+  if (rbtex && rbtex->IsMapped())
+    rbtex->Unmap();
   if (!rbtex || rbtex->GetConfig() != m_frame_dump_render_texture->GetConfig())
   {
     rbtex = CreateStagingTexture(StagingTextureType::Readback,
                                  m_frame_dump_render_texture->GetConfig());
   }
 
-  m_last_frame_state = AVIDump::FetchState(m_last_xfb_ticks);
-  m_last_frame_exported = true;
+  m_frame_dump_readback_states[index] = AVIDump::FetchState(m_last_xfb_ticks);
   rbtex->CopyFromTexture(m_frame_dump_render_texture.get(), 0, 0);
+  m_frame_dump_frames_queued++;
 }
 
-void Renderer::FlushFrameDump()
+void Renderer::SubmitFrameDumpReadbacks(u64 max_pending)
 {
-  if (!m_last_frame_exported)
-    return;
-
-  // Ensure the previously-queued frame was encoded.
-  FinishFrameData();
-
-  // Queue encoding of the last frame dumped.
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
-  rbtex->Flush();
-  if (rbtex->Map())
+  while (m_frame_dump_frames_queued - m_frame_dump_frames_submitted > max_pending)
   {
-    DumpFrameData(reinterpret_cast<u8*>(rbtex->GetMappedPointer()), rbtex->GetConfig().width,
-                  rbtex->GetConfig().height, static_cast<int>(rbtex->GetMappedStride()),
-                  m_last_frame_state);
-    rbtex->Unmap();
+    const size_t index = m_frame_dump_frames_submitted % FRAME_DUMP_BUFFERED_FRAMES;
+    std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[index];
+    m_frame_dump_frames_submitted++;
+
+    // The texture stays mapped until it is reused, since the encoder reads from it directly.
+    // Lost frames are still queued, so that the encoder finishes the frames in order.
+    rbtex->Flush();
+    if (rbtex->Map())
+    {
+      DumpFrameData({reinterpret_cast<u8*>(rbtex->GetMappedPointer()),
+                     static_cast<int>(rbtex->GetConfig().width),
+                     static_cast<int>(rbtex->GetConfig().height),
+                     static_cast<int>(rbtex->GetMappedStride()),
+                     m_frame_dump_readback_states[index]});
+    }
+    else
+    {
+      m_frame_dump_dropped_frames++;
+      DumpFrameData({nullptr, 0, 0, 0, m_frame_dump_readback_states[index]});
+    }
   }
+}
 
-  m_last_frame_exported = false;
-
-  // Shutdown frame dumping if it is no longer active.
-  if (!IsFrameDumping())
+void Renderer::FlushFrameDump()
+{
+  if (IsFrameDumping())
+    SubmitFrameDumpReadbacks(FRAME_DUMP_READBACK_LATENCY - 1);
+  else
     ShutdownFrameDumping();
 }
 
 void Renderer::ShutdownFrameDumping()
 {
-  // Ensure the last queued readback has been sent to the encoder.
-  FlushFrameDump();
+  // Ensure all queued readbacks have been sent to the encoder.
+  SubmitFrameDumpReadbacks(0);
 
   if (!m_frame_dump_thread_running.IsSet())
     return;
 
-  // Ensure previous frame has been encoded.
+  // Ensure previous frames have been encoded.
   FinishFrameData();
 
   // Wake thread up, and wait for it to exit.
@@ -862,12 +887,29 @@ void Renderer::ShutdownFrameDumping()
     m_frame_dump_thread.join();
   m_frame_dump_render_texture.reset();
   for (auto& tex : m_frame_dump_readback_textures)
+  {
+    if (tex && tex->IsMapped())
+      tex->Unmap();
     tex.reset();
+  }
+
+  if (m_frame_dump_late_frames != 0 || m_frame_dump_dropped_frames != 0)
+  {
+    WARN_LOG(VIDEO, "Frame dump: %u frames waited for the encoder, %u frames were dropped",
+             m_frame_dump_late_frames, m_frame_dump_dropped_frames);
+    OSD::AddMessage(StringFromFormat("Frame dump: %u late frames, %u dropped frames",
+                                     m_frame_dump_late_frames, m_frame_dump_dropped_frames));
+  }
+  m_frame_dump_late_frames = 0;
+  m_frame_dump_dropped_frames = 0;
 }
 
-void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state)
+void Renderer::DumpFrameData(const FrameDumpConfig& config)
 {
-  m_frame_dump_config = FrameDumpConfig{data, w, h, stride, state};
+  {
+    std::lock_guard<std::mutex> guard(m_frame_dump_queue_lock);
+    m_frame_dump_queue.push_back(config);
+  }
 
   if (!m_frame_dump_thread_running.IsSet())
   {
@@ -879,16 +921,12 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVI
 
   // Wake worker thread up.
   m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
 }
 
 void Renderer::FinishFrameData()
 {
-  if (!m_frame_dump_frame_running)
-    return;
-
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  while (m_frame_dump_frames_encoded.load() != m_frame_dump_frames_submitted)
+    m_frame_dump_done.Wait();
 }
 
 void Renderer::RunFrameDumps()
@@ -910,50 +948,27 @@ void Renderer::RunFrameDumps()
   while (true)
   {
     m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
-      break;
-
-    auto config = m_frame_dump_config;
-
-    // Save screenshot
-    if (m_screenshot_request.TestAndClear())
-    {
-      std::lock_guard<std::mutex> lk(m_screenshot_lock);
 
-      if (TextureToPng(config.data, config.stride, m_screenshot_name, config.width, config.height,
-                       false))
-        OSD::AddMessage("Screenshot saved to " + m_screenshot_name);
-
-      // Reset settings
-      m_screenshot_name.clear();
-      m_screenshot_completed.Set();
-    }
-
-    if (SConfig::GetInstance().m_DumpFrames)
+    while (true)
     {
-      if (!frame_dump_started)
+      FrameDumpConfig config;
       {
-        if (dump_to_avi)
-          frame_dump_started = StartFrameDumpToAVI(config);
-        else
-          frame_dump_started = StartFrameDumpToImage(config);
-
-        // Stop frame dumping if we fail to start.
-        if (!frame_dump_started)
-          SConfig::GetInstance().m_DumpFrames = false;
+        std::lock_guard<std::mutex> guard(m_frame_dump_queue_lock);
+        if (m_frame_dump_queue.empty())
+          break;
+        config = m_frame_dump_queue.front();
+        m_frame_dump_queue.pop_front();
       }
 
-      // If we failed to start frame dumping, don't write a frame.
-      if (frame_dump_started)
-      {
-        if (dump_to_avi)
-          DumpFrameToAVI(config);
-        else
-          DumpFrameToImage(config);
-      }
+      if (config.data)
+        DumpFrame(config, &frame_dump_started, dump_to_avi);
+
+      m_frame_dump_frames_encoded++;
+      m_frame_dump_done.Set();
     }
 
-    m_frame_dump_done.Set();
+    if (!m_frame_dump_thread_running.IsSet())
+      break;
   }
 
   if (frame_dump_started)
@@ -964,6 +979,47 @@ void Renderer::RunFrameDumps()
   }
 }
 
+void Renderer::DumpFrame(const FrameDumpConfig& config, bool* frame_dump_started, bool dump_to_avi)
+{
+  // Save screenshot
+  if (m_screenshot_request.TestAndClear())
+  {
+    std::lock_guard<std::mutex> lk(m_screenshot_lock);
+
+    if (TextureToPng(config.data, config.stride, m_screenshot_name, config.width, config.height,
+                     false))
+      OSD::AddMessage("Screenshot saved to " + m_screenshot_name);
+
+    // Reset settings
+    m_screenshot_name.clear();
+    m_screenshot_completed.Set();
+  }
+
+  if (SConfig::GetInstance().m_DumpFrames)
+  {
+    if (!*frame_dump_started)
+    {
+      if (dump_to_avi)
+        *frame_dump_started = StartFrameDumpToAVI(config);
+      else
+        *frame_dump_started = StartFrameDumpToImage(config);
+
+      // Stop frame dumping if we fail to start.
+      if (!*frame_dump_started)
+        SConfig::GetInstance().m_DumpFrames = false;
+    }
+
+    // If we failed to start frame dumping, don't write a frame.
+    if (*frame_dump_started)
+    {
+      if (dump_to_avi)
+        DumpFrameToAVI(config);
+      else
+        DumpFrameToImage(config);
+    }
+  }
+}
+
 #if defined(HAVE_FFMPEG)
 
 bool Renderer::StartFrameDumpToAVI(const FrameDumpConfig& config)
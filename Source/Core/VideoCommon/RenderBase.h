@@ -15,7 +15,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -255,26 +257,45 @@ private:
   int m_last_window_request_height = 0;
 
   // frame dumping
+  // Frames are read back into a ring of staging textures, and are only handed to the encoder
+  // FRAME_DUMP_READBACK_LATENCY frames later, so that waiting for the copy doesn't stall.
+  // The encoder reads the frames straight from the mapped staging textures, so a texture can
+  // only be reused once its frame was encoded.
+  static constexpr size_t FRAME_DUMP_BUFFERED_FRAMES = 4;
+  static constexpr u64 FRAME_DUMP_READBACK_LATENCY = 2;
+
   std::thread m_frame_dump_thread;
   Common::Event m_frame_dump_start;
   Common::Event m_frame_dump_done;
   Common::Flag m_frame_dump_thread_running;
   u32 m_frame_dump_image_counter = 0;
-  bool m_frame_dump_frame_running = false;
   struct FrameDumpConfig
   {
+    // nullptr if the frame couldn't be read back.
     const u8* data;
     int width;
     int height;
     int stride;
     AVIDump::Frame state;
-  } m_frame_dump_config;
+  };
+  std::mutex m_frame_dump_queue_lock;
+  std::deque<FrameDumpConfig> m_frame_dump_queue;
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
-  std::array<std::unique_ptr<AbstractStagingTexture>, 2> m_frame_dump_readback_textures;
-  AVIDump::Frame m_last_frame_state;
-  bool m_last_frame_exported = false;
+  std::array<std::unique_ptr<AbstractStagingTexture>, FRAME_DUMP_BUFFERED_FRAMES>
+      m_frame_dump_readback_textures;
+  std::array<AVIDump::Frame, FRAME_DUMP_BUFFERED_FRAMES> m_frame_dump_readback_states;
+
+  // Frame counts of the pipeline stages. Only the encoded count is written by the frame dumping
+  // thread.
+  u64 m_frame_dump_frames_queued = 0;
+  u64 m_frame_dump_frames_submitted = 0;
+  std::atomic<u64> m_frame_dump_frames_encoded{0};
+  // Frames that had to wait for the encoder to free a staging texture, and frames that were
+  // lost because their staging texture couldn't be mapped.
+  u32 m_frame_dump_late_frames = 0;
+  u32 m_frame_dump_dropped_frames = 0;
 
   // Tracking of XFB textures so we don't render duplicate frames.
   AbstractTexture* m_last_xfb_texture = nullptr;
@@ -290,6 +311,7 @@ private:
   s32 m_osd_time = 0;
 
   // NOTE: The methods below are called on the framedumping thread.
+  void DumpFrame(const FrameDumpConfig& config, bool* frame_dump_started, bool dump_to_avi);
   bool StartFrameDumpToAVI(const FrameDumpConfig& config);
   void DumpFrameToAVI(const FrameDumpConfig& config);
   void StopFrameDumpToAVI();
@@ -306,16 +328,19 @@ private:
   // Fills the frame dump render texture with the current XFB texture.
   void RenderFrameDump();
 
-  // Queues the current frame for readback, which will be written to AVI next frame.
+  // Queues the current frame for readback, which will be written to AVI a few frames later.
   void QueueFrameDumpReadback();
 
-  // Asynchronously encodes the specified pointer of frame data to the frame dump.
-  void DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state);
+  // Hands the oldest readbacks to the encoder, until no more than max_pending are left.
+  void SubmitFrameDumpReadbacks(u64 max_pending);
+
+  // Asynchronously encodes the specified frame data to the frame dump.
+  void DumpFrameData(const FrameDumpConfig& config);
 
-  // Ensures all rendered frames are queued for encoding.
+  // Submits the readbacks that are due, or all of them if frame dumping has stopped.
   void FlushFrameDump();
 
-  // Ensures all encoded frames have been written to the output file.
+  // Ensures all submitted frames have been written to the output file.
   void FinishFrameData();
 };
 
@@ -4,9 +4,12 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <xxhash.h>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/PerfMetrics.h"
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
 
@@ -18,6 +21,13 @@
 
 std::unique_ptr<VideoCommon::ShaderCache> g_shader_cache;
 
+// Shader compile times include the ones on the worker threads. Pipeline compile times are only
+// taken for the pipelines that the GPU thread waits for.
+static PerfMetrics::Histogram s_shader_compile_time("shadercache.shader_compile_us",
+                                                    PerfMetrics::FRAME_EVENT_SHADER_COMPILE);
+static PerfMetrics::Histogram s_pipeline_compile_time("shadercache.pipeline_compile_us",
+                                                      PerfMetrics::FRAME_EVENT_SHADER_COMPILE);
+
 namespace VideoCommon
 {
 ShaderCache::ShaderCache() = default;
@@ -32,6 +42,7 @@ bool ShaderCache::Initialize()
 
   // Create the async compiler, and start the worker threads.
   m_async_shader_compiler = g_renderer->CreateAsyncShaderCompiler();
+  m_async_shader_compiler->SetPriorityAgingLimit(COMPILE_PRIORITY_PREDICTED_PIPELINE);
   m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderPrecompilerThreads());
 
   // Load shader and UID caches.
@@ -105,17 +116,25 @@ void ShaderCache::Shutdown()
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
   auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end() && !it->second.second)
-    return it->second.first.get();
+  if (it != m_gx_pipeline_cache.end() && !it->second.pending)
+  {
+    PredictNextPipelines(it->second);
+    return it->second.pipeline.get();
+  }
 
   const bool exists_in_cache = it != m_gx_pipeline_cache.end();
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
+  {
+    PerfMetrics::ScopedTimer timer(s_pipeline_compile_time);
     pipeline = g_renderer->CreatePipeline(*pipeline_config);
+  }
   if (g_ActiveConfig.bShaderCache && !exists_in_cache)
     AppendGXPipelineUID(uid);
-  return InsertGXPipeline(uid, std::move(pipeline));
+  const AbstractPipeline* result = InsertGXPipeline(uid, std::move(pipeline));
+  PredictNextPipelines(GetGXPipelineEntry(uid)->second);
+  return result;
 }
 
 std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const GXPipelineUid& uid)
@@ -123,15 +142,20 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end())
   {
-    // .second is the pending flag, i.e. compiling in the background.
-    if (!it->second.second)
-      return it->second.first.get();
-    else
-      return {};
+    PredictNextPipelines(it->second);
+
+    // The pending flag means compiling in the background.
+    if (!it->second.pending)
+      return it->second.pipeline.get();
+
+    // It may still be waiting behind the pipelines from the UID cache, but it is needed now.
+    PromotePipelineCompile(it, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+    return {};
   }
 
   AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+  PredictNextPipelines(GetGXPipelineEntry(uid)->second);
   return {};
 }
 
@@ -144,7 +168,10 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXUberPipelineConfig(uid);
   if (pipeline_config)
+  {
+    PerfMetrics::ScopedTimer timer(s_pipeline_compile_time);
     pipeline = g_renderer->CreatePipeline(*pipeline_config);
+  }
   return InsertGXUberPipeline(uid, std::move(pipeline));
 }
 
@@ -250,7 +277,7 @@ void ShaderCache::CompileMissingPipelines()
   // Queue all uids with a null pipeline for compilation.
   for (auto& it : m_gx_pipeline_cache)
   {
-    if (!it.second.second)
+    if (!it.second.pending)
       QueuePipelineCompile(it.first, COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
   }
   for (auto& it : m_gx_uber_pipeline_cache)
@@ -265,8 +292,8 @@ void ShaderCache::InvalidateCachedPipelines()
   // Set the pending flag to false, and destroy the pipeline.
   for (auto& it : m_gx_pipeline_cache)
   {
-    it.second.first.reset();
-    it.second.second = false;
+    it.second.pipeline.reset();
+    it.second.pending = false;
   }
   for (auto& it : m_gx_uber_pipeline_cache)
   {
@@ -277,12 +304,14 @@ void ShaderCache::InvalidateCachedPipelines()
 
 void ShaderCache::ClearPipelineCaches()
 {
+  m_gx_pipelines_by_hash.clear();
   m_gx_pipeline_cache.clear();
   m_gx_uber_pipeline_cache.clear();
 }
 
 std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
 {
+  PerfMetrics::ScopedTimer timer(s_shader_compile_time);
   ShaderCode source_code = GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer().c_str(),
                                             source_code.GetBuffer().size());
@@ -291,6 +320,7 @@ std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexSha
 std::unique_ptr<AbstractShader>
 ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const
 {
+  PerfMetrics::ScopedTimer timer(s_shader_compile_time);
   ShaderCode source_code = UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer().c_str(),
                                             source_code.GetBuffer().size());
@@ -298,6 +328,7 @@ ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) con
 
 std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid) const
 {
+  PerfMetrics::ScopedTimer timer(s_shader_compile_time);
   ShaderCode source_code = GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer().c_str(),
                                             source_code.GetBuffer().size());
@@ -306,6 +337,7 @@ std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShade
 std::unique_ptr<AbstractShader>
 ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const
 {
+  PerfMetrics::ScopedTimer timer(s_shader_compile_time);
   ShaderCode source_code = UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer().c_str(),
                                             source_code.GetBuffer().size());
@@ -529,12 +561,12 @@ ShaderCache::GetGXUberPipelineConfig(const GXUberPipelineUid& config)
 const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& config,
                                                       std::unique_ptr<AbstractPipeline> pipeline)
 {
-  auto& entry = m_gx_pipeline_cache[config];
-  entry.second = false;
-  if (!entry.first && pipeline)
-    entry.first = std::move(pipeline);
+  GXPipelineEntry& entry = GetGXPipelineEntry(config)->second;
+  entry.pending = false;
+  if (!entry.pipeline && pipeline)
+    entry.pipeline = std::move(pipeline);
 
-  return entry.first.get();
+  return entry.pipeline.get();
 }
 
 const AbstractPipeline*
@@ -621,14 +653,69 @@ void ShaderCache::LoadPipelineUIDCache()
 
   INFO_LOG(VIDEO, "Read %u pipeline UIDs from %s",
            static_cast<unsigned>(m_gx_pipeline_cache.size()), filename.c_str());
+
+  // The predictions are kept next to the UID cache, for the same games.
+  m_save_pipeline_predictions = m_gx_pipeline_uid_cache_file.IsOpen();
+  if (m_save_pipeline_predictions)
+    LoadPipelinePredictions();
 }
 
 void ShaderCache::ClosePipelineUIDCache()
 {
   // This is left as a method in case we need to append extra data to the file in the future.
+  if (m_save_pipeline_predictions)
+    SavePipelinePredictions();
   m_gx_pipeline_uid_cache_file.Close();
 }
 
+static std::string GetPipelinePredictionsFilename()
+{
+  return File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidtransitions";
+}
+
+constexpr u32 PIPELINE_PREDICTIONS_FILE_MAGIC = 0x44525050;  // PPRD
+
+void ShaderCache::LoadPipelinePredictions()
+{
+  m_pipeline_predictor.Clear();
+
+  // The transitions refer to the pipelines by the hashes of their serialized UIDs, so the file
+  // is invalid whenever the UID cache is.
+  File::IOFile file(GetPipelinePredictionsFilename(), "rb");
+  u32 magic, version;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)) ||
+      magic != PIPELINE_PREDICTIONS_FILE_MAGIC || version != GX_PIPELINE_UID_VERSION)
+  {
+    return;
+  }
+
+  size_t count = 0;
+  PipelinePredictor::Transition transition;
+  while (file.ReadArray(&transition.from, 1) && file.ReadArray(&transition.to, 1) &&
+         file.ReadArray(&transition.count, 1))
+  {
+    m_pipeline_predictor.AddTransition(transition);
+    count++;
+  }
+
+  INFO_LOG(VIDEO, "Read %u pipeline transitions", static_cast<unsigned>(count));
+}
+
+void ShaderCache::SavePipelinePredictions()
+{
+  File::IOFile file(GetPipelinePredictionsFilename(), "wb");
+  bool success = file.WriteArray(&PIPELINE_PREDICTIONS_FILE_MAGIC, 1) &&
+                 file.WriteArray(&GX_PIPELINE_UID_VERSION, 1);
+  for (const PipelinePredictor::Transition& transition : m_pipeline_predictor.GetTransitions())
+  {
+    success = success && file.WriteArray(&transition.from, 1) &&
+              file.WriteArray(&transition.to, 1) && file.WriteArray(&transition.count, 1);
+  }
+
+  if (!success)
+    WARN_LOG(VIDEO, "Writing pipeline transitions to cache failed.");
+}
+
 void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
 {
   GXPipelineUid real_uid = {};
@@ -640,20 +727,12 @@ void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
   real_uid.depth_state.hex = uid.depth_state_bits;
   real_uid.blending_state.hex = uid.blending_state_bits;
 
-  auto iter = m_gx_pipeline_cache.find(real_uid);
-  if (iter != m_gx_pipeline_cache.end())
-    return;
-
-  // Flag it as empty with a null pipeline object, for later compilation.
-  auto& entry = m_gx_pipeline_cache[real_uid];
-  entry.second = false;
+  // Add it with a null pipeline object, for later compilation.
+  GetGXPipelineEntry(real_uid);
 }
 
-void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
+static SerializedGXPipelineUid SerializeGXPipelineUID(const GXPipelineUid& config)
 {
-  if (!m_gx_pipeline_uid_cache_file.IsOpen())
-    return;
-
   // Convert to disk format. Ensure all padding bytes are zero.
   SerializedGXPipelineUid disk_uid;
   std::memset(&disk_uid, 0, sizeof(disk_uid));
@@ -664,6 +743,15 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   disk_uid.rasterization_state_bits = config.rasterization_state.hex;
   disk_uid.depth_state_bits = config.depth_state.hex;
   disk_uid.blending_state_bits = config.blending_state.hex;
+  return disk_uid;
+}
+
+void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
+{
+  if (!m_gx_pipeline_uid_cache_file.IsOpen())
+    return;
+
+  const SerializedGXPipelineUid disk_uid = SerializeGXPipelineUID(config);
   if (!m_gx_pipeline_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
   {
     WARN_LOG(VIDEO, "Writing pipeline UID to cache failed, closing file.");
@@ -671,6 +759,59 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   }
 }
 
+ShaderCache::GXPipelineCache::iterator ShaderCache::GetGXPipelineEntry(const GXPipelineUid& uid)
+{
+  auto iter = m_gx_pipeline_cache.find(uid);
+  if (iter != m_gx_pipeline_cache.end())
+    return iter;
+
+  // Unlike the UID, which points to the vertex format, the serialized UID stays the same across
+  // runs, and so does its hash.
+  const SerializedGXPipelineUid serialized_uid = SerializeGXPipelineUID(uid);
+  iter = m_gx_pipeline_cache.emplace(uid, GXPipelineEntry()).first;
+  iter->second.hash = XXH64(&serialized_uid, sizeof(serialized_uid), 0);
+  m_gx_pipelines_by_hash.emplace(iter->second.hash, iter);
+  return iter;
+}
+
+void ShaderCache::PredictNextPipelines(const GXPipelineEntry& entry)
+{
+  // Most draws use the same pipeline as the one before, only the changes tell something.
+  if (!m_pipeline_predictor.Observe(entry.hash))
+    return;
+
+  m_pipeline_predictor.ForEachPrediction(entry.hash, [this](u64 hash) {
+    auto iter = m_gx_pipelines_by_hash.find(hash);
+    if (iter != m_gx_pipelines_by_hash.end())
+      PromotePipelineCompile(iter->second, COMPILE_PRIORITY_PREDICTED_PIPELINE);
+  });
+}
+
+template <typename Uid>
+void ShaderCache::PromoteShaderCompile(const ShaderModuleCache<Uid>& cache, const Uid& uid,
+                                       u32 priority)
+{
+  auto iter = cache.shader_map.find(uid);
+  if (iter != cache.shader_map.end() && iter->second.pending)
+    m_async_shader_compiler->PromoteWorkItem(iter->second.work_item, priority);
+}
+
+void ShaderCache::PromotePipelineCompile(GXPipelineCache::iterator iter, u32 priority)
+{
+  GXPipelineEntry& entry = iter->second;
+  if (!entry.pending || entry.priority <= priority)
+    return;
+
+  entry.priority = priority;
+  m_async_shader_compiler->PromoteWorkItem(entry.work_item, priority);
+
+  // The pipeline can't be compiled before its shaders, which were queued at the old priority.
+  PromoteShaderCompile(m_vs_cache, iter->first.vs_uid, priority);
+  PixelShaderUid ps_uid = iter->first.ps_uid;
+  ClearUnusedPixelShaderUidBits(m_api_type, m_host_config, &ps_uid);
+  PromoteShaderCompile(m_ps_cache, ps_uid, priority);
+}
+
 void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority)
 {
   class VertexShaderWorkItem final : public AsyncShaderCompiler::WorkItem
@@ -695,9 +836,10 @@ void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 prior
     VertexShaderUid uid;
   };
 
-  m_vs_cache.shader_map[uid].pending = true;
+  auto& entry = m_vs_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<VertexShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid& uid, u32 priority)
@@ -724,9 +866,10 @@ void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid
     UberShader::VertexShaderUid uid;
   };
 
-  m_uber_vs_cache.shader_map[uid].pending = true;
+  auto& entry = m_uber_vs_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<VertexUberShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priority)
@@ -753,9 +896,10 @@ void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priorit
     PixelShaderUid uid;
   };
 
-  m_ps_cache.shader_map[uid].pending = true;
+  auto& entry = m_ps_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<PixelShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid& uid, u32 priority)
@@ -782,9 +926,10 @@ void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid&
     UberShader::PixelShaderUid uid;
   };
 
-  m_uber_ps_cache.shader_map[uid].pending = true;
+  auto& entry = m_uber_ps_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<PixelUberShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
@@ -836,10 +981,9 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
       }
       else
       {
-        // Re-queue for next frame.
-        auto wi = shader_cache->m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(
-            shader_cache, uid, priority);
-        shader_cache->m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+        // Re-queue for next frame, at the priority it may have been promoted to meanwhile.
+        shader_cache->QueuePipelineCompile(
+            uid, shader_cache->GetGXPipelineEntry(uid)->second.priority);
       }
     }
 
@@ -853,8 +997,10 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
   };
 
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
-  m_gx_pipeline_cache[uid].second = true;
+  GXPipelineEntry& entry = GetGXPipelineEntry(uid)->second;
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.priority = priority;
+  entry.pending = true;
 }
 
 void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority)
@@ -23,6 +23,7 @@
 #include "VideoCommon/AsyncShaderCompiler.h"
 #include "VideoCommon/GXPipelineTypes.h"
 #include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PipelinePredictor.h"
 #include "VideoCommon/PixelShaderGen.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/UberShaderPixel.h"
@@ -37,6 +38,20 @@ namespace VideoCommon
 class ShaderCache final
 {
 public:
+  // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
+  // The shader cache is compiled last, as it is the least likely to be required. On demand
+  // shaders are always compiled before pending ubershaders, as we want to use the ubershader
+  // for as few frames as possible, otherwise we risk framerate drops. Pipelines which are likely
+  // to be needed soon are moved ahead of the others. The other priorities age while waiting, but
+  // never past the predicted pipelines, so that they can't hold back on demand pipelines.
+  enum : u32
+  {
+    COMPILE_PRIORITY_ONDEMAND_PIPELINE = 100,
+    COMPILE_PRIORITY_PREDICTED_PIPELINE = 150,
+    COMPILE_PRIORITY_UBERSHADER_PIPELINE = 200,
+    COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
+  };
+
   ShaderCache();
   ~ShaderCache();
 
@@ -70,6 +85,8 @@ private:
   void ClearShaderCaches();
   void LoadPipelineUIDCache();
   void ClosePipelineUIDCache();
+  void LoadPipelinePredictions();
+  void SavePipelinePredictions();
   void CompileMissingPipelines();
   void InvalidateCachedPipelines();
   void ClearPipelineCaches();
@@ -108,6 +125,22 @@ private:
   void AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid);
   void AppendGXPipelineUID(const GXPipelineUid& config);
 
+  // GX pipeline prediction methods
+  struct GXPipelineEntry
+  {
+    std::unique_ptr<AbstractPipeline> pipeline;
+    bool pending = false;
+    // The work item that compiles the pipeline while it is pending, and its priority.
+    AsyncShaderCompiler::WorkItemId work_item = 0;
+    u32 priority = 0;
+    // Identifies the pipeline to the predictor, see GetGXPipelineEntry.
+    u64 hash = 0;
+  };
+  using GXPipelineCache = std::map<GXPipelineUid, GXPipelineEntry>;
+  GXPipelineCache::iterator GetGXPipelineEntry(const GXPipelineUid& uid);
+  void PredictNextPipelines(const GXPipelineEntry& entry);
+  void PromotePipelineCompile(GXPipelineCache::iterator iter, u32 priority);
+
   // ASync Compiler Methods
   void QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority);
   void QueueVertexUberShaderCompile(const UberShader::VertexShaderUid& uid, u32 priority);
@@ -116,17 +149,6 @@ private:
   void QueuePipelineCompile(const GXPipelineUid& uid, u32 priority);
   void QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority);
 
-  // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
-  // The shader cache is compiled last, as it is the least likely to be required. On demand
-  // shaders are always compiled before pending ubershaders, as we want to use the ubershader
-  // for as few frames as possible, otherwise we risk framerate drops.
-  enum : u32
-  {
-    COMPILE_PRIORITY_ONDEMAND_PIPELINE = 100,
-    COMPILE_PRIORITY_UBERSHADER_PIPELINE = 200,
-    COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
-  };
-
   // Configuration bits.
   APIType m_api_type = APIType::Nothing;
   ShaderHostConfig m_host_config = {};
@@ -142,21 +164,30 @@ private:
     {
       std::unique_ptr<AbstractShader> shader;
       bool pending;
+      AsyncShaderCompiler::WorkItemId work_item;
     };
     std::map<Uid, Shader> shader_map;
     LinearDiskCache<Uid, u8> disk_cache;
   };
+  template <typename Uid>
+  void PromoteShaderCompile(const ShaderModuleCache<Uid>& cache, const Uid& uid, u32 priority);
+
   ShaderModuleCache<VertexShaderUid> m_vs_cache;
   ShaderModuleCache<GeometryShaderUid> m_gs_cache;
   ShaderModuleCache<PixelShaderUid> m_ps_cache;
   ShaderModuleCache<UberShader::VertexShaderUid> m_uber_vs_cache;
   ShaderModuleCache<UberShader::PixelShaderUid> m_uber_ps_cache;
 
-  // GX Pipeline Caches - .first - pipeline, .second - pending
-  std::map<GXPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>> m_gx_pipeline_cache;
+  // GX Pipeline Caches
+  GXPipelineCache m_gx_pipeline_cache;
+  std::unordered_map<u64, GXPipelineCache::iterator> m_gx_pipelines_by_hash;
+  // .first - pipeline, .second - pending
   std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
       m_gx_uber_pipeline_cache;
   File::IOFile m_gx_pipeline_uid_cache_file;
+
+  PipelinePredictor m_pipeline_predictor;
+  bool m_save_pipeline_predictions = false;
 };
 
 }  // namespace VideoCommon
@@ -3,10 +3,34 @@
 // Refer to the license.txt file included.
 
 #include "VideoCommon/ShaderGenCommon.h"
+
+#include <cstdarg>
+#include <cstring>
+
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
 #include "Core/ConfigManager.h"
 
+void ShaderCode::WriteV(const char* fmt, va_list args)
+{
+  // Many lines of shader code don't have any parameters.
+  if (!std::strchr(fmt, '%'))
+  {
+    m_buffer.append(fmt);
+    return;
+  }
+
+  // Lines are short enough to be formatted on the stack. Longer blocks fall back to allocating.
+  char line[1024];
+  va_list args_copy;
+  va_copy(args_copy, args);
+  if (CharArrayFromFormatV(line, sizeof(line), fmt, args_copy))
+    m_buffer.append(line);
+  else
+    m_buffer += StringFromFormatV(fmt, args);
+  va_end(args_copy);
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -119,10 +119,13 @@ public:
   {
     va_list arglist;
     va_start(arglist, fmt);
-    m_buffer += StringFromFormatV(fmt, arglist);
+    WriteV(fmt, arglist);
     va_end(arglist);
   }
 
+  // Formats straight into the buffer, without going through temporary strings.
+  void WriteV(const char* fmt, va_list args);
+
 protected:
   std::string m_buffer;
 };
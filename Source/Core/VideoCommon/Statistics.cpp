@@ -55,6 +55,7 @@ std::string Statistics::ToString()
   str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
   str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
   str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
+  str += StringFromFormat("Draws merged: %i\n", stats.thisFrame.numDrawsMerged);
   str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
   str += StringFromFormat("Primitives (DL): %i\n", stats.thisFrame.numDLPrims);
   str += StringFromFormat("XF loads: %i\n", stats.thisFrame.numXFLoads);
@@ -66,6 +67,15 @@ std::string Statistics::ToString()
   str += StringFromFormat("Vertex streamed: %i kB\n", stats.thisFrame.bytesVertexStreamed / 1024);
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
+  str += StringFromFormat("Uniform skipped: %i kB\n", stats.thisFrame.bytesUniformSkipped / 1024);
+  str += StringFromFormat("FIFO read: %i kB\n", stats.thisFrame.bytesFifoRead / 1024);
+  str += StringFromFormat("FIFO moved: %i kB\n", stats.thisFrame.bytesFifoMoved / 1024);
+  str += StringFromFormat("EFB peek stalls: %i\n", stats.thisFrame.numEFBPeekStalls);
+  str += StringFromFormat("EFB peek tiles read: %i\n", stats.thisFrame.numEFBPeekTilesRead);
+  str += StringFromFormat("BBox readbacks: %i\n", stats.thisFrame.numBBoxReadbacks);
+  str += StringFromFormat("Descriptor sets allocated: %i\n",
+                          stats.thisFrame.numDescriptorSetsAllocated);
+  str += StringFromFormat("Descriptor sets reused: %i\n", stats.thisFrame.numDescriptorSetsReused);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
@@ -44,12 +44,27 @@ struct Statistics
 
     int numPrimitiveJoins;
     int numDrawCalls;
+    int numDrawsMerged;
 
     int numDListsCalled;
 
     int bytesVertexStreamed;
     int bytesIndexStreamed;
     int bytesUniformStreamed;
+    int bytesUniformSkipped;
+
+    // Copies of GPU commands from the FIFO in RAM into the video buffer, and moves of commands
+    // that haven't been run yet to the start of the video buffer when it wraps around.
+    int bytesFifoRead;
+    int bytesFifoMoved;
+
+    int numEFBPeekStalls;
+    int numEFBPeekTilesRead;
+
+    int numBBoxReadbacks;
+
+    int numDescriptorSetsAllocated;
+    int numDescriptorSetsReused;
 
     int numTrianglesClipped;
     int numTrianglesIn;
@@ -7,6 +7,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #if defined(_M_X86) || defined(_M_X86_64)
@@ -21,6 +22,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
+#include "Common/PerfMetrics.h"
 #include "Common/StringUtil.h"
 
 #include "Core/ConfigManager.h"
@@ -48,6 +50,10 @@ static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
+static PerfMetrics::Histogram s_texture_load_time("texturecache.load_us",
+                                                  PerfMetrics::FRAME_EVENT_TEXTURE_LOAD);
+static PerfMetrics::Counter s_efb_copies("texturecache.efb_copies");
+
 std::bitset<8> TextureCacheBase::valid_bind_points;
 
 TextureCacheBase::TCacheEntry::TCacheEntry(std::unique_ptr<AbstractTexture> tex)
@@ -102,6 +108,7 @@ void TextureCacheBase::Invalidate()
     delete tex.second;
   }
   textures_by_address.clear();
+  textures_by_range.Clear();
   textures_by_hash.clear();
 
   texture_pool.clear();
@@ -258,7 +265,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTForma
   decoded_entry->may_have_overlapping_textures = entry->may_have_overlapping_textures;
 
   ConvertTexture(decoded_entry, entry, palette, tlutfmt);
-  textures_by_address.emplace(entry->addr, decoded_entry);
+  AddToAddressCache(decoded_entry);
 
   return decoded_entry;
 }
@@ -328,10 +335,10 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
 
   u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
         entry->references.count(entry_to_update) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
@@ -353,7 +360,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -439,11 +445,10 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
+        InvalidateTexture(iter);
         continue;
       }
     }
-    ++iter.first;
   }
   return entry_to_update;
 }
@@ -957,6 +962,9 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                        g_texture_cache->SupportsGPUTextureDecode(texformat, tlutfmt) &&
                        !(from_tmem && texformat == TextureFormat::RGBA8);
 
+  // Everything from here on is only done for textures which aren't in the cache yet.
+  PerfMetrics::ScopedTimer load_timer(s_texture_load_time);
+
   // create the entry/texture
   TextureConfig config;
   config.width = width;
@@ -1034,14 +1042,14 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     }
   }
 
-  iter = textures_by_address.emplace(address, entry);
+  entry->SetGeneralParameters(address, texture_size, full_format, false);
+  iter = AddToAddressCache(entry);
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
   {
     entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
   }
 
-  entry->SetGeneralParameters(address, texture_size, full_format, false);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
   entry->SetHashes(base_hash, full_hash);
   entry->is_custom_tex = hires_tex != nullptr;
@@ -1315,10 +1323,10 @@ bool TextureCacheBase::LoadTextureFromOverlappingTextures(TCacheEntry* entry_to_
   // instead, which would reduce the amount of copying work here.
   std::vector<TCacheEntry*> candidates;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
         entry->references.count(entry_to_update) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
@@ -1331,11 +1339,10 @@ bool TextureCacheBase::LoadTextureFromOverlappingTextures(TCacheEntry* entry_to_
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
+        InvalidateTexture(iter);
         continue;
       }
     }
-    ++iter.first;
   }
 
   std::sort(candidates.begin(), candidates.end(),
@@ -1463,7 +1470,8 @@ TextureCacheBase::CreateNormalTexture(const TextureLookupInformation& tex_info)
   if (!entry)
     return nullptr;
 
-  textures_by_address.emplace(tex_info.address, entry);
+  entry->SetGeneralParameters(tex_info.address, tex_info.total_bytes, tex_info.full_format, false);
+  AddToAddressCache(entry);
   if (tex_info.texture_cache_safety_color_sample_size == 0 ||
       std::max(tex_info.total_bytes, tex_info.palette_size) <=
           (u32)tex_info.texture_cache_safety_color_sample_size * 8)
@@ -1471,7 +1479,6 @@ TextureCacheBase::CreateNormalTexture(const TextureLookupInformation& tex_info)
     entry->textures_by_hash_iter = textures_by_hash.emplace(tex_info.full_hash, entry);
   }
 
-  entry->SetGeneralParameters(tex_info.address, tex_info.total_bytes, tex_info.full_format, false);
   entry->SetDimensions(tex_info.native_width, tex_info.native_height, tex_info.computed_levels);
   entry->SetHashes(tex_info.base_hash, tex_info.full_hash);
   entry->is_custom_tex = false;
@@ -1580,6 +1587,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
     const EFBRectangle& srcRect, bool isIntensity, bool scaleByHalf, float y_scale, float gamma,
     bool clamp_top, bool clamp_bottom, const CopyFilterCoefficients::Values& filter_coefficients)
 {
+  s_efb_copies.Add();
+
   // Emulation methods:
   //
   // - EFB to RAM:
@@ -1727,10 +1736,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // as our efb copy are marked to check them for partial texture updates.
   // TODO: The logic to detect overlapping strided efb copies is not 100% accurate.
   bool strided_efb_copy = dstStride != bytes_per_row;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter : FindOverlappingTextures(dstAddr, covered_range))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
 
     if (entry->addr == dstAddr && entry->is_xfb_copy)
     {
@@ -1750,7 +1758,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       {
         // Pending EFB copies which are completely covered by this new copy can simply be tossed,
         // instead of having to flush them later on, since this copy will write over everything.
-        iter.first = InvalidateTexture(iter.first, true);
+        InvalidateTexture(iter, true);
         continue;
       }
       entry->may_have_overlapping_textures = true;
@@ -1776,7 +1784,6 @@ void TextureCacheBase::CopyRenderTargetToTexture(
         entry->textures_by_hash_iter = textures_by_hash.end();
       }
     }
-    ++iter.first;
   }
 
   TCacheEntry* entry = nullptr;
@@ -1829,7 +1836,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
                              0);
       }
 
-      textures_by_address.emplace(dstAddr, entry);
+      AddToAddressCache(entry);
     }
   }
 
@@ -2071,21 +2078,28 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::AddToAddressCache(TCacheEntry* entry)
+{
+  auto iter = textures_by_address.emplace(entry->addr, entry);
+  textures_by_range.Insert(entry->addr, entry->size_in_bytes, iter);
+  return iter;
+}
+
+const std::vector<TextureCacheBase::TexAddrCache::iterator>&
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
-
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = textures_by_address.lower_bound(lower_addr);
-  auto end = textures_by_address.upper_bound(addr + size_in_bytes);
-
-  return std::make_pair(begin, end);
+  overlapping_textures.clear();
+  textures_by_range.ForEachOverlapping(
+      addr, size_in_bytes,
+      [this](TexAddrCache::iterator iter) { overlapping_textures.push_back(iter); });
+
+  // Partial texture updates have to be applied in the same order regardless of how the textures
+  // are indexed, so use the order of textures_by_address.
+  std::sort(overlapping_textures.begin(), overlapping_textures.end(),
+            [](TexAddrCache::iterator a, TexAddrCache::iterator b) {
+              return std::tie(a->first, a->second->id) < std::tie(b->first, b->second->id);
+            });
+  return overlapping_textures;
 }
 
 TextureCacheBase::TexAddrCache::iterator
@@ -2137,6 +2151,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
     else
     {
       entry->pending_efb_copy_invalidated = true;
+      textures_by_range.Remove(entry->addr, entry->size_in_bytes, iter);
       return textures_by_address.erase(iter);
     }
   }
@@ -2144,6 +2159,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   auto config = entry->texture->GetConfig();
   texture_pool.emplace(config, TexPoolEntry(std::move(entry->texture)));
 
+  textures_by_range.Remove(entry->addr, entry->size_in_bytes, iter);
   return textures_by_address.erase(iter);
 }
 
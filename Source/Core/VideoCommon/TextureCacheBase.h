@@ -17,6 +17,7 @@
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/AbstractTexture.h"
+#include "VideoCommon/AddressRangeIndex.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -331,10 +332,12 @@ private:
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Adds an entry to the address cache, once its address and size have been set.
+  TexAddrCache::iterator AddToAddressCache(TCacheEntry* entry);
+
+  // Returns all textures overlapping the range, ordered by address and age. The returned list is
+  // only valid until the next call.
+  const std::vector<TexAddrCache::iterator>& FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
   virtual void CopyEFBToCacheEntry(TCacheEntry* entry, bool is_depth_copy,
                                    const EFBRectangle& src_rect, bool scale_by_half,
@@ -366,6 +369,9 @@ private:
   void ReleaseEFBCopyStagingTexture(std::unique_ptr<AbstractStagingTexture> tex);
 
   TexAddrCache textures_by_address;
+  // Indexes the entries of textures_by_address by the memory they cover.
+  AddressRangeIndex<TexAddrCache::iterator> textures_by_range;
+  std::vector<TexAddrCache::iterator> overlapping_textures;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
   u64 last_entry_id = 0;
@@ -16,6 +16,7 @@
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
@@ -262,6 +263,9 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  // Some BP writes are held back until the next primitive, see BPWritten.
+  ResolveDeferredBPWrites();
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
@@ -314,34 +318,52 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
       VertexShaderManager::SetTexMatrixChangedB(value);
     break;
 
+  // The vertex loaders only need to be looked up again if the vertex format actually changes,
+  // which most rewrites of these registers don't do.
   case 0x50:
-    state->vtx_desc.Hex &= ~0x1FFFF;  // keep the Upper bits
-    state->vtx_desc.Hex |= value;
+  {
+    // keep the Upper bits
+    const u64 vtx_desc = (state->vtx_desc.Hex & ~0x1FFFF) | value;
+    if (vtx_desc == state->vtx_desc.Hex)
+      break;
+    state->vtx_desc.Hex = vtx_desc;
     state->attr_dirty = BitSet32::AllTrue(8);
     state->bases_dirty = true;
     break;
+  }
 
   case 0x60:
-    state->vtx_desc.Hex &= 0x1FFFF;  // keep the lower 17Bits
-    state->vtx_desc.Hex |= (u64)value << 17;
+  {
+    // keep the lower 17Bits
+    const u64 vtx_desc = (state->vtx_desc.Hex & 0x1FFFF) | (u64)value << 17;
+    if (vtx_desc == state->vtx_desc.Hex)
+      break;
+    state->vtx_desc.Hex = vtx_desc;
     state->attr_dirty = BitSet32::AllTrue(8);
     state->bases_dirty = true;
     break;
+  }
 
   case 0x70:
     ASSERT((sub_cmd & 0x0F) < 8);
+    if (state->vtx_attr[sub_cmd & 7].g0.Hex == value)
+      break;
     state->vtx_attr[sub_cmd & 7].g0.Hex = value;
     state->attr_dirty[sub_cmd & 7] = true;
     break;
 
   case 0x80:
     ASSERT((sub_cmd & 0x0F) < 8);
+    if (state->vtx_attr[sub_cmd & 7].g1.Hex == value)
+      break;
     state->vtx_attr[sub_cmd & 7].g1.Hex = value;
     state->attr_dirty[sub_cmd & 7] = true;
     break;
 
   case 0x90:
     ASSERT((sub_cmd & 0x0F) < 8);
+    if (state->vtx_attr[sub_cmd & 7].g2.Hex == value)
+      break;
     state->vtx_attr[sub_cmd & 7].g2.Hex = value;
     state->attr_dirty[sub_cmd & 7] = true;
     break;
@@ -17,6 +17,8 @@
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/GeometryShaderManager.h"
@@ -106,7 +108,7 @@ DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count,
 
     // Have to update the rasterization state for point/line cull modes.
     m_current_primitive_type = new_primitive_type;
-    SetRasterizationStateChanged();
+    SetPipelineStateDirty(DIRTY_GEOMETRY_SHADER | DIRTY_RASTERIZATION_STATE);
   }
 
   // Check for size in buffer, if the buffer gets full, call Flush()
@@ -408,11 +410,15 @@ void VertexManagerBase::Flush()
 
   m_is_flushed = true;
   m_cull_all = false;
+
+  ApplyDeferredBPWrites();
 }
 
 void VertexManagerBase::DoState(PointerWrap& p)
 {
   p.Do(m_zslope);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    m_pipeline_state_dirty = DIRTY_ALL;
   g_vertex_manager->vDoState(p);
 }
 
@@ -491,34 +497,60 @@ void VertexManagerBase::UpdatePipelineConfig()
     m_pipeline_config_changed = true;
   }
 
-  VertexShaderUid vs_uid = GetVertexShaderUid();
-  if (vs_uid != m_current_pipeline_config.vs_uid)
+  if (VertexLoaderManager::g_current_components != m_current_components)
   {
-    m_current_pipeline_config.vs_uid = vs_uid;
-    m_current_uber_pipeline_config.vs_uid = UberShader::GetVertexShaderUid();
-    m_pipeline_config_changed = true;
+    m_current_components = VertexLoaderManager::g_current_components;
+    m_pipeline_state_dirty |= DIRTY_VERTEX_SHADER | DIRTY_PIXEL_SHADER;
   }
 
-  PixelShaderUid ps_uid = GetPixelShaderUid();
-  if (ps_uid != m_current_pipeline_config.ps_uid)
+  // Bounding box tracking can also be disabled from the CPU thread, by reading the registers.
+  if (BoundingBox::active != m_current_bbox_active)
   {
-    m_current_pipeline_config.ps_uid = ps_uid;
-    m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
-    m_pipeline_config_changed = true;
+    m_current_bbox_active = BoundingBox::active;
+    m_pipeline_state_dirty |= DIRTY_PIXEL_SHADER;
   }
 
-  GeometryShaderUid gs_uid = GetGeometryShaderUid(GetCurrentPrimitiveType());
-  if (gs_uid != m_current_pipeline_config.gs_uid)
+  // Only regenerate the parts of the configuration whose inputs have been written to.
+  const u32 dirty = m_pipeline_state_dirty;
+  m_pipeline_state_dirty = 0;
+  if (!dirty)
+    return;
+
+  if (dirty & DIRTY_VERTEX_SHADER)
   {
-    m_current_pipeline_config.gs_uid = gs_uid;
-    m_current_uber_pipeline_config.gs_uid = gs_uid;
-    m_pipeline_config_changed = true;
+    VertexShaderUid vs_uid = GetVertexShaderUid();
+    if (vs_uid != m_current_pipeline_config.vs_uid)
+    {
+      m_current_pipeline_config.vs_uid = vs_uid;
+      m_current_uber_pipeline_config.vs_uid = UberShader::GetVertexShaderUid();
+      m_pipeline_config_changed = true;
+    }
+  }
+
+  if (dirty & DIRTY_PIXEL_SHADER)
+  {
+    PixelShaderUid ps_uid = GetPixelShaderUid();
+    if (ps_uid != m_current_pipeline_config.ps_uid)
+    {
+      m_current_pipeline_config.ps_uid = ps_uid;
+      m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
+      m_pipeline_config_changed = true;
+    }
   }
 
-  if (m_rasterization_state_changed)
+  if (dirty & DIRTY_GEOMETRY_SHADER)
   {
-    m_rasterization_state_changed = false;
+    GeometryShaderUid gs_uid = GetGeometryShaderUid(GetCurrentPrimitiveType());
+    if (gs_uid != m_current_pipeline_config.gs_uid)
+    {
+      m_current_pipeline_config.gs_uid = gs_uid;
+      m_current_uber_pipeline_config.gs_uid = gs_uid;
+      m_pipeline_config_changed = true;
+    }
+  }
 
+  if (dirty & DIRTY_RASTERIZATION_STATE)
+  {
     RasterizationState new_rs = {};
     new_rs.Generate(bpmem, m_current_primitive_type);
     if (new_rs != m_current_pipeline_config.rasterization_state)
@@ -529,10 +561,8 @@ void VertexManagerBase::UpdatePipelineConfig()
     }
   }
 
-  if (m_depth_state_changed)
+  if (dirty & DIRTY_DEPTH_STATE)
   {
-    m_depth_state_changed = false;
-
     DepthState new_ds = {};
     new_ds.Generate(bpmem);
     if (new_ds != m_current_pipeline_config.depth_state)
@@ -543,10 +573,8 @@ void VertexManagerBase::UpdatePipelineConfig()
     }
   }
 
-  if (m_blending_state_changed)
+  if (dirty & DIRTY_BLENDING_STATE)
   {
-    m_blending_state_changed = false;
-
     BlendingState new_bs = {};
     new_bs.Generate(bpmem);
     if (new_bs != m_current_pipeline_config.blending_state)
@@ -51,6 +51,7 @@ public:
   void FlushData(u32 count, u32 stride);
 
   void Flush();
+  bool IsFlushed() const { return m_is_flushed; }
 
   virtual std::unique_ptr<NativeVertexFormat>
   CreateNativeVertexFormat(const PortableVertexDeclaration& vtx_decl) = 0;
@@ -59,14 +60,29 @@ public:
 
   std::pair<size_t, size_t> ResetFlushAspectRatioCount();
 
+  // Parts of the pipeline configuration which have to be regenerated before the next draw.
+  enum PipelineStateDirtyBits : u32
+  {
+    DIRTY_VERTEX_SHADER = 1 << 0,
+    DIRTY_PIXEL_SHADER = 1 << 1,
+    DIRTY_GEOMETRY_SHADER = 1 << 2,
+    DIRTY_RASTERIZATION_STATE = 1 << 3,
+    DIRTY_DEPTH_STATE = 1 << 4,
+    DIRTY_BLENDING_STATE = 1 << 5,
+    DIRTY_ALL = (1 << 6) - 1
+  };
+
   // State setters, called from register update functions.
-  void SetRasterizationStateChanged() { m_rasterization_state_changed = true; }
-  void SetDepthStateChanged() { m_depth_state_changed = true; }
-  void SetBlendingStateChanged() { m_blending_state_changed = true; }
+  void SetPipelineStateDirty(u32 bits) { m_pipeline_state_dirty |= bits; }
+  void SetRasterizationStateChanged() { SetPipelineStateDirty(DIRTY_RASTERIZATION_STATE); }
+  void SetDepthStateChanged() { SetPipelineStateDirty(DIRTY_DEPTH_STATE); }
+  void SetBlendingStateChanged() { SetPipelineStateDirty(DIRTY_BLENDING_STATE); }
   void InvalidatePipelineObject()
   {
     m_current_pipeline_object = nullptr;
     m_pipeline_config_changed = true;
+    // The shader uids also depend on the video config, which may have changed.
+    m_pipeline_state_dirty = DIRTY_ALL;
   }
 
 protected:
@@ -88,9 +104,10 @@ protected:
   const AbstractPipeline* m_current_pipeline_object = nullptr;
   PrimitiveType m_current_primitive_type = PrimitiveType::Points;
   bool m_pipeline_config_changed = true;
-  bool m_rasterization_state_changed = true;
-  bool m_depth_state_changed = true;
-  bool m_blending_state_changed = true;
+  u32 m_pipeline_state_dirty = DIRTY_ALL;
+  // Shader uid inputs which don't come from the register files, and are compared instead.
+  u32 m_current_components = 0;
+  bool m_current_bbox_active = false;
   bool m_cull_all = false;
 
 private:
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "Common/Atomic.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
@@ -167,17 +168,28 @@ u16 VideoBackendBase::Video_GetBoundingBox(int index)
     return 0;
   }
 
+  if (m_bbox_cache_valid &&
+      m_bbox_cache_fifo_write_count == CommandProcessor::GetFifoWriteCount())
+  {
+    return m_bbox_cache[index];
+  }
+
   Fifo::SyncGPU(Fifo::SyncGPUReason::BBox);
 
+  // The values can only be reused if the GPU had already run all of the commands that were sent.
+  // Otherwise, like in dual core mode when the GPU thread is behind, it may still change them
+  // without any further writes to the FIFO.
+  const bool gpu_idle = Common::AtomicLoad(CommandProcessor::fifo.CPReadWriteDistance) == 0;
+
   AsyncRequests::Event e;
-  u16 result;
   e.time = 0;
   e.type = AsyncRequests::Event::BBOX_READ;
-  e.bbox.index = index;
-  e.bbox.data = &result;
+  e.bbox.data = m_bbox_cache.data();
   AsyncRequests::GetInstance()->PushEvent(e, true);
+  m_bbox_cache_fifo_write_count = CommandProcessor::GetFifoWriteCount();
+  m_bbox_cache_valid = gpu_idle;
 
-  return result;
+  return m_bbox_cache[index];
 }
 
 void VideoBackendBase::PopulateList()
@@ -258,6 +270,7 @@ void VideoBackendBase::DoState(PointerWrap& p)
   if (p.GetMode() == PointerWrap::MODE_READ)
   {
     m_invalid = true;
+    m_bbox_cache_valid = false;
 
     // Clear all caches that touch RAM
     // (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
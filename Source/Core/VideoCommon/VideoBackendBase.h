@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -71,6 +72,13 @@ protected:
 
   bool m_initialized = false;
   bool m_invalid = false;
+
+private:
+  // Games usually read all of the bounding box registers in a row. They are read back from the
+  // GPU together, and reused until the CPU sends more commands.
+  std::array<u16, 4> m_bbox_cache{};
+  u64 m_bbox_cache_fifo_write_count = 0;
+  bool m_bbox_cache_valid = false;
 };
 
 extern std::vector<std::unique_ptr<VideoBackendBase>> g_available_video_backends;
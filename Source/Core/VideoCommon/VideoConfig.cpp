@@ -134,6 +134,7 @@ void VideoConfig::Refresh()
   iStereoDepthPercentage = Config::Get(Config::GFX_STEREO_DEPTH_PERCENTAGE);
 
   bEFBAccessEnable = Config::Get(Config::GFX_HACK_EFB_ACCESS_ENABLE);
+  bEFBPeekPrefetch = Config::Get(Config::GFX_HACK_EFB_PEEK_PREFETCH);
   bBBoxEnable = Config::Get(Config::GFX_HACK_BBOX_ENABLE);
   bBBoxPreferStencilImplementation =
       Config::Get(Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION);
@@ -111,6 +111,7 @@ struct VideoConfig final
 
   // Hacks
   bool bEFBAccessEnable;
+  bool bEFBPeekPrefetch;
   bool bPerfQueriesEnable;
   bool bBBoxEnable;
   bool bBBoxPreferStencilImplementation;  // OpenGL-only, to see how slow it is compared to SSBOs
@@ -6,6 +6,7 @@
 
 #include "Common/ChunkFile.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
@@ -23,6 +24,7 @@ void VideoCommon_DoState(PointerWrap& p)
 {
   // BP Memory
   p.Do(bpmem);
+  DoDeferredBPState(p);
   p.DoMarker("BP Memory");
 
   // CP Memory
@@ -23,16 +23,75 @@ static void XFMemWritten(u32 transferSize, u32 baseAddress)
   VertexShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
 }
 
-static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
+constexpr u32 XF_REGISTER_COUNT = 0x1058 - XFMEM_ERROR;
+
+// Parts of the pipeline configuration which are generated from an XF register.
+static constexpr u32 GetXFRegisterPipelineState(u32 address)
+{
+  switch (address)
+  {
+  case XFMEM_SETNUMCHAN:
+  case XFMEM_SETCHAN0_COLOR:
+  case XFMEM_SETCHAN1_COLOR:
+  case XFMEM_SETCHAN0_ALPHA:
+  case XFMEM_SETCHAN1_ALPHA:
+  case XFMEM_DUALTEX:
+    return VertexManagerBase::DIRTY_VERTEX_SHADER | VertexManagerBase::DIRTY_PIXEL_SHADER;
+
+  case XFMEM_SETNUMTEXGENS:
+    return VertexManagerBase::DIRTY_VERTEX_SHADER | VertexManagerBase::DIRTY_PIXEL_SHADER |
+           VertexManagerBase::DIRTY_GEOMETRY_SHADER;
+
+  default:
+    if (address >= XFMEM_SETTEXMTXINFO && address < XFMEM_SETPOSMTXINFO + 8)
+      return VertexManagerBase::DIRTY_VERTEX_SHADER | VertexManagerBase::DIRTY_PIXEL_SHADER;
+    return 0;
+  }
+}
+
+struct XFRegisterTable
+{
+  u32 pipeline_state[XF_REGISTER_COUNT];
+};
+
+static constexpr XFRegisterTable MakeXFRegisterTable()
+{
+  XFRegisterTable table = {};
+  for (u32 i = 0; i < XF_REGISTER_COUNT; ++i)
+    table.pipeline_state[i] = GetXFRegisterPipelineState(XFMEM_ERROR + i);
+  return table;
+}
+
+static constexpr XFRegisterTable s_xf_registers = MakeXFRegisterTable();
+
+// Returns the parts of the pipeline configuration that are generated from the changed registers.
+// They can only be marked as dirty once the registers have been written, as the flushes below
+// clear the dirty state.
+static u32 XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 {
   u32 address = baseAddress;
   u32 dataIndex = 0;
+  u32 pipeline_state = 0;
 
   while (transferSize > 0 && address < 0x1058)
   {
     u32 newValue = src.Peek<u32>(dataIndex * sizeof(u32));
     u32 nextAddress = address + 1;
 
+    // Games tend to resend whole blocks of registers, so skip the ones that don't change. The
+    // internal registers below 0x1007 are left to the switch, which skips them all at once, and
+    // the matrix indices are always handled, as they are shared with the CP registers.
+    if (address >= 0x1007 && newValue == ((u32*)&xfmem)[address] &&
+        address != XFMEM_SETMATRIXINDA && address != XFMEM_SETMATRIXINDB)
+    {
+      address = nextAddress;
+      transferSize--;
+      dataIndex++;
+      continue;
+    }
+
+    pipeline_state |= s_xf_registers.pipeline_state[address - XFMEM_ERROR];
+
     switch (address)
     {
     case XFMEM_ERROR:
@@ -200,6 +259,8 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     transferSize -= transferred;
     dataIndex += transferred;
   }
+
+  return pipeline_state;
 }
 
 void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
@@ -245,11 +306,12 @@ void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
   // write to XF regs
   if (transferSize > 0)
   {
-    XFRegWritten(transferSize, baseAddress, src);
+    const u32 pipeline_state = XFRegWritten(transferSize, baseAddress, src);
     for (u32 i = 0; i < transferSize; i++)
     {
       ((u32*)&xfmem)[baseAddress + i] = src.Read<u32>();
     }
+    g_vertex_manager->SetPipelineStateDirty(pipeline_state);
   }
 }
 
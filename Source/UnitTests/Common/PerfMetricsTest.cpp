@@ -0,0 +1,141 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/FileUtil.h"
+#include "Common/PerfMetrics.h"
+#include "Common/StringUtil.h"
+
+namespace
+{
+std::vector<std::string> ReadLines(const std::string& path)
+{
+  std::string contents;
+  File::ReadFileToString(path, contents);
+
+  std::vector<std::string> lines;
+  std::istringstream stream(contents);
+  std::string line;
+  while (std::getline(stream, line))
+    lines.push_back(line);
+  return lines;
+}
+
+size_t FindColumn(const std::vector<std::string>& header, const std::string& name)
+{
+  return std::find(header.begin(), header.end(), name) - header.begin();
+}
+}  // Anonymous namespace
+
+TEST(PerfMetrics, HistogramBuckets)
+{
+  EXPECT_EQ(0u, PerfMetrics::Histogram::GetBucket(0));
+  EXPECT_EQ(1u, PerfMetrics::Histogram::GetBucket(1));
+  EXPECT_EQ(2u, PerfMetrics::Histogram::GetBucket(2));
+  EXPECT_EQ(2u, PerfMetrics::Histogram::GetBucket(3));
+  EXPECT_EQ(3u, PerfMetrics::Histogram::GetBucket(4));
+  EXPECT_EQ(11u, PerfMetrics::Histogram::GetBucket(1500));
+  EXPECT_EQ(PerfMetrics::Histogram::NUM_BUCKETS - 1,
+            PerfMetrics::Histogram::GetBucket(UINT64_MAX));
+
+  PerfMetrics::Histogram histogram("test.histogram_buckets");
+  histogram.Record(3);
+  histogram.Record(1500);
+  histogram.Record(1000);
+
+  const PerfMetrics::Histogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(3u, snapshot.count);
+  EXPECT_EQ(2503u, snapshot.total);
+  EXPECT_EQ(1u, snapshot.buckets[2]);
+  EXPECT_EQ(2u, snapshot.buckets[10] + snapshot.buckets[11]);
+  EXPECT_EQ(2048u, snapshot.GetMaxBound());
+}
+
+TEST(PerfMetrics, ExportsChangesPerFrameAsCSV)
+{
+  const std::string dir = File::CreateTempDir();
+  const std::string path = dir + "/metrics.csv";
+
+  PerfMetrics::Counter counter("test.counter");
+  PerfMetrics::Histogram histogram("test.histogram");
+  counter.Add(100);
+  histogram.Record(7);
+
+  ASSERT_TRUE(PerfMetrics::StartExport(PerfMetrics::ExportFormat::CSV, path));
+  EXPECT_TRUE(PerfMetrics::IsExporting());
+
+  counter.Add(5);
+  histogram.Record(10);
+  histogram.Record(20);
+  PerfMetrics::SampleFrame();
+  PerfMetrics::SampleFrame();
+  counter.Add();
+  PerfMetrics::SampleFrame();
+
+  PerfMetrics::StopExport();
+  EXPECT_FALSE(PerfMetrics::IsExporting());
+  // Not exported anymore.
+  PerfMetrics::SampleFrame();
+
+  const std::vector<std::string> lines = ReadLines(path);
+  ASSERT_EQ(4u, lines.size());
+
+  const std::vector<std::string> header = SplitString(lines[0], ',');
+  const size_t counter_column = FindColumn(header, "test.counter");
+  const size_t count_column = FindColumn(header, "test.histogram.count");
+  const size_t total_column = FindColumn(header, "test.histogram.total_us");
+  const size_t max_column = FindColumn(header, "test.histogram.max_us");
+  ASSERT_LT(max_column, header.size());
+  EXPECT_EQ("frame", header[0]);
+
+  const std::vector<std::string> first = SplitString(lines[1], ',');
+  ASSERT_EQ(header.size(), first.size());
+  EXPECT_EQ("1", first[0]);
+  EXPECT_EQ("5", first[counter_column]);
+  EXPECT_EQ("2", first[count_column]);
+  EXPECT_EQ("30", first[total_column]);
+  EXPECT_EQ("32", first[max_column]);
+
+  const std::vector<std::string> second = SplitString(lines[2], ',');
+  EXPECT_EQ("0", second[counter_column]);
+  EXPECT_EQ("0", second[count_column]);
+  EXPECT_EQ("0", second[max_column]);
+
+  const std::vector<std::string> third = SplitString(lines[3], ',');
+  EXPECT_EQ("3", third[0]);
+  EXPECT_EQ("1", third[counter_column]);
+
+  File::DeleteDirRecursively(dir);
+}
+
+TEST(PerfMetrics, ExportsJSONLines)
+{
+  const std::string dir = File::CreateTempDir();
+  const std::string path = dir + "/metrics.json";
+
+  PerfMetrics::Counter counter("test.json_counter");
+  PerfMetrics::Histogram histogram("test.json_histogram");
+
+  ASSERT_TRUE(PerfMetrics::StartExport(PerfMetrics::ExportFormat::JSON, path));
+  counter.Add(3);
+  histogram.Record(1);
+  PerfMetrics::SampleFrame();
+  PerfMetrics::StopExport();
+
+  const std::vector<std::string> lines = ReadLines(path);
+  ASSERT_EQ(1u, lines.size());
+  EXPECT_EQ(0u, lines[0].find("{\"frame\":1,"));
+  EXPECT_NE(std::string::npos, lines[0].find("\"test.json_counter\":3"));
+  EXPECT_NE(std::string::npos,
+            lines[0].find("\"test.json_histogram\":{\"count\":1,\"total_us\":1,\"max_us\":2}"));
+  EXPECT_EQ('}', lines[0].back());
+
+  File::DeleteDirRecursively(dir);
+}
@@ -0,0 +1,224 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/HLE/HLE.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "../PowerPC/PowerPCTestUtil.h"
+
+using namespace PowerPCTest;
+
+namespace
+{
+constexpr u32 MEMCPY_ADDRESS = 0x80001000;
+constexpr u32 MEMSET_ADDRESS = 0x80001100;
+constexpr u32 DCFLUSHRANGE_ADDRESS = 0x80001200;
+constexpr u32 PSMTXTRANS_ADDRESS = 0x80001300;
+constexpr u32 PSMTXCOPY_ADDRESS = 0x80001400;
+constexpr u32 RETURN_ADDRESS = 0x80000800;
+constexpr u32 BUFFER_ADDRESS = 0x80010000;
+constexpr u32 BUFFER_SIZE = 0x1000;
+
+// Copies bytewise, backwards if the source is below the destination.
+const std::vector<u32> MEMCPY_CODE = {
+    CMPLWI(0, 5, 0), BEQLR,          CMPLW(0, 4, 3), BLT(32),       MTCTR(5),
+    ADDI(6, 4, -1),  ADDI(7, 3, -1), LBZU(0, 6, 1),  STBU(0, 7, 1), BDNZ(-8),
+    BLR,             MTCTR(5),       ADD(6, 4, 5),   ADD(7, 3, 5),  LBZU(0, 6, -1),
+    STBU(0, 7, -1),  BDNZ(-8),       BLR,
+};
+
+const std::vector<u32> MEMSET_CODE = {
+    CMPLWI(0, 5, 0), BEQLR, MTCTR(5), ADDI(6, 3, -1), STBU(4, 6, 1), BDNZ(-4), BLR,
+};
+
+class HLESDKTest : public CoreTest
+{
+protected:
+  void SetUp() override
+  {
+    CoreTest::SetUp();
+    SetUpBATs();
+    MSR.FP = 1;
+
+    WriteCode(MEMCPY_ADDRESS, MEMCPY_CODE);
+    WriteCode(MEMSET_ADDRESS, MEMSET_CODE);
+    WriteCode(DCFLUSHRANGE_ADDRESS, {BLR});
+    WriteCode(PSMTXTRANS_ADDRESS, {BLR});
+    WriteCode(PSMTXCOPY_ADDRESS, {BLR});
+    g_symbolDB.AddKnownSymbol(MEMCPY_ADDRESS, static_cast<u32>(MEMCPY_CODE.size() * 4), "memcpy");
+    g_symbolDB.AddKnownSymbol(MEMSET_ADDRESS, static_cast<u32>(MEMSET_CODE.size() * 4), "memset");
+    g_symbolDB.AddKnownSymbol(DCFLUSHRANGE_ADDRESS, 4, "DCFlushRange");
+    g_symbolDB.AddKnownSymbol(PSMTXTRANS_ADDRESS, 4, "PSMTXTrans");
+    g_symbolDB.AddKnownSymbol(PSMTXCOPY_ADDRESS, 4, "PSMTXCopy");
+    HLE::PatchFunctions();
+  }
+
+  void TearDown() override
+  {
+    HLE::Clear();
+    g_symbolDB.Clear();
+    CoreTest::TearDown();
+  }
+
+  static void FillBuffer()
+  {
+    for (u32 i = 0; i < BUFFER_SIZE; ++i)
+      PowerPC::HostWrite_U8(static_cast<u8>(i * 7 + (i >> 8)), BUFFER_ADDRESS + i);
+  }
+
+  static std::vector<u8> ReadBuffer()
+  {
+    std::vector<u8> buffer(BUFFER_SIZE);
+    for (u32 i = 0; i < BUFFER_SIZE; ++i)
+      buffer[i] = PowerPC::HostRead_U8(BUFFER_ADDRESS + i);
+    return buffer;
+  }
+
+  // Calls the function at the given address with the interpreter and returns the contents of
+  // the buffer afterwards.
+  static std::vector<u8> Call(u32 address, const std::array<u32, 3>& args, bool replace)
+  {
+    Config::SetBaseOrCurrent(Config::MAIN_REPLACE_SDK_FUNCTIONS, replace);
+    FillBuffer();
+
+    for (size_t i = 0; i < args.size(); ++i)
+      GPR(3 + i) = args[i];
+    LR = RETURN_ADDRESS;
+    PC = address;
+    u32 steps = 0;
+    while (PC != RETURN_ADDRESS && steps++ < 0x100000)
+      PowerPC::SingleStep();
+    EXPECT_EQ(RETURN_ADDRESS, PC);
+
+    // The replacements don't touch the registers that hold the return values.
+    EXPECT_EQ(args[0], GPR(3));
+    return ReadBuffer();
+  }
+
+  static void ExpectSameResult(u32 address, const std::array<u32, 3>& args)
+  {
+    const std::vector<u8> interpreted = Call(address, args, false);
+    const std::vector<u8> replaced = Call(address, args, true);
+    EXPECT_EQ(interpreted, replaced);
+  }
+};
+}  // Anonymous namespace
+
+TEST_F(HLESDKTest, ReplacementIsOnlyUsedWhenEnabled)
+{
+  Config::SetBaseOrCurrent(Config::MAIN_REPLACE_SDK_FUNCTIONS, false);
+  EXPECT_EQ(0u, HLE::GetInlinableFunctionIndex(MEMCPY_ADDRESS));
+  Config::SetBaseOrCurrent(Config::MAIN_REPLACE_SDK_FUNCTIONS, true);
+  EXPECT_NE(0u, HLE::GetInlinableFunctionIndex(MEMCPY_ADDRESS));
+  EXPECT_EQ(0u, HLE::GetInlinableFunctionIndex(MEMCPY_ADDRESS + 4));
+
+  // The whole call is handled in a single step.
+  GPR(5) = 0;
+  LR = RETURN_ADDRESS;
+  PC = MEMCPY_ADDRESS;
+  PowerPC::SingleStep();
+  EXPECT_EQ(RETURN_ADDRESS, PC);
+}
+
+TEST_F(HLESDKTest, ReplacementDeclinesWhenMemoryIsWatched)
+{
+  // Memchecks have to see every access, so the original function has to be executed instead.
+  TMemCheck memcheck;
+  memcheck.start_address = memcheck.end_address = RETURN_ADDRESS;
+  PowerPC::memchecks.Add(memcheck);
+
+  Config::SetBaseOrCurrent(Config::MAIN_REPLACE_SDK_FUNCTIONS, true);
+  GPR(3) = BUFFER_ADDRESS;
+  GPR(4) = BUFFER_ADDRESS + 0x800;
+  GPR(5) = 0x10;
+  LR = RETURN_ADDRESS;
+  PC = MEMCPY_ADDRESS;
+  PowerPC::SingleStep();
+  EXPECT_NE(RETURN_ADDRESS, PC);
+
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + 0x800, 0x400});
+  ExpectSameResult(MEMSET_ADDRESS, {BUFFER_ADDRESS + 3, 0x1234567f, 0x801});
+
+  PowerPC::memchecks.Clear();
+}
+
+TEST_F(HLESDKTest, Memcpy)
+{
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + 0x800, 0x400});
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS + 0x123, BUFFER_ADDRESS + 0x801, 0x3ff});
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + 0x800, 0});
+}
+
+TEST_F(HLESDKTest, MemcpyOverlapping)
+{
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS + 0x10, BUFFER_ADDRESS, 0x400});
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + 0x10, 0x400});
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS + 1, BUFFER_ADDRESS, 0xfff});
+}
+
+TEST_F(HLESDKTest, MemcpyMirrored)
+{
+  // The uncached mirror is located above the cached one, but the copy direction depends on the
+  // effective addresses rather than on the physical ones.
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS + 4, BUFFER_ADDRESS + 0x40000000, 0x100});
+  ExpectSameResult(MEMCPY_ADDRESS, {BUFFER_ADDRESS + 0x40000000, BUFFER_ADDRESS + 4, 0x100});
+}
+
+TEST_F(HLESDKTest, Memset)
+{
+  ExpectSameResult(MEMSET_ADDRESS, {BUFFER_ADDRESS + 3, 0x1234567f, 0x801});
+  ExpectSameResult(MEMSET_ADDRESS, {BUFFER_ADDRESS, 0, BUFFER_SIZE});
+  ExpectSameResult(MEMSET_ADDRESS, {BUFFER_ADDRESS, 0xff, 0});
+}
+
+TEST_F(HLESDKTest, DCFlushRangeLeavesMemoryAlone)
+{
+  ExpectSameResult(DCFLUSHRANGE_ADDRESS, {BUFFER_ADDRESS + 5, 0x123, 0});
+}
+
+TEST_F(HLESDKTest, PSMTXTrans)
+{
+  rPS0(1) = 1.5;
+  rPS0(2) = -2.0;
+  rPS0(3) = 0.25;
+  const std::vector<u8> buffer = Call(PSMTXTRANS_ADDRESS, {BUFFER_ADDRESS, 0, 0}, true);
+
+  const std::array<u32, 12> expected = {0x3f800000, 0, 0,          0x3fc00000, 0, 0x3f800000,
+                                        0,          0xc0000000, 0, 0, 0x3f800000, 0x3e800000};
+  for (size_t i = 0; i < expected.size(); ++i)
+  {
+    const u32 value = buffer[i * 4] << 24 | buffer[i * 4 + 1] << 16 | buffer[i * 4 + 2] << 8 |
+                      buffer[i * 4 + 3];
+    EXPECT_EQ(expected[i], value);
+  }
+}
+
+TEST_F(HLESDKTest, PSMTXCopyOnlyReplacedWithUnscaledGQR0)
+{
+  constexpr u32 DEST_OFFSET = 0x100;
+  constexpr u32 MATRIX_SIZE = 3 * 4 * sizeof(u32);
+
+  GQR(0) = 0;
+  std::vector<u8> buffer = Call(PSMTXCOPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + DEST_OFFSET, 0},
+                                true);
+  EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + MATRIX_SIZE,
+                         buffer.begin() + DEST_OFFSET));
+
+  // The original code, which is only a blr here, has to run when the values would be converted.
+  GQR(0) = 0x00070007;
+  buffer = Call(PSMTXCOPY_ADDRESS, {BUFFER_ADDRESS, BUFFER_ADDRESS + DEST_OFFSET, 0}, true);
+  EXPECT_FALSE(std::equal(buffer.begin(), buffer.begin() + MATRIX_SIZE,
+                          buffer.begin() + DEST_OFFSET));
+}
@@ -2,15 +2,21 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/NandPaths.h"
 #include "Core/IOS/FS/FileSystem.h"
+#include "Core/IOS/FS/HostBackend/CachedFile.h"
 #include "Core/IOS/IOS.h"
 #include "UICommon/UICommon.h"
 
@@ -325,3 +331,119 @@ TEST_F(FileSystemTest, ReadDirectoryOnFile)
   ASSERT_FALSE(result.Succeeded());
   EXPECT_EQ(result.Error(), ResultCode::Invalid);
 }
+
+static std::vector<u8> ReadHostFile(const std::string& wii_path)
+{
+  std::string contents;
+  File::ReadFileToString(Common::RootUserPath(Common::FROM_SESSION_ROOT) + wii_path, contents);
+  return {contents.begin(), contents.end()};
+}
+
+// Written data must reach the host file once the last handle to it is closed.
+TEST_F(FileSystemTest, WriteBackOnClose)
+{
+  std::vector<u8> test_data(0x9000);
+  std::iota(test_data.begin(), test_data.end(), u8(0));
+
+  ASSERT_EQ(m_fs->CreateFile(Uid{0}, Gid{0}, "/tmp/f", 0, modes), ResultCode::Success);
+  {
+    const Result<FileHandle> file1 = m_fs->OpenFile(Uid{0}, Gid{0}, "/tmp/f", Mode::Write);
+    const Result<FileHandle> file2 = m_fs->OpenFile(Uid{0}, Gid{0}, "/tmp/f", Mode::Read);
+    ASSERT_TRUE(file1.Succeeded());
+    ASSERT_TRUE(file2.Succeeded());
+    ASSERT_TRUE(file1->Write(test_data.data(), test_data.size()).Succeeded());
+  }
+  EXPECT_EQ(ReadHostFile("/tmp/f"), test_data);
+}
+
+// Path-based calls must see data that is still only in the cache.
+TEST_F(FileSystemTest, MetadataOfFileWithCachedWrites)
+{
+  ASSERT_EQ(m_fs->CreateFile(Uid{0}, Gid{0}, "/tmp/f", 0, modes), ResultCode::Success);
+
+  const Result<FileHandle> file = m_fs->OpenFile(Uid{0}, Gid{0}, "/tmp/f", Mode::Write);
+  ASSERT_TRUE(file.Succeeded());
+  ASSERT_TRUE(file->Write(std::vector<u8>(20).data(), 20).Succeeded());
+
+  const Result<Metadata> metadata = m_fs->GetMetadata(Uid{0}, Gid{0}, "/tmp/f");
+  ASSERT_TRUE(metadata.Succeeded());
+  EXPECT_EQ(metadata->size, 20u);
+  EXPECT_EQ(ReadHostFile("/tmp/f").size(), 20u);
+}
+
+// Pages of a file that is only read must not pile up, as such a file is never flushed.
+TEST_F(FileSystemTest, CachedReadsOfUnwrittenFile)
+{
+  constexpr u32 PAGE_COUNT = CachedHostFile::MAX_CLEAN_PAGES * 2;
+  std::vector<u8> test_data(PAGE_COUNT * CachedHostFile::PAGE_SIZE);
+  std::iota(test_data.begin(), test_data.end(), u8(0));
+
+  const std::string host_path = Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/tmp/f";
+  ASSERT_TRUE(File::WriteStringToFile(std::string(test_data.begin(), test_data.end()), host_path));
+
+  CachedHostFile file(host_path);
+  ASSERT_TRUE(file.IsOpen());
+  std::vector<u8> buffer(CachedHostFile::PAGE_SIZE + 1);
+  for (u32 page = 0; page < PAGE_COUNT - 1; ++page)
+  {
+    const u32 offset = page * CachedHostFile::PAGE_SIZE + 1;
+    ASSERT_TRUE(file.Read(offset, buffer.data(), static_cast<u32>(buffer.size())));
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), test_data.begin() + offset));
+    EXPECT_LE(file.GetCachedPageCount(), CachedHostFile::MAX_CLEAN_PAGES);
+  }
+  EXPECT_EQ(0u, file.GetDirtyPageCount());
+}
+
+// Checks random unaligned accesses against a reference copy of the file contents,
+// both through the FS and in the resulting host file.
+TEST_F(FileSystemTest, RandomAccessMatchesReference)
+{
+  constexpr u32 MAX_SIZE = 0x180000;
+  std::mt19937 rng(1234);
+  std::vector<u8> reference(0x1000);
+  std::generate(reference.begin(), reference.end(), [&rng] { return u8(rng()); });
+
+  ASSERT_EQ(m_fs->CreateFile(Uid{0}, Gid{0}, "/tmp/f", 0, modes), ResultCode::Success);
+  {
+    const Result<FileHandle> file = m_fs->OpenFile(Uid{0}, Gid{0}, "/tmp/f", Mode::Write);
+    ASSERT_TRUE(file.Succeeded());
+    ASSERT_TRUE(file->Write(reference.data(), reference.size()).Succeeded());
+  }
+
+  const Result<FileHandle> file = m_fs->OpenFile(Uid{0}, Gid{0}, "/tmp/f", Mode::ReadWrite);
+  ASSERT_TRUE(file.Succeeded());
+
+  std::vector<u8> buffer;
+  for (int i = 0; i < 500; ++i)
+  {
+    const u32 offset = rng() % (reference.size() + 1);
+    ASSERT_TRUE(file->Seek(offset, SeekMode::Set).Succeeded());
+
+    const u32 size = rng() % 0x9000;
+    if (rng() % 2 == 0 && offset + size <= MAX_SIZE)
+    {
+      buffer.resize(size);
+      std::generate(buffer.begin(), buffer.end(), [&rng] { return u8(rng()); });
+      ASSERT_TRUE(file->Write(buffer.data(), size).Succeeded());
+      if (offset + size > reference.size())
+        reference.resize(offset + size);
+      std::copy(buffer.begin(), buffer.end(), reference.begin() + offset);
+    }
+    else
+    {
+      // FileHandle::Read treats short reads as errors.
+      const size_t read_size = std::min<size_t>(size, reference.size() - offset);
+      buffer.assign(read_size, 0);
+      const Result<size_t> read = file->Read(buffer.data(), read_size);
+      ASSERT_TRUE(read.Succeeded());
+      ASSERT_EQ(*read, read_size);
+      ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), reference.begin() + offset));
+    }
+    ASSERT_EQ(file->GetStatus()->size, reference.size());
+  }
+
+  const Result<Metadata> metadata = m_fs->GetMetadata(Uid{0}, Gid{0}, "/tmp/f");
+  ASSERT_TRUE(metadata.Succeeded());
+  EXPECT_EQ(metadata->size, reference.size());
+  EXPECT_EQ(ReadHostFile("/tmp/f"), reference);
+}
@@ -0,0 +1,124 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "PowerPCTestUtil.h"
+
+using namespace PowerPCTest;
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x80001000;
+constexpr u32 RETURN_ADDRESS = 0x80000800;
+constexpr u32 BUFFER_ADDRESS = 0x80010000;
+constexpr u32 BUFFER_SIZE = 0x100;
+
+// Walks through a buffer, covering all of the instructions that the cached interpreter has
+// specialized handlers for, including the fused sequences.
+const std::vector<u32> TEST_CODE = {
+    ADDIS(3, 0, 0x8001),       // lis r3, BUFFER_ADDRESS@h
+    ORI(3, 3, 0),              // ori r3, r3, BUFFER_ADDRESS@l
+    ADDIS(4, 0, 0x1234),       // lis r4, 0x1234
+    ADDI(4, 4, -16),           // addi r4, r4, -16
+    ADDI(5, 0, BUFFER_SIZE / 4),
+    MTCTR(5),
+    ADDI(8, 0, 0),
+    // loop:
+    LWZ(6, 3, 0),
+    RLWINM(7, 6, 5, 3, 29),
+    ADD(7, 7, 4),
+    STW(7, 3, 0),
+    ADDI(3, 3, 4),
+    CMPWI(0, 6, 0),
+    BC(12, 0, 8),              // blt +8
+    ADDI(8, 8, 1),
+    CMPLW(1, 6, 4),
+    BC(12, 6, 8),              // beq cr1, +8
+    ADDI(8, 8, 0x100),
+    CMPLWI(2, 6, 0x8000),
+    BC(4, 1, 8),               // ble +8, testing the result of the cmpwi
+    ADDIS(8, 8, 1),
+    BC(16, 0, -56),            // bdnz loop
+    BLR,
+};
+
+class CachedInterpreterTest : public CoreTest
+{
+protected:
+  CachedInterpreterTest() : CoreTest(PowerPC::CPUCore::CachedInterpreter) {}
+
+  struct State
+  {
+    std::array<u32, 32> gpr;
+    u32 cr;
+    u32 ctr;
+    std::vector<u32> buffer;
+  };
+
+  // Runs the code in the given mode, starting with the same state every time.
+  static State Run(PowerPC::CoreMode mode, const std::vector<u32>& code)
+  {
+    PowerPC::SetMode(mode);
+    JitInterface::ClearCache();
+
+    SetUpBATs();
+    WriteCode(CODE_ADDRESS, code);
+    // Some of the words are equal to the constant that the code compares them with.
+    for (u32 i = 0; i < BUFFER_SIZE; i += 4)
+    {
+      const u32 value = i % 0x20 == 0 ? 0x1233fff0 : i * 0x0d3f5a11 + (i << 26);
+      PowerPC::HostWrite_U32(value, BUFFER_ADDRESS + i);
+    }
+
+    for (u32 i = 0; i < 32; ++i)
+      GPR(i) = i * 0x01010101;
+    PowerPC::SetCR(0);
+    PowerPC::SetXER_SO(0);
+    LR = RETURN_ADDRESS;
+    PC = CODE_ADDRESS;
+    u32 steps = 0;
+    while (PC != RETURN_ADDRESS && steps++ < 0x10000)
+      PowerPC::SingleStep();
+    EXPECT_EQ(RETURN_ADDRESS, PC);
+
+    State state;
+    for (u32 i = 0; i < 32; ++i)
+      state.gpr[i] = GPR(i);
+    state.cr = PowerPC::GetCR();
+    state.ctr = CTR;
+    for (u32 i = 0; i < BUFFER_SIZE; i += 4)
+      state.buffer.push_back(PowerPC::HostRead_U32(BUFFER_ADDRESS + i));
+
+    return state;
+  }
+};
+}  // Anonymous namespace
+
+TEST_F(CachedInterpreterTest, PredecodedInstructionsMatchInterpreter)
+{
+  const State interpreted = Run(PowerPC::CoreMode::Interpreter, TEST_CODE);
+  const State cached = Run(PowerPC::CoreMode::JIT, TEST_CODE);
+  EXPECT_EQ(interpreted.gpr, cached.gpr);
+  EXPECT_EQ(interpreted.cr, cached.cr);
+  EXPECT_EQ(interpreted.ctr, cached.ctr);
+  EXPECT_EQ(interpreted.buffer, cached.buffer);
+
+  // Make sure that the test actually went through the loop and both ways of each branch.
+  EXPECT_EQ(0u, interpreted.ctr);
+  EXPECT_NE(0u, interpreted.gpr[8] & 0xff);
+  EXPECT_NE(0u, interpreted.gpr[8] & 0xff00);
+  EXPECT_NE(0u, interpreted.gpr[8] >> 16);
+  EXPECT_NE(BUFFER_SIZE / 4, interpreted.gpr[8] & 0xff);
+  EXPECT_NE(BUFFER_SIZE / 4, (interpreted.gpr[8] >> 8) & 0xff);
+  EXPECT_NE(BUFFER_SIZE / 4, interpreted.gpr[8] >> 16);
+}
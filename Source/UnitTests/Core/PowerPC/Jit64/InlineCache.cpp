@@ -0,0 +1,120 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/HLE/HLE.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "../PowerPCTestUtil.h"
+
+#include <gtest/gtest.h>
+
+using namespace PowerPCTest;
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x80003000;
+constexpr u32 BRANCH_TARGET = 0x80004000;
+constexpr u32 HOOK_ADDRESS = 0x80005000;
+constexpr u32 BCTR = 0x4e800420;
+
+class InlineCacheTest : public CoreTest
+{
+protected:
+  InlineCacheTest() : CoreTest(PowerPC::CPUCore::JIT64) {}
+
+  void SetUp() override
+  {
+    CoreTest::SetUp();
+    SetUpBATs();
+    WriteCode(CODE_ADDRESS, {ADDIS(3, 0, BRANCH_TARGET >> 16), ORI(3, 3, BRANCH_TARGET & 0xffff),
+                             MTCTR(3), BCTR});
+  }
+
+  void TearDown() override
+  {
+    HLE::Clear();
+    CoreTest::TearDown();
+  }
+
+  static u32 ReadImmediate(const u8* ptr)
+  {
+    u32 value;
+    std::memcpy(&value, ptr, sizeof(u32));
+    return value;
+  }
+
+  // Checks that the cache compares against the immediate and jumps to the miss handling, which
+  // starts with the 5 byte NOP that can be replaced by a jump.
+  static void ExpectValidCache(const JitBlock::InlineCache& cache)
+  {
+    EXPECT_EQ(0x3d, cache.target_immediate[-1]);
+    EXPECT_EQ(0x0f, cache.target_immediate[4]);
+    EXPECT_EQ(0x85, cache.target_immediate[5]);
+    const u8 nop[] = {0x0f, 0x1f, 0x44, 0x00, 0x00};
+    EXPECT_EQ(0, std::memcmp(nop, cache.update_jump, sizeof(nop)));
+  }
+
+  static bool IsInBlock(const JitBlock& block, const u8* ptr)
+  {
+    return ptr >= block.normalEntry && ptr < block.normalEntry + block.codeSize;
+  }
+};
+}  // Anonymous namespace
+
+TEST_F(InlineCacheTest, UpdatePatchesCompareImmediate)
+{
+  auto* const jit = static_cast<Jit64*>(g_jit);
+  jit->Jit(CODE_ADDRESS);
+  JitBlock* const block = jit->GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR.Hex);
+  ASSERT_NE(nullptr, block);
+  ASSERT_EQ(1u, block->inline_caches.size());
+  const u8* const immediate = block->inline_caches[0].target_immediate;
+
+  // The immediate has to be the last part of "cmp eax, imm32", followed by the jne to the miss
+  // handler, or the update below would overwrite other instructions.
+  EXPECT_EQ(0x3d, immediate[-1]);
+  EXPECT_EQ(0x0f, immediate[4]);
+  EXPECT_EQ(0x85, immediate[5]);
+  // The empty cache must not match any word aligned target.
+  EXPECT_NE(0u, ReadImmediate(immediate) & 3);
+
+  PC = BRANCH_TARGET;
+  Jit64::UpdateInlineCache(CODE_ADDRESS, 0, jit);
+  EXPECT_EQ(0x3d, immediate[-1]);
+  EXPECT_EQ(BRANCH_TARGET, ReadImmediate(immediate));
+  EXPECT_EQ(0x0f, immediate[4]);
+  EXPECT_EQ(0x85, immediate[5]);
+}
+
+TEST_F(InlineCacheTest, ExitFromFarCode)
+{
+  // The exit of an optimization hook is emitted in far code, followed by the original function.
+  WriteCode(HOOK_ADDRESS, {ADDIS(3, 0, BRANCH_TARGET >> 16), ORI(3, 3, BRANCH_TARGET & 0xffff),
+                           MTCTR(3), BCTR});
+  Config::SetBaseOrCurrent(Config::MAIN_REPLACE_SDK_FUNCTIONS, true);
+  HLE::Patch(HOOK_ADDRESS, "memset");
+
+  auto* const jit = static_cast<Jit64*>(g_jit);
+  jit->Jit(HOOK_ADDRESS);
+  JitBlock* const block = jit->GetBlockCache()->GetBlockFromStartAddress(HOOK_ADDRESS, MSR.Hex);
+  ASSERT_NE(nullptr, block);
+  ASSERT_EQ(2u, block->inline_caches.size());
+
+  const JitBlock::InlineCache& hook_exit = block->inline_caches[0];
+  ExpectValidCache(hook_exit);
+  EXPECT_FALSE(IsInBlock(*block, hook_exit.target_immediate));
+  EXPECT_FALSE(IsInBlock(*block, hook_exit.update_jump));
+
+  const JitBlock::InlineCache& bctr_exit = block->inline_caches[1];
+  ExpectValidCache(bctr_exit);
+  EXPECT_TRUE(IsInBlock(*block, bctr_exit.target_immediate));
+  EXPECT_FALSE(IsInBlock(*block, bctr_exit.update_jump));
+}
@@ -0,0 +1,166 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "PowerPCTestUtil.h"
+
+#include <gtest/gtest.h>
+
+using namespace PowerPCTest;
+
+namespace
+{
+constexpr u32 PAGE_TABLE_ADDRESS = 0x00100000;
+constexpr u32 VSID = 0x123;
+constexpr u32 LOGICAL_ADDRESS = 0x10005000;
+constexpr u32 PHYSICAL_ADDRESS = 0x00200000;
+constexpr u32 UNCHANGED_LOGICAL_ADDRESS = 0x10006000;
+constexpr u32 UNCHANGED_PHYSICAL_ADDRESS = 0x00201000;
+
+// Maps the faulting pages like the JITs do, and counts how often that happens.
+class PageTableFakeJit : public JitBase
+{
+public:
+  // CPUCoreBase methods
+  void Init() override {}
+  void Shutdown() override {}
+  void ClearCache() override {}
+  void Run() override {}
+  void SingleStep() override {}
+  const char* GetName() const override { return nullptr; }
+  // JitBase methods
+  JitBaseBlockCache* GetBlockCache() override { return nullptr; }
+  void Jit(u32 em_address) override {}
+  const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
+  bool HandleFault(uintptr_t access_address, SContext* ctx) override
+  {
+    ++m_faults;
+    const auto logical_base = reinterpret_cast<uintptr_t>(Memory::logical_base);
+    return PowerPC::HandlePageTableFault(static_cast<u32>(access_address - logical_base), false);
+  }
+
+  u32 m_faults = 0;
+};
+
+class MMUTest : public CoreTest
+{
+protected:
+  void SetUp() override
+  {
+    CoreTest::SetUp();
+
+    // The page table mappings are only set up along with the rest of the memory.
+    SConfig::GetInstance().bMMU = true;
+    SConfig::GetInstance().bFastmem = true;
+    Memory::Shutdown();
+    Memory::Init();
+    SetUpBATs();
+
+    PowerPC::ppcState.spr[SPR_SDR] = PAGE_TABLE_ADDRESS;
+    PowerPC::SDRUpdated();
+    PowerPC::ppcState.sr[LOGICAL_ADDRESS >> 28] = VSID;
+    WritePTE(LOGICAL_ADDRESS, PHYSICAL_ADDRESS, true);
+    WritePTE(UNCHANGED_LOGICAL_ADDRESS, UNCHANGED_PHYSICAL_ADDRESS, false);
+    Memory::Write_U32(0x12345678, PHYSICAL_ADDRESS + 0x10);
+
+    EMM::InstallExceptionHandler();
+  }
+
+  void TearDown() override
+  {
+    EMM::UninstallExceptionHandler();
+    CoreTest::TearDown();
+  }
+
+  // Writes a read/write page table entry into the first slot of its primary PTEG.
+  static void WritePTE(u32 logical_address, u32 physical_address, bool changed)
+  {
+    const u32 page_index = (logical_address >> 12) & 0xffff;
+    const u32 api = (logical_address >> 22) & 0x3f;
+    const u32 pteg_address = ((VSID ^ page_index) & 0x3ff) << 6 | PAGE_TABLE_ADDRESS;
+    Memory::Write_U32(0x80000000 | VSID << 7 | api, pteg_address);
+    Memory::Write_U32(physical_address | (changed ? 0x80 : 0) | 2, pteg_address + 4);
+  }
+
+  // Reads through the logical fastmem area, which faults if the page isn't mapped. The fake JIT
+  // is only installed for the access, as the MMU functions clear the JIT cache. The fences keep
+  // the compiler from moving the stores to g_jit past the access, which the fault handler reads.
+  u32 ReadFastmem(u32 address)
+  {
+    g_jit = &m_jit;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    const u32 value = *reinterpret_cast<volatile u32*>(Memory::logical_base + address);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    g_jit = nullptr;
+    return Common::swap32(value);
+  }
+
+  PageTableFakeJit m_jit;
+};
+}  // Anonymous namespace
+
+TEST_F(MMUTest, MapsPageOnFault)
+{
+  ASSERT_TRUE(Memory::IsPageTableMappingEnabled());
+
+  EXPECT_EQ(0x12345678u, ReadFastmem(LOGICAL_ADDRESS + 0x10));
+  EXPECT_EQ(1u, m_jit.m_faults);
+
+  // The mapping is a view of the same memory.
+  Memory::Write_U32(0x9abcdef0, PHYSICAL_ADDRESS + 0x10);
+  EXPECT_EQ(0x9abcdef0u, ReadFastmem(LOGICAL_ADDRESS + 0x10));
+  EXPECT_EQ(1u, m_jit.m_faults);
+}
+
+TEST_F(MMUTest, OnlyMapsChangedPages)
+{
+  // Accesses through the mapping don't set the C bit, so reads alone can't map a page.
+  EXPECT_FALSE(PowerPC::HandlePageTableFault(UNCHANGED_LOGICAL_ADDRESS, false));
+  EXPECT_TRUE(PowerPC::HandlePageTableFault(UNCHANGED_LOGICAL_ADDRESS, true));
+
+  // Neither can addresses that aren't in the page table.
+  EXPECT_FALSE(PowerPC::HandlePageTableFault(LOGICAL_ADDRESS + 0x10000, true));
+}
+
+TEST_F(MMUTest, UnmapsPagesWhenTranslationChanges)
+{
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(1u, m_jit.m_faults);
+
+  // tlbie of an unrelated congruence class.
+  PowerPC::InvalidateTLBEntry(LOGICAL_ADDRESS + 0x1000);
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(1u, m_jit.m_faults);
+
+  PowerPC::InvalidateTLBEntry(LOGICAL_ADDRESS);
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(2u, m_jit.m_faults);
+
+  // Segment register of another segment.
+  PowerPC::SRUpdated(0);
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(2u, m_jit.m_faults);
+
+  PowerPC::SRUpdated(LOGICAL_ADDRESS >> 28);
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(3u, m_jit.m_faults);
+
+  PowerPC::SDRUpdated();
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(4u, m_jit.m_faults);
+
+  PowerPC::DBATUpdated();
+  ReadFastmem(LOGICAL_ADDRESS);
+  EXPECT_EQ(5u, m_jit.m_faults);
+}
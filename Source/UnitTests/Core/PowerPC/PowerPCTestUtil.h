@@ -0,0 +1,162 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace PowerPCTest
+{
+// Just enough of an assembler to write test code.
+constexpr u32 DForm(u32 opcd, u32 rt, u32 ra, s16 d)
+{
+  return opcd << 26 | rt << 21 | ra << 16 | static_cast<u16>(d);
+}
+constexpr u32 XForm(u32 rt, u32 ra, u32 rb, u32 xo)
+{
+  return 31 << 26 | rt << 21 | ra << 16 | rb << 11 | xo << 1;
+}
+constexpr u32 ADDI(u32 rt, u32 ra, s16 d)
+{
+  return DForm(14, rt, ra, d);
+}
+constexpr u32 ADDIS(u32 rt, u32 ra, u16 d)
+{
+  return DForm(15, rt, ra, static_cast<s16>(d));
+}
+constexpr u32 ORI(u32 ra, u32 rs, u16 imm)
+{
+  return DForm(24, rs, ra, static_cast<s16>(imm));
+}
+constexpr u32 LWZ(u32 rt, u32 ra, s16 d)
+{
+  return DForm(32, rt, ra, d);
+}
+constexpr u32 STW(u32 rs, u32 ra, s16 d)
+{
+  return DForm(36, rs, ra, d);
+}
+constexpr u32 LBZU(u32 rt, u32 ra, s16 d)
+{
+  return DForm(35, rt, ra, d);
+}
+constexpr u32 STBU(u32 rs, u32 ra, s16 d)
+{
+  return DForm(39, rs, ra, d);
+}
+constexpr u32 RLWINM(u32 ra, u32 rs, u32 sh, u32 mb, u32 me)
+{
+  return 21 << 26 | rs << 21 | ra << 16 | sh << 11 | mb << 6 | me << 1;
+}
+constexpr u32 CMPWI(u32 crf, u32 ra, s16 imm)
+{
+  return DForm(11, crf << 2, ra, imm);
+}
+constexpr u32 CMPLWI(u32 crf, u32 ra, u16 imm)
+{
+  return DForm(10, crf << 2, ra, static_cast<s16>(imm));
+}
+constexpr u32 CMPLW(u32 crf, u32 ra, u32 rb)
+{
+  return XForm(crf << 2, ra, rb, 32);
+}
+constexpr u32 ADD(u32 rt, u32 ra, u32 rb)
+{
+  return XForm(rt, ra, rb, 266);
+}
+constexpr u32 MTCTR(u32 rs)
+{
+  return XForm(rs, 9, 0, 467);
+}
+constexpr u32 BC(u32 bo, u32 bi, s16 offset)
+{
+  return DForm(16, bo, bi, offset);
+}
+constexpr u32 BDNZ(s16 offset)
+{
+  return BC(16, 0, offset);
+}
+constexpr u32 BLT(s16 offset)
+{
+  return BC(12, 0, offset);
+}
+constexpr u32 BEQLR = 0x4d820020;
+constexpr u32 BLR = 0x4e800020;
+
+inline void WriteCode(u32 address, const std::vector<u32>& code)
+{
+  for (u32 i = 0; i < code.size(); ++i)
+    PowerPC::HostWrite_U32(code[i], address + i * 4);
+}
+
+// Maps the cached mirror of MEM1 for instructions and data, and the uncached mirror for data,
+// like the BATs set up by the IPL.
+inline void SetUpBATs()
+{
+  MSR.Hex = 0;
+  MSR.DR = 1;
+  MSR.IR = 1;
+  PowerPC::ppcState.spr[SPR_IBAT0U] = 0x80001fff;
+  PowerPC::ppcState.spr[SPR_IBAT0L] = 0x00000002;
+  PowerPC::ppcState.spr[SPR_DBAT0U] = 0x80001fff;
+  PowerPC::ppcState.spr[SPR_DBAT0L] = 0x00000002;
+  PowerPC::ppcState.spr[SPR_DBAT1U] = 0xc0001fff;
+  PowerPC::ppcState.spr[SPR_DBAT1L] = 0x0000002a;
+  PowerPC::DBATUpdated();
+  PowerPC::IBATUpdated();
+}
+
+// Sets up enough of the emulated system to run PowerPC code with the given CPU core.
+class CoreTest : public testing::Test
+{
+protected:
+  explicit CoreTest(PowerPC::CPUCore cpu_core = PowerPC::CPUCore::Interpreter)
+      : m_cpu_core(cpu_core)
+  {
+  }
+
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    PowerPC::Init(m_cpu_core);
+    CoreTiming::Init();
+    Memory::Init();
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+private:
+  PowerPC::CPUCore m_cpu_core;
+  std::string m_profile_path;
+};
+}  // namespace PowerPCTest
@@ -0,0 +1,113 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/AddressRangeIndex.h"
+
+namespace
+{
+struct Range
+{
+  u32 address;
+  u32 size;
+  int id;
+};
+
+// Small pages, so that most of the ranges cover several of them.
+using TestIndex = AddressRangeIndex<int, 8>;
+
+std::vector<int> FindOverlapping(const TestIndex& index, u32 address, u32 size)
+{
+  std::vector<int> ids;
+  index.ForEachOverlapping(address, size, [&ids](int id) { ids.push_back(id); });
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+std::vector<int> FindOverlapping(const std::vector<Range>& ranges, u32 address, u32 size)
+{
+  std::vector<int> ids;
+  for (const Range& range : ranges)
+  {
+    if (u64{range.address} + std::max<u32>(range.size, 1) > address &&
+        range.address < u64{address} + std::max<u32>(size, 1))
+    {
+      ids.push_back(range.id);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+}  // Anonymous namespace
+
+TEST(AddressRangeIndex, FindsOverlappingRanges)
+{
+  TestIndex index;
+  index.Insert(0x1000, 0x10, 1);
+  index.Insert(0x1010, 0x400, 2);
+  index.Insert(0x0f00, 0x1000, 3);
+  index.Insert(0x2000, 0, 4);
+
+  EXPECT_EQ(4u, index.Size());
+  EXPECT_EQ(std::vector<int>({1, 3}), FindOverlapping(index, 0x1000, 0x10));
+  EXPECT_EQ(std::vector<int>({2, 3}), FindOverlapping(index, 0x1100, 0x100));
+  EXPECT_EQ(std::vector<int>({3}), FindOverlapping(index, 0x1e00, 0x200));
+  EXPECT_EQ(std::vector<int>({4}), FindOverlapping(index, 0x2000, 0x100));
+  EXPECT_EQ(std::vector<int>(), FindOverlapping(index, 0x2001, 0x100));
+  EXPECT_EQ(std::vector<int>(), FindOverlapping(index, 0x0, 0xf00));
+
+  index.Remove(0x0f00, 0x1000, 3);
+  EXPECT_EQ(3u, index.Size());
+  EXPECT_EQ(std::vector<int>({1}), FindOverlapping(index, 0x1000, 0x10));
+
+  index.Clear();
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_EQ(std::vector<int>(), FindOverlapping(index, 0x0, 0x10000));
+}
+
+// Replays a trace of textures being loaded, overwritten by EFB copies and freed, similar to what
+// the texture cache sees, and checks every query against a linear search.
+TEST(AddressRangeIndex, MatchesLinearSearch)
+{
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> address_dist(0, 0x20000);
+  std::uniform_int_distribution<u32> size_dist(0, 0x2000);
+  std::uniform_int_distribution<int> action_dist(0, 3);
+
+  TestIndex index;
+  std::vector<Range> ranges;
+  for (int id = 0; id < 5000; ++id)
+  {
+    const u32 address = address_dist(rng) & ~0x1f;
+    const u32 size = size_dist(rng);
+
+    switch (action_dist(rng))
+    {
+    case 0:
+      if (!ranges.empty())
+      {
+        const size_t i = rng() % ranges.size();
+        index.Remove(ranges[i].address, ranges[i].size, ranges[i].id);
+        ranges.erase(ranges.begin() + i);
+      }
+      break;
+
+    case 1:
+      ASSERT_EQ(FindOverlapping(ranges, address, size), FindOverlapping(index, address, size));
+      break;
+
+    default:
+      index.Insert(address, size, id);
+      ranges.push_back({address, size, id});
+      break;
+    }
+  }
+  EXPECT_EQ(ranges.size(), index.Size());
+}
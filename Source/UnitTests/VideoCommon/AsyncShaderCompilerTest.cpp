@@ -0,0 +1,186 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "VideoCommon/AsyncShaderCompiler.h"
+#include "VideoCommon/ShaderCache.h"
+
+using VideoCommon::AsyncShaderCompiler;
+using VideoCommon::ShaderCache;
+
+namespace
+{
+struct Log
+{
+  std::mutex mutex;
+  std::vector<int> compiled;
+  std::vector<int> retrieved;
+  std::vector<int> cancelled;
+};
+
+class TestWorkItem final : public AsyncShaderCompiler::WorkItem
+{
+public:
+  TestWorkItem(Log* log, int id, Common::Event* started = nullptr, Common::Event* block = nullptr)
+      : m_log(log), m_id(id), m_started(started), m_block(block)
+  {
+  }
+
+  bool Compile() override
+  {
+    if (m_block)
+    {
+      m_started->Set();
+      m_block->Wait();
+    }
+    std::lock_guard<std::mutex> guard(m_log->mutex);
+    m_log->compiled.push_back(m_id);
+    return true;
+  }
+
+  void Retrieve() override { m_log->retrieved.push_back(m_id); }
+  void Cancel() override { m_log->cancelled.push_back(m_id); }
+
+private:
+  Log* m_log;
+  int m_id;
+  Common::Event* m_started;
+  Common::Event* m_block;
+};
+
+// Keeps the only worker thread busy until Release is called, so that the order of the work
+// items queued in the meantime is up to the compiler.
+class BlockedCompiler
+{
+public:
+  explicit BlockedCompiler(u32 priority_aging_limit = 0)
+  {
+    m_compiler.SetPriorityAgingLimit(priority_aging_limit);
+    m_compiler.StartWorkerThreads(1);
+    m_compiler.QueueWorkItem(std::make_unique<TestWorkItem>(&m_log, -1, &m_started, &m_block), 0);
+    m_started.Wait();
+  }
+
+  ~BlockedCompiler() { m_compiler.StopWorkerThreads(); }
+
+  AsyncShaderCompiler::WorkItemId Queue(int id, u32 priority)
+  {
+    return m_compiler.QueueWorkItem(std::make_unique<TestWorkItem>(&m_log, id), priority);
+  }
+
+  AsyncShaderCompiler::WorkItemId Queue(int id, u32 priority,
+                                        AsyncShaderCompiler::Clock::time_point deadline)
+  {
+    return m_compiler.QueueWorkItem(std::make_unique<TestWorkItem>(&m_log, id), priority,
+                                    deadline);
+  }
+
+  void Promote(AsyncShaderCompiler::WorkItemId id, u32 priority)
+  {
+    m_compiler.PromoteWorkItem(id, priority);
+  }
+
+  Log& Release()
+  {
+    m_block.Set();
+    m_compiler.WaitUntilCompletion();
+    m_compiler.RetrieveWorkItems();
+    m_log.compiled.erase(m_log.compiled.begin());
+    m_log.retrieved.erase(m_log.retrieved.begin());
+    return m_log;
+  }
+
+private:
+  AsyncShaderCompiler m_compiler;
+  Common::Event m_started;
+  Common::Event m_block;
+  Log m_log;
+};
+}  // Anonymous namespace
+
+TEST(AsyncShaderCompiler, CompilesInPriorityOrder)
+{
+  BlockedCompiler compiler;
+  compiler.Queue(0, 300);
+  compiler.Queue(1, 100);
+  compiler.Queue(2, 200);
+  compiler.Queue(3, 100);
+
+  const Log& log = compiler.Release();
+  EXPECT_EQ(std::vector<int>({1, 3, 2, 0}), log.compiled);
+  EXPECT_EQ(log.compiled, log.retrieved);
+}
+
+TEST(AsyncShaderCompiler, AgesWaitingWorkItems)
+{
+  BlockedCompiler compiler;
+  compiler.Queue(0, 2);
+  std::this_thread::sleep_for(3 * std::chrono::microseconds(
+                                      AsyncShaderCompiler::PRIORITY_AGING_INTERVAL_US));
+  compiler.Queue(1, 0);
+
+  const Log& log = compiler.Release();
+  EXPECT_EQ(std::vector<int>({0, 1}), log.compiled);
+}
+
+TEST(AsyncShaderCompiler, NeverAgesPastTheLimit)
+{
+  BlockedCompiler compiler(ShaderCache::COMPILE_PRIORITY_PREDICTED_PIPELINE);
+  compiler.Queue(0, ShaderCache::COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
+  // Long enough for the shader cache pipeline to age past an on demand pipeline without the limit.
+  std::this_thread::sleep_for(
+      (ShaderCache::COMPILE_PRIORITY_SHADERCACHE_PIPELINE -
+       ShaderCache::COMPILE_PRIORITY_ONDEMAND_PIPELINE + 1) *
+      std::chrono::microseconds(AsyncShaderCompiler::PRIORITY_AGING_INTERVAL_US));
+  compiler.Queue(1, ShaderCache::COMPILE_PRIORITY_UBERSHADER_PIPELINE);
+  compiler.Queue(2, ShaderCache::COMPILE_PRIORITY_PREDICTED_PIPELINE);
+  compiler.Queue(3, ShaderCache::COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+
+  // The lower priorities still age among themselves.
+  const Log& log = compiler.Release();
+  EXPECT_EQ(std::vector<int>({3, 0, 2, 1}), log.compiled);
+}
+
+TEST(AsyncShaderCompiler, CancelsWorkItemsPastTheirDeadline)
+{
+  BlockedCompiler compiler;
+  const auto now = AsyncShaderCompiler::Clock::now();
+  compiler.Queue(0, 100, now);
+  compiler.Queue(1, 100, now + std::chrono::hours(1));
+  compiler.Queue(2, 200);
+
+  const Log& log = compiler.Release();
+  EXPECT_EQ(std::vector<int>({1, 2}), log.compiled);
+  EXPECT_EQ(std::vector<int>({1, 2}), log.retrieved);
+  EXPECT_EQ(std::vector<int>({0}), log.cancelled);
+}
+
+TEST(AsyncShaderCompiler, PromotesWaitingWorkItems)
+{
+  BlockedCompiler compiler;
+  const auto now = AsyncShaderCompiler::Clock::now();
+  const AsyncShaderCompiler::WorkItemId id0 = compiler.Queue(0, 300, now);
+  compiler.Queue(1, 200);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  const AsyncShaderCompiler::WorkItemId id2 = compiler.Queue(2, 100);
+  // The promoted item keeps its queue time, so it goes ahead of the later item with the same
+  // priority.
+  compiler.Promote(id0, 100);
+  // Moving an item back is ignored.
+  compiler.Promote(id2, 300);
+
+  // The promotion also removed the deadline, which already passed.
+  const Log& log = compiler.Release();
+  EXPECT_EQ(std::vector<int>({0, 2, 1}), log.compiled);
+  EXPECT_TRUE(log.cancelled.empty());
+}
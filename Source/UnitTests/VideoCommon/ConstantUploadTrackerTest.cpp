@@ -0,0 +1,45 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ConstantUploadTracker.h"
+
+namespace
+{
+using Constants = std::array<u8, 100>;
+}  // Anonymous namespace
+
+TEST(ConstantUploadTracker, ReportsChangeAfterInvalidation)
+{
+  Constants constants = {};
+  ConstantUploadTracker tracker(sizeof(constants));
+
+  EXPECT_TRUE(tracker.Update(constants.data()));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  tracker.Invalidate();
+  EXPECT_TRUE(tracker.Update(constants.data()));
+}
+
+TEST(ConstantUploadTracker, ReportsChangedValues)
+{
+  Constants constants = {};
+  ConstantUploadTracker tracker(sizeof(constants));
+  tracker.Update(constants.data());
+
+  constants[20] = 1;
+  EXPECT_TRUE(tracker.Update(constants.data()));
+
+  // Writing the same values again isn't a change.
+  constants[20] = 1;
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  constants[99] = 2;
+  EXPECT_TRUE(tracker.Update(constants.data()));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+}
@@ -0,0 +1,106 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/DeferredBPWrites.h"
+
+namespace
+{
+using Registers = std::array<u32, 256>;
+using Writes = std::vector<std::pair<u32, u32>>;
+
+Writes ApplyAll(DeferredBPWrites* deferred, Registers* registers)
+{
+  Writes writes;
+  deferred->Apply(registers->data(), [&](u32 address, u32 value) {
+    writes.emplace_back(address, value);
+    (*registers)[address] = value;
+  });
+  return writes;
+}
+}  // Anonymous namespace
+
+TEST(DeferredBPWrites, ReturnsDeferredValues)
+{
+  Registers registers = {};
+  registers[0x20] = 1;
+  DeferredBPWrites deferred;
+  EXPECT_TRUE(deferred.IsEmpty());
+
+  deferred.Defer(0x20, 2);
+  deferred.Defer(0x20, 3);
+  EXPECT_FALSE(deferred.IsEmpty());
+  EXPECT_EQ(3u, deferred.GetValue(0x20, registers.data()));
+  EXPECT_EQ(1u, registers[0x20]);
+  EXPECT_EQ(0u, deferred.GetValue(0x21, registers.data()));
+}
+
+TEST(DeferredBPWrites, DropsWritesThatAreUndone)
+{
+  Registers registers = {};
+  registers[0x20] = 1;
+  registers[0x30] = 5;
+  DeferredBPWrites deferred;
+
+  deferred.Defer(0x20, 2);
+  deferred.Defer(0x30, 5);
+  EXPECT_FALSE(deferred.DropIfUnchanged(registers.data()));
+  EXPECT_FALSE(deferred.IsEmpty());
+
+  deferred.Defer(0x20, 1);
+  EXPECT_TRUE(deferred.DropIfUnchanged(registers.data()));
+  EXPECT_TRUE(deferred.IsEmpty());
+  EXPECT_EQ(1u, deferred.GetValue(0x20, registers.data()));
+}
+
+TEST(DeferredBPWrites, AppliesChangedWritesInOrder)
+{
+  Registers registers = {};
+  registers[0x30] = 5;
+  DeferredBPWrites deferred;
+
+  deferred.Defer(0x40, 7);
+  deferred.Defer(0x30, 5);
+  deferred.Defer(0x20, 2);
+  deferred.Defer(0x40, 8);
+
+  const Writes expected = {{0x40, 8}, {0x20, 2}};
+  EXPECT_EQ(expected, ApplyAll(&deferred, &registers));
+  EXPECT_TRUE(deferred.IsEmpty());
+  EXPECT_TRUE(ApplyAll(&deferred, &registers).empty());
+}
+
+TEST(DeferredBPWrites, RestoresSavedState)
+{
+  Registers registers = {};
+  DeferredBPWrites saved;
+  saved.Defer(0x20, 2);
+  saved.Defer(0x40, 4);
+
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  saved.DoState(p);
+  std::vector<u8> buffer(reinterpret_cast<size_t>(ptr));
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  saved.DoState(p);
+
+  // Writes which were pending before the load are replaced.
+  DeferredBPWrites loaded;
+  loaded.Defer(0x30, 3);
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_READ);
+  loaded.DoState(p);
+
+  EXPECT_EQ(0u, loaded.GetValue(0x30, registers.data()));
+  const Writes expected = {{0x20, 2}, {0x40, 4}};
+  EXPECT_EQ(expected, ApplyAll(&loaded, &registers));
+}
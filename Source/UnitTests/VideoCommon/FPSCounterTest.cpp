@@ -0,0 +1,69 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/PerfMetrics.h"
+#include "VideoCommon/FPSCounter.h"
+
+namespace
+{
+void AddFrames(FPSCounter* counter, u64 frame_time, size_t count, u32 events = 0)
+{
+  FPSCounter::FrameSample sample;
+  sample.frame_time = frame_time;
+  sample.events = events;
+  for (size_t i = 0; i < count; ++i)
+    counter->AddFrame(sample);
+}
+}  // Anonymous namespace
+
+TEST(FPSCounter, ComputesLowsFromSlowestFrames)
+{
+  FPSCounter counter;
+  AddFrames(&counter, 10000, FPSCounter::NUM_SAMPLES);
+  AddFrames(&counter, 40000, 36);
+  AddFrames(&counter, 100000, 4);
+  AddFrames(&counter, 10000, 1000);
+
+  // The slowest 1% of the 4096 kept frames are 40 frames, which average to 46 ms. The slowest 0.1%
+  // are the 4 frames which take 100 ms.
+  EXPECT_NEAR(1000.0 / 46, counter.GetOnePercentLowFPS(), 0.01);
+  EXPECT_NEAR(10.0, counter.GetPointOnePercentLowFPS(), 0.01);
+  EXPECT_NEAR(100.0, counter.GetFPS(), 0.01);
+}
+
+TEST(FPSCounter, ReportsStutterWithFrameEvents)
+{
+  FPSCounter counter;
+  AddFrames(&counter, 16667, 20);
+  AddFrames(&counter, 100000, 1,
+            PerfMetrics::FRAME_EVENT_SHADER_COMPILE | PerfMetrics::FRAME_EVENT_DVD_READ);
+  AddFrames(&counter, 16667, 20, PerfMetrics::FRAME_EVENT_TEXTURE_LOAD);
+
+  ASSERT_EQ(1u, counter.GetStutterCount());
+  const FPSCounter::Stutter& stutter = counter.GetRecentStutters().back();
+  EXPECT_EQ(20u, stutter.frame);
+  EXPECT_EQ(100000u, stutter.sample.frame_time);
+  EXPECT_EQ(16667u, stutter.average_frame_time);
+  EXPECT_EQ(PerfMetrics::FRAME_EVENT_SHADER_COMPILE | PerfMetrics::FRAME_EVENT_DVD_READ,
+            stutter.sample.events);
+}
+
+TEST(FPSCounter, IgnoresSmallHitches)
+{
+  FPSCounter counter;
+  // Twice the average, but only 2 ms longer.
+  AddFrames(&counter, 2000, 100);
+  AddFrames(&counter, 4000, 1);
+  // Nor slow frames before there is an average to compare them with.
+  FPSCounter start_counter;
+  AddFrames(&start_counter, 100000, 1);
+  AddFrames(&start_counter, 16667, 1);
+  AddFrames(&start_counter, 100000, 1);
+
+  EXPECT_EQ(0u, counter.GetStutterCount());
+  EXPECT_EQ(0u, start_counter.GetStutterCount());
+}
@@ -0,0 +1,159 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+constexpr u16 RESTART = 0xFFFF;
+constexpr u16 GUARD = 0xABCD;
+
+// One index at a time, the way the generator worked before it wrote vectors.
+std::vector<u16> GenerateScalar(int primitive, u32 num_verts, u32 index, bool pr)
+{
+  std::vector<u16> out;
+  auto triangle = [&](u32 a, u32 b, u32 c) {
+    out.insert(out.end(), {static_cast<u16>(a), static_cast<u16>(b), static_cast<u16>(c)});
+    if (pr)
+      out.push_back(RESTART);
+  };
+
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_QUADS:
+  case OpcodeDecoder::GX_DRAW_QUADS_2:
+  {
+    u32 i = 3;
+    for (; i < num_verts; i += 4)
+    {
+      if (pr)
+      {
+        out.insert(out.end(), {static_cast<u16>(index + i - 2), static_cast<u16>(index + i - 1),
+                               static_cast<u16>(index + i - 3), static_cast<u16>(index + i),
+                               RESTART});
+      }
+      else
+      {
+        triangle(index + i - 3, index + i - 2, index + i - 1);
+        triangle(index + i - 3, index + i - 1, index + i);
+      }
+    }
+    if (i == num_verts)
+      triangle(index + num_verts - 3, index + num_verts - 2, index + num_verts - 1);
+    break;
+  }
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLES:
+    for (u32 i = 2; i < num_verts; i += 3)
+      triangle(index + i - 2, index + i - 1, index + i);
+    break;
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+    if (pr)
+    {
+      for (u32 i = 0; i < num_verts; ++i)
+        out.push_back(static_cast<u16>(index + i));
+      out.push_back(RESTART);
+    }
+    else
+    {
+      bool wind = false;
+      for (u32 i = 2; i < num_verts; ++i)
+      {
+        triangle(index + i - 2, index + i - !wind, index + i - wind);
+        wind ^= true;
+      }
+    }
+    break;
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+  {
+    u32 i = 2;
+    if (pr)
+    {
+      for (; i + 3 <= num_verts; i += 3)
+      {
+        out.insert(out.end(), {static_cast<u16>(index + i - 1), static_cast<u16>(index + i),
+                               static_cast<u16>(index), static_cast<u16>(index + i + 1),
+                               static_cast<u16>(index + i + 2), RESTART});
+      }
+      for (; i + 2 <= num_verts; i += 2)
+      {
+        out.insert(out.end(), {static_cast<u16>(index + i - 1), static_cast<u16>(index + i),
+                               static_cast<u16>(index), static_cast<u16>(index + i + 1),
+                               RESTART});
+      }
+    }
+    for (; i < num_verts; ++i)
+      triangle(index, index + i - 1, index + i);
+    break;
+  }
+
+  case OpcodeDecoder::GX_DRAW_LINES:
+    for (u32 i = 1; i < num_verts; i += 2)
+      out.insert(out.end(), {static_cast<u16>(index + i - 1), static_cast<u16>(index + i)});
+    break;
+
+  case OpcodeDecoder::GX_DRAW_LINE_STRIP:
+    for (u32 i = 1; i < num_verts; ++i)
+      out.insert(out.end(), {static_cast<u16>(index + i - 1), static_cast<u16>(index + i)});
+    break;
+
+  case OpcodeDecoder::GX_DRAW_POINTS:
+    for (u32 i = 0; i < num_verts; ++i)
+      out.push_back(static_cast<u16>(index + i));
+    break;
+  }
+  return out;
+}
+
+void CheckAllPrimitives(bool pr)
+{
+  g_Config.backend_info.bSupportsPrimitiveRestart = pr;
+  IndexGenerator::Init();
+
+  std::vector<u16> buffer(0x10000);
+  for (int primitive = 0; primitive < 8; ++primitive)
+  {
+    for (u32 num_verts = 0; num_verts < 200; ++num_verts)
+    {
+      // Start with a few other vertices, so that the batch doesn't start at index 0.
+      const u32 index = num_verts % 7;
+      std::vector<u16> expected = GenerateScalar(OpcodeDecoder::GX_DRAW_POINTS, index, 0, pr);
+      const std::vector<u16> batch = GenerateScalar(primitive, num_verts, index, pr);
+      expected.insert(expected.end(), batch.begin(), batch.end());
+
+      std::fill(buffer.begin(), buffer.end(), GUARD);
+      IndexGenerator::Start(buffer.data());
+      IndexGenerator::AddIndices(OpcodeDecoder::GX_DRAW_POINTS, index);
+      IndexGenerator::AddIndices(primitive, num_verts);
+
+      ASSERT_EQ(expected.size(), IndexGenerator::GetIndexLen())
+          << "primitive " << primitive << ", " << num_verts << " vertices";
+      ASSERT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()))
+          << "primitive " << primitive << ", " << num_verts << " vertices";
+      EXPECT_EQ(GUARD, buffer[expected.size()]);
+      EXPECT_EQ(index + num_verts, IndexGenerator::GetNumVerts());
+    }
+  }
+}
+}  // Anonymous namespace
+
+TEST(IndexGenerator, MatchesScalarGeneration)
+{
+  CheckAllPrimitives(false);
+}
+
+TEST(IndexGenerator, MatchesScalarGenerationWithPrimitiveRestart)
+{
+  CheckAllPrimitives(true);
+}
@@ -0,0 +1,99 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/PipelinePredictor.h"
+
+using VideoCommon::PipelinePredictor;
+
+namespace
+{
+void ObserveAll(PipelinePredictor* predictor, const std::vector<u64>& pipelines)
+{
+  for (u64 pipeline : pipelines)
+    predictor->Observe(pipeline);
+}
+
+std::vector<u64> GetPredictions(const PipelinePredictor& predictor, u64 pipeline)
+{
+  std::vector<u64> predictions;
+  predictor.ForEachPrediction(pipeline, [&](u64 next) { predictions.push_back(next); });
+  return predictions;
+}
+}  // Anonymous namespace
+
+TEST(PipelinePredictor, PredictsRepeatedTransitions)
+{
+  PipelinePredictor predictor;
+  ObserveAll(&predictor, {1, 2, 1, 2, 1, 3});
+
+  // 1 -> 3 was only seen once.
+  EXPECT_EQ(std::vector<u64>({2}), GetPredictions(predictor, 1));
+  EXPECT_EQ(std::vector<u64>({1}), GetPredictions(predictor, 2));
+  EXPECT_EQ(std::vector<u64>(), GetPredictions(predictor, 3));
+
+  ObserveAll(&predictor, {1, 3, 1, 3, 1});
+  EXPECT_EQ(std::vector<u64>({3, 2}), GetPredictions(predictor, 1));
+  EXPECT_EQ(std::vector<u64>({1}), GetPredictions(predictor, 2));
+}
+
+TEST(PipelinePredictor, IgnoresRepeatedPipelines)
+{
+  PipelinePredictor predictor;
+  EXPECT_TRUE(predictor.Observe(1));
+  EXPECT_FALSE(predictor.Observe(1));
+  EXPECT_TRUE(predictor.Observe(2));
+  EXPECT_FALSE(predictor.Observe(2));
+  EXPECT_TRUE(predictor.Observe(1));
+  EXPECT_TRUE(predictor.Observe(2));
+
+  EXPECT_EQ(std::vector<u64>({2}), GetPredictions(predictor, 1));
+  EXPECT_EQ(std::vector<u64>(), GetPredictions(predictor, 2));
+}
+
+TEST(PipelinePredictor, ReplacesLeastCommonSuccessor)
+{
+  PipelinePredictor predictor;
+  for (u32 i = 0; i < PipelinePredictor::MAX_SUCCESSORS; ++i)
+  {
+    const u32 count = PipelinePredictor::MAX_SUCCESSORS + 1 - i;
+    predictor.AddTransition({1, 10 + i, count});
+  }
+
+  // The new successor takes the slot of the least common one, but has to be seen again to be
+  // predicted.
+  predictor.AddTransition({1, 20, 1});
+  std::vector<u64> expected;
+  for (u32 i = 0; i < PipelinePredictor::MAX_SUCCESSORS - 1; ++i)
+    expected.push_back(10 + i);
+  EXPECT_EQ(expected, GetPredictions(predictor, 1));
+
+  predictor.AddTransition({1, 20, 9});
+  expected.insert(expected.begin(), 20);
+  EXPECT_EQ(expected, GetPredictions(predictor, 1));
+}
+
+TEST(PipelinePredictor, TransitionsRoundTrip)
+{
+  PipelinePredictor predictor;
+  ObserveAll(&predictor, {1, 2, 3, 1, 2, 3, 1, 3});
+
+  PipelinePredictor loaded;
+  for (const PipelinePredictor::Transition& transition : predictor.GetTransitions())
+    loaded.AddTransition(transition);
+
+  for (u64 pipeline : {1, 2, 3})
+    EXPECT_EQ(GetPredictions(predictor, pipeline), GetPredictions(loaded, pipeline));
+  EXPECT_EQ(std::vector<u64>({2}), GetPredictions(loaded, 1));
+  EXPECT_EQ(std::vector<u64>({3}), GetPredictions(loaded, 2));
+  EXPECT_EQ(std::vector<u64>({1}), GetPredictions(loaded, 3));
+
+  loaded.Clear();
+  EXPECT_TRUE(loaded.GetTransitions().empty());
+  EXPECT_EQ(std::vector<u64>(), GetPredictions(loaded, 1));
+}
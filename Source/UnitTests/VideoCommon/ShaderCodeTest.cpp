@@ -0,0 +1,38 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/StringUtil.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+TEST(ShaderCode, WritesFormattedLines)
+{
+  ShaderCode code;
+  code.Write("void main()\n{\n");
+  code.Write("  float4 c%d = float4(%f, %.1f, %s);\n", 3, 0.5f, 2.0f, "x");
+  code.Write("%s", "");
+  code.Write("  int i = 100%%;\n");
+  code.Write("}\n");
+
+  EXPECT_EQ("void main()\n{\n"
+            "  float4 c3 = float4(0.500000, 2.0, x);\n"
+            "  int i = 100%;\n"
+            "}\n",
+            code.GetBuffer());
+}
+
+TEST(ShaderCode, WritesLinesLongerThanTheLineBuffer)
+{
+  const std::string block(5000, 'a');
+
+  ShaderCode code;
+  code.Write("// begin\n");
+  code.Write("%s%d", block.c_str(), 42);
+  code.Write("\n");
+
+  EXPECT_EQ("// begin\n" + block + "42\n", code.GetBuffer());
+}